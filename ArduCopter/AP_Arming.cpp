@@ -739,11 +739,17 @@ bool AP_Arming_Copter::arm(const AP_Arming::Method method, const bool do_arming_
     copter.sprayer.test_pump(false);
 #endif
 
-    // output lowest possible value to motors
-    copter.motors->output_min();
+    {
+#if AP_COPTER_RATE_THREAD_ENABLED
+        // the rate thread may be outputting to the motors
+        WITH_SEMAPHORE(copter.rate_thread_sem);
+#endif
+        // output lowest possible value to motors
+        copter.motors->output_min();
 
-    // finally actually arm the motors
-    copter.motors->armed(true);
+        // finally actually arm the motors
+        copter.motors->armed(true);
+    }
 
 #if HAL_LOGGING_ENABLED
     // log flight mode in case it was changed while vehicle was disarmed
@@ -812,8 +818,14 @@ bool AP_Arming_Copter::disarm(const AP_Arming::Method method, bool do_disarm_che
     copter.set_land_complete(true);
     copter.set_land_complete_maybe(true);
 
-    // send disarm command to motors
-    copter.motors->armed(false);
+    {
+#if AP_COPTER_RATE_THREAD_ENABLED
+        // the rate thread may be outputting to the motors
+        WITH_SEMAPHORE(copter.rate_thread_sem);
+#endif
+        // send disarm command to motors
+        copter.motors->armed(false);
+    }
 
 #if MODE_AUTO_ENABLED
     // reset the mission
@@ -10,10 +10,28 @@ void Copter::run_rate_controller()
 {
     // set attitude and position controller loop time
     const float last_loop_time_s = AP::scheduler().get_last_loop_time_s();
-    motors->set_dt(last_loop_time_s);
     attitude_control->set_dt(last_loop_time_s);
     pos_control->set_dt(last_loop_time_s);
 
+#if AP_COPTER_RATE_THREAD_ENABLED
+    WITH_SEMAPHORE(rate_thread_sem);
+
+    // hand over to the rate thread, or take back from it, only here
+    // and with the rate thread idle, so the main loop and the rate
+    // thread never both output
+    using_rate_thread = rate_thread_ready;
+    attitude_control->set_rate_targets_published(using_rate_thread);
+    if (using_rate_thread) {
+        // sysid and other temporary inputs set by the flight mode
+        // were published with the targets and apply to all rate
+        // thread updates until the next main loop
+        attitude_control->rate_controller_target_reset();
+        return;
+    }
+#endif
+
+    motors->set_dt(last_loop_time_s);
+
     // run low level rate controllers that only require IMU data
     attitude_control->rate_controller_run();
     // reset sysid and other temporary inputs
@@ -725,6 +725,23 @@ private:
     uint16_t get_pilot_speed_dn() const;
     void run_rate_controller();
 
+#if AP_COPTER_RATE_THREAD_ENABLED
+    // rate_thread.cpp
+    void rate_controller_thread_start();
+    void rate_controller_thread();
+    // held only to hand the rate loop over and to publish or copy
+    // rate_thread_targets, never while running a flight mode or the
+    // rate controllers
+    HAL_Semaphore rate_thread_sem;
+    // rate controller targets set by the last flight mode run
+    AC_AttitudeControl::RateTargets rate_thread_targets;
+    // set by the rate thread while it is receiving gyro samples
+    bool rate_thread_ready;
+    // set by the main loop when it has handed the rate controllers
+    // and motor output over to the rate thread
+    bool using_rate_thread;
+#endif
+
 #if AC_CUSTOMCONTROL_MULTI_ENABLED
     void run_custom_controller() { custom_control.update(); }
 #endif
@@ -887,6 +904,9 @@ private:
     void Log_Write_SysID_Setup(uint8_t systemID_axis, float waveform_magnitude, float frequency_start, float frequency_stop, float time_fade_in, float time_const_freq, float time_record, float time_fade_out);
     void Log_Write_SysID_Data(float waveform_time, float waveform_sample, float waveform_freq, float angle_x, float angle_y, float angle_z, float accel_x, float accel_y, float accel_z);
     void Log_Write_Vehicle_Startup_Messages();
+#if AP_COPTER_RATE_THREAD_ENABLED
+    void Log_Write_Rate_Thread_Dt(float rate_hz, float dt_avg, float dt_min, float dt_max, float dt_std, uint16_t skipped);
+#endif
 #endif  // HAL_LOGGING_ENABLED
 
     // mode.cpp
@@ -917,6 +937,7 @@ private:
     void arm_motors_check();
     void auto_disarm_check();
     void motors_output();
+    void motors_output_main();
     void lost_vehicle_check();
 
     // navigation.cpp
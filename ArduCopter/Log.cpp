@@ -386,6 +386,37 @@ void Copter::Log_Write_Guided_Attitude_Target(ModeGuided::SubMode target_type, f
     logger.WriteBlock(&pkt, sizeof(pkt));
 }
 
+#if AP_COPTER_RATE_THREAD_ENABLED
+// rate controller thread timing
+struct PACKED log_Rate_Thread_Dt {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    float rate_hz;
+    float dt_avg;
+    float dt_min;
+    float dt_max;
+    float dt_std;
+    uint16_t skipped;
+};
+
+// Write rate controller thread timing, called by the rate thread
+// with the statistics since its last call
+void Copter::Log_Write_Rate_Thread_Dt(float rate_hz, float dt_avg, float dt_min, float dt_max, float dt_std, uint16_t skipped)
+{
+    const log_Rate_Thread_Dt pkt {
+        LOG_PACKET_HEADER_INIT(LOG_RATE_THREAD_DT_MSG),
+        time_us         : AP_HAL::micros64(),
+        rate_hz         : rate_hz,
+        dt_avg          : dt_avg,
+        dt_min          : dt_min,
+        dt_max          : dt_max,
+        dt_std          : dt_std,
+        skipped         : skipped
+    };
+    logger.WriteBlock(&pkt, sizeof(pkt));
+}
+#endif
+
 // type and unit information can be found in
 // libraries/AP_Logger/Logstructure.h; search for "log_Units" for
 // units and "Format characters" for field type information
@@ -527,6 +558,21 @@ const struct LogStructure Copter::log_structure[] = {
 
     { LOG_GUIDED_ATTITUDE_TARGET_MSG, sizeof(log_Guided_Attitude_Target),
       "GUIA",  "QBffffffff",    "TimeUS,Type,Roll,Pitch,Yaw,RollRt,PitchRt,YawRt,Thrust,ClimbRt", "s-dddkkk-n", "F-000000-0" , true },
+
+#if AP_COPTER_RATE_THREAD_ENABLED
+// @LoggerMessage: RTDT
+// @Description: Rate controller thread timing
+// @Field: TimeUS: Time since system startup
+// @Field: Rate: Achieved rate controller loop rate
+// @Field: DtAvg: Average time between rate controller updates
+// @Field: DtMin: Minimum time between rate controller updates
+// @Field: DtMax: Maximum time between rate controller updates
+// @Field: DtStd: Standard deviation of the time between rate controller updates
+// @Field: Skip: Number of gyro samples skipped because the rate thread fell behind
+
+    { LOG_RATE_THREAD_DT_MSG, sizeof(log_Rate_Thread_Dt),
+      "RTDT",  "QfffffH",    "TimeUS,Rate,DtAvg,DtMin,DtMax,DtStd,Skip", "szssss-", "F00000-" , true },
+#endif
 };
 
 uint8_t Copter::get_num_log_structures() const
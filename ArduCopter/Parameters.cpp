@@ -1232,6 +1232,24 @@ const AP_Param::GroupInfo ParametersG2::var_info2[] = {
     // @User: Advanced
     AP_GROUPINFO("FS_EKF_FILT", 8, ParametersG2, fs_ekf_filt_hz, FS_EKF_FILT_DEFAULT),
 
+#if AP_COPTER_RATE_THREAD_ENABLED
+    // @Param: FSTRATE_ENABLE
+    // @DisplayName: Enable the rate controller thread
+    // @Description: Runs the rate controllers and motor output in a separate thread on each filtered sample from the primary gyro instead of in the main loop. The rate loop is then no longer limited by SCHED_LOOP_RATE, which can be lowered to leave more time for the EKF and navigation. The rate thread timing is logged in the RTDT message when LOG_BITMASK includes PM.
+    // @Values: 0:Disabled,1:Enabled
+    // @RebootRequired: True
+    // @User: Advanced
+    AP_GROUPINFO("FSTRATE_ENABLE", 9, ParametersG2, fast_rate_enable, 0),
+
+    // @Param: FSTRATE_DIV
+    // @DisplayName: Rate controller thread divisor
+    // @Description: The rate controller thread runs on every FSTRATE_DIV gyro samples, 1 runs the rate controllers at the full gyro rate and 2 at half the gyro rate
+    // @Range: 1 8
+    // @RebootRequired: True
+    // @User: Advanced
+    AP_GROUPINFO("FSTRATE_DIV", 10, ParametersG2, fast_rate_div, 1),
+#endif
+
     // ID 62 is reserved for the AP_SUBGROUPEXTENSION
 
     AP_GROUPEND
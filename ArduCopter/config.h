@@ -30,6 +30,7 @@
 #include <AP_ADSB/AP_ADSB_config.h>
 #include <AP_Follow/AP_Follow_config.h>
 #include <AC_Avoidance/AC_Avoidance_config.h>
+#include <AP_InertialSensor/AP_InertialSensor_config.h>
 
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
@@ -599,6 +600,12 @@
 #define AC_CUSTOMCONTROL_MULTI_ENABLED FRAME_CONFIG == MULTICOPTER_FRAME && AP_CUSTOMCONTROL_ENABLED
 #endif
 
+//////////////////////////////////////////////////////////////////////////////
+// Rate controller thread running on each gyro sample
+#ifndef AP_COPTER_RATE_THREAD_ENABLED
+#define AP_COPTER_RATE_THREAD_ENABLED (FRAME_CONFIG == MULTICOPTER_FRAME && AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED)
+#endif
+
 #ifndef AC_PAYLOAD_PLACE_ENABLED
 #define AC_PAYLOAD_PLACE_ENABLED 1
 #endif
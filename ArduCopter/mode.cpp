@@ -359,7 +359,13 @@ bool Copter::set_mode(Mode::Number mode, ModeReason reason)
     exit_mode(flightmode, new_flightmode);
 
     // update flight mode
-    flightmode = new_flightmode;
+    {
+#if AP_COPTER_RATE_THREAD_ENABLED
+        // the rate thread outputs through the flight mode
+        WITH_SEMAPHORE(rate_thread_sem);
+#endif
+        flightmode = new_flightmode;
+    }
     control_mode_reason = reason;
 #if HAL_LOGGING_ENABLED
     logger.Write_Mode((uint8_t)flightmode->mode_number(), reason);
@@ -428,6 +434,16 @@ void Copter::update_flight_mode()
     attitude_control->landed_gain_reduction(copter.ap.land_complete); // Adjust gains when landed to attenuate ground oscillation
 
     flightmode->run();
+
+#if AP_COPTER_RATE_THREAD_ENABLED
+    if (g2.fast_rate_enable != 0) {
+        // publish the targets the flight mode set to the rate thread
+        AC_AttitudeControl::RateTargets targets;
+        attitude_control->get_rate_targets(targets);
+        WITH_SEMAPHORE(rate_thread_sem);
+        rate_thread_targets = targets;
+    }
+#endif
 }
 
 // exit_mode - high level call to organise cleanup as a flight mode is exited
@@ -132,6 +132,19 @@ void Copter::auto_disarm_check()
     }
 }
 
+// motors_output_main - motors output from the main loop, skipped
+// when the rate thread is running the motors output
+void Copter::motors_output_main()
+{
+#if AP_COPTER_RATE_THREAD_ENABLED
+    WITH_SEMAPHORE(rate_thread_sem);
+    if (using_rate_thread) {
+        return;
+    }
+#endif
+    motors_output();
+}
+
 // motors_output - send output to motors library which will adjust and send to ESCs and servos
 void Copter::motors_output()
 {
@@ -0,0 +1,131 @@
+#include "Copter.h"
+
+#if AP_COPTER_RATE_THREAD_ENABLED
+
+/*************************************************************
+ *  Rate controller thread
+ *
+ *  When FSTRATE_ENABLE is set the rate controllers and motor output
+ *  run here on each filtered sample from the primary gyro instead of
+ *  in the main loop, so the rate loop is neither capped by
+ *  SCHED_LOOP_RATE nor delayed by the EKF and navigation.
+ *
+ *  After each flight mode run the main loop publishes the rate
+ *  targets, throttle and any I term resets in rate_thread_targets,
+ *  and the rate thread copies them before each update. The
+ *  semaphore is held only for the hand over and for those copies,
+ *  so neither side waits for the other to run its controllers
+ ****************************************************************/
+
+// hand the rate loop back to the main loop if there are no gyro
+// samples for this long
+#define RATE_THREAD_TIMEOUT_US 20000
+
+// rate thread timing is logged at this interval
+#define RATE_THREAD_LOG_INTERVAL_US 1000000
+
+void Copter::rate_controller_thread_start()
+{
+    if (g2.fast_rate_enable == 0) {
+        return;
+    }
+    if (!ins.enable_rate_loop_buffer()) {
+        GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "FSTRATE: no memory for gyro buffer");
+        return;
+    }
+    if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&Copter::rate_controller_thread, void),
+                                      "rate",
+                                      2048, AP_HAL::Scheduler::PRIORITY_BOOST, 0)) {
+        GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "FSTRATE: failed to start thread");
+    }
+}
+
+void Copter::rate_controller_thread()
+{
+    const uint8_t div = constrain_int16(g2.fast_rate_div, 1, 8);
+    uint8_t sample_count = 0;
+    uint64_t last_run_us = 0;
+
+    // timing statistics since the last log
+    struct {
+        uint64_t start_us;
+        uint32_t count;
+        uint32_t skipped;
+        float dt_sum;
+        float dt_sq_sum;
+        float dt_min;
+        float dt_max;
+    } stats {};
+
+    while (true) {
+        Vector3f gyro;
+        uint64_t sample_us;
+        uint8_t n_skipped;
+        if (!ins.get_next_rate_loop_gyro_sample(gyro, sample_us, n_skipped, RATE_THREAD_TIMEOUT_US)) {
+            // no gyro data, the main loop takes the rate controllers
+            // back on its next iteration
+            WITH_SEMAPHORE(rate_thread_sem);
+            rate_thread_ready = false;
+            last_run_us = 0;
+            continue;
+        }
+        stats.skipped += n_skipped;
+
+        sample_count += 1 + n_skipped;
+        if (sample_count < div) {
+            continue;
+        }
+        sample_count = 0;
+
+        AC_AttitudeControl::RateTargets targets;
+        {
+            // the main loop only takes the rate loop back once we
+            // have cleared rate_thread_ready above, so the check of
+            // using_rate_thread holds for the whole update
+            WITH_SEMAPHORE(rate_thread_sem);
+            rate_thread_ready = true;
+            if (last_run_us == 0 || !using_rate_thread) {
+                // wait for the main loop to hand over, and for a second
+                // sample to give us a time step
+                last_run_us = sample_us;
+                continue;
+            }
+            targets = rate_thread_targets;
+        }
+        const float dt = (sample_us - last_run_us) * 1.0e-6f;
+        last_run_us = sample_us;
+
+        motors->set_dt(dt);
+        // correct for the gyro drift as AP_AHRS::get_gyro_latest() does
+        attitude_control->rate_controller_run_targets(gyro + ahrs.get_gyro_drift(), dt, targets);
+        motors_output();
+
+#if HAL_LOGGING_ENABLED
+        if (stats.count == 0) {
+            stats.start_us = sample_us;
+            stats.dt_min = dt;
+            stats.dt_max = dt;
+        }
+        stats.count++;
+        stats.dt_sum += dt;
+        stats.dt_sq_sum += sq(dt);
+        stats.dt_min = MIN(stats.dt_min, dt);
+        stats.dt_max = MAX(stats.dt_max, dt);
+
+        const uint64_t elapsed_us = sample_us - stats.start_us;
+        if (elapsed_us >= RATE_THREAD_LOG_INTERVAL_US) {
+            if (should_log(MASK_LOG_PM)) {
+                const float dt_avg = stats.dt_sum / stats.count;
+                const float dt_var = stats.dt_sq_sum / stats.count - sq(dt_avg);
+                Log_Write_Rate_Thread_Dt(stats.count * 1.0e6f / elapsed_us,
+                                         dt_avg, stats.dt_min, stats.dt_max,
+                                         safe_sqrt(dt_var),
+                                         MIN(stats.skipped, UINT16_MAX));
+            }
+            stats = {};
+        }
+#endif
+    }
+}
+
+#endif // AP_COPTER_RATE_THREAD_ENABLED
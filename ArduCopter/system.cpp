@@ -190,6 +190,10 @@ void Copter::init_ardupilot()
 
     ins.set_log_raw_bit(MASK_LOG_IMU_RAW);
 
+#if AP_COPTER_RATE_THREAD_ENABLED
+    rate_controller_thread_start();
+#endif
+
     motors->output_min();  // output lowest possible value to motors
 
     // attempt to set the initial_mode, else set to STABILIZE
@@ -70,6 +70,12 @@ class Board:
             'AP_Scripting/lua/src',
         ]
 
+        if cfg.options.enable_scripting_bytecode:
+            env.DEFINES.update(
+                LUA_SUPPORT_LOAD_BINARY = 1,
+                AP_SCRIPTING_BYTECODE_ENABLED = 1,
+            )
+
         if cfg.options.enable_scripting:
             env.DEFINES.update(
                 AP_SCRIPTING_ENABLED = 1,
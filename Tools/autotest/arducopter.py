@@ -8,6 +8,7 @@ from __future__ import print_function
 import copy
 import math
 import os
+import re
 import shutil
 import tempfile
 import time
@@ -9551,6 +9552,24 @@ class AutoTestCopter(vehicle_test_suite.TestSuite):
         if ex is not None:
             raise ex
 
+    def assert_bus_device_queues_transfers(self, device):
+        '''check @SYS/buses.txt shows device using the bus transfer queue'''
+        # rates are since the last read
+        self.fetch_file_via_ftp("@SYS/buses.txt")
+        self.delay_sim_time(5)
+        content = self.fetch_file_via_ftp("@SYS/buses.txt")
+        self.progress("Got content (%s)" % str(content))
+        for line in content.split("\n"):
+            if not line.startswith(device + " "):
+                continue
+            m = re.search(r" Q:\s*(\d+)/s", line)
+            if m is None:
+                raise NotAchievedException("No queued transfer rate for %s (%s)" % (device, line))
+            if int(m.group(1)) == 0:
+                raise NotAchievedException("%s is not queueing transfers (%s)" % (device, line))
+            return
+        raise NotAchievedException("%s not found in buses.txt" % device)
+
     def BaroDrivers(self):
         '''Test Baro Drivers'''
         sensors = [
@@ -9563,6 +9582,7 @@ class AutoTestCopter(vehicle_test_suite.TestSuite):
             self.set_parameter("BARO_PROBE_EXT", 1 << 2)
             self.reboot_sitl()
             self.wait_ready_to_arm()
+            self.assert_bus_device_queues_transfers("I2C%u 0x77" % bus)
             self.arm_vehicle()
 
             # insert listener to compare airspeeds:
@@ -11259,6 +11279,51 @@ class AutoTestCopter(vehicle_test_suite.TestSuite):
         self.wait_for_local_velocity(vx=0, vy=0, vz_up=0, timeout=10)
         self.land_and_disarm()
 
+    def RateThread(self):
+        '''fly with the rate controllers running in their own thread'''
+        self.set_parameters({
+            "FSTRATE_ENABLE": 1,
+            "FSTRATE_DIV": 1,
+        })
+        self.reboot_sitl()
+
+        # arm and disarm on the ground a few times, the rate thread
+        # owns the motor output while disarmed as well
+        for i in range(3):
+            self.change_mode('STABILIZE')
+            self.wait_ready_to_arm()
+            self.arm_vehicle()
+            self.delay_sim_time(2)
+            self.disarm_vehicle()
+
+        # change mode while flying, each mode resets the attitude
+        # targets the rate thread is running to
+        self.takeoff(10, mode='GUIDED')
+        self.fly_guided_move_local(10, 10, 15)
+        for mode in 'ALT_HOLD', 'LOITER', 'BRAKE', 'POSHOLD', 'GUIDED':
+            self.change_mode(mode)
+            self.delay_sim_time(3)
+            self.wait_altitude(10, 20, relative=True)
+        self.fly_guided_move_local(0, 0, 10)
+        self.land_and_disarm()
+
+        # re-arm after landing and fly again
+        self.takeoff(5, mode='GUIDED')
+        self.do_RTL()
+
+        # the rate thread must have been running the rate loop
+        dfreader = self.dfreader_for_current_onboard_log()
+        count = 0
+        while True:
+            m = dfreader.recv_match(type='RTDT')
+            if m is None:
+                break
+            count += 1
+            if m.Rate < 300:
+                raise NotAchievedException("Rate thread ran at %.1fHz" % m.Rate)
+        if count == 0:
+            raise NotAchievedException("No RTDT messages")
+
     def MISSION_START(self):
         '''test mavlink command MAV_CMD_MISSION_START'''
         self.upload_simple_relhome_mission([
@@ -12330,6 +12395,7 @@ RTL_ALT 111
             self.GPSBlendingAffinity,
             self.DataFlash,
             Test(self.DataFlashErase, attempts=8),
+            self.DataFlashEraseAhead,
             self.Callisto,
             self.PerfInfo,
             self.Replay,
@@ -12374,6 +12440,7 @@ RTL_ALT 111
             self.RPLidarA2,
             self.SafetySwitch,
             self.BrakeZ,
+            self.RateThread,
             self.MAV_CMD_DO_FLIGHTTERMINATION,
             self.MAV_CMD_DO_LAND_START,
             self.MAV_CMD_SET_EKF_SOURCE_SET,
@@ -10506,6 +10506,69 @@ Also, ignores heartbeats not from our target system'''
         if ex is not None:
             raise ex
 
+    def DataFlashEraseAhead(self):
+        """Test that block erases ahead of the write point drop no data"""
+        mavproxy = self.start_mavproxy()
+
+        ex = None
+        self.context_push()
+        try:
+            # SIM_JEDEC stays busy for a typical block erase time
+            self.set_parameters({
+                "LOG_BACKEND_TYPE": 4,
+                "LOG_BITMASK": 131071,
+            })
+            self.reboot_sitl()
+            mavproxy.send("module load log\n")
+            mavproxy.send("log erase\n")
+            mavproxy.expect("Chip erase complete")
+
+            # roughly 3mb, well short of wrapping
+            self.wait_ready_to_arm()
+            if self.is_copter() or self.is_plane():
+                self.set_autodisarm_delay(0)
+            self.arm_vehicle()
+            self.delay_sim_time(20)
+            self.disarm_vehicle()
+            # make sure we have finished logging
+            self.delay_sim_time(5)
+
+            logname = "logs/dataflash-log-erase-ahead.BIN"
+            mavproxy.send("log download latest %s\n" % logname)
+            mavproxy.expect("Finished downloading", timeout=120)
+            self.validate_log_file(logname)
+
+            dfreader = DFReader.DFReader_binary(logname)
+            erases = 0
+            while True:
+                m = dfreader.recv_match(type='DBS')
+                if m is None:
+                    break
+                if m.DpE != 0:
+                    raise NotAchievedException("%u writes dropped during block erases" % m.DpE)
+                erases = max(erases, m.Er)
+            if erases == 0:
+                raise NotAchievedException("No block erases logged")
+            self.progress("%u block erases without drops" % erases)
+
+            # clean up
+            mavproxy.send("log erase\n")
+            mavproxy.expect("Chip erase complete")
+
+        except Exception as e:
+            self.print_exception_caught(e)
+            ex = e
+
+        mavproxy.send("module unload log\n")
+
+        self.context_pop()
+        self.reboot_sitl()
+
+        self.stop_mavproxy(mavproxy)
+
+        if ex is not None:
+            raise ex
+
     def ArmFeatures(self):
         '''Arm features'''
         # TEST ARMING/DISARM
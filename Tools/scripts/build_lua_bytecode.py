@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+'''
+Compile Lua scripts to stripped bytecode for AP_Scripting
+
+Builds a host luac from libraries/AP_Scripting/lua/src matching the
+number format used on the flight controller, compiles each script in
+the input directory (by default the applets directory) and writes a
+.luac file for each with a header holding the length and CRC32 of the
+bytecode. The firmware must be built with --enable-scripting-bytecode
+to load these files.
+
+The bytecode embeds sizeof(size_t) of the target, use --size-t 4 for
+32 bit flight controllers (requires a multilib gcc) and --size-t 8 for
+64 bit SITL and Linux boards.
+
+AP_FLAKE8_CLEAN
+'''
+
+import argparse
+import os
+import struct
+import subprocess
+import sys
+import tempfile
+import zlib
+
+# must match bytecode_header in libraries/AP_Scripting/lua_scripts.cpp
+HEADER_MAGIC = b'APLB'
+HEADER_VERSION = 1
+
+LUA_SOURCES = [
+    'lapi.c', 'lcode.c', 'lctype.c', 'ldebug.c', 'ldo.c', 'ldump.c',
+    'lfunc.c', 'lgc.c', 'llex.c', 'lmem.c', 'lobject.c', 'lopcodes.c',
+    'lparser.c', 'lstate.c', 'lstring.c', 'ltable.c', 'ltm.c',
+    'lundump.c', 'lvm.c', 'lzio.c', 'lauxlib.c', 'luac.c',
+]
+
+# luac does not need the ArduPilot filesystem or sandbox, these stand
+# in for the headers and functions the Lua core expects from ArduPilot
+STUB_COMMON_DEFS = '''
+#pragma once
+#define SCRIPTING_DIRECTORY "./scripts"
+void lua_abort(void) __attribute__((noreturn));
+'''
+
+STUB_SOURCE = '''
+#include <stdlib.h>
+#include "lua.h"
+static void *l_alloc(void *ud, void *ptr, size_t osize, size_t nsize) {
+    (void)ud; (void)osize;
+    if (nsize == 0) {
+        free(ptr);
+        return NULL;
+    }
+    return realloc(ptr, nsize);
+}
+lua_State *luaL_newstate(void) { return lua_newstate(l_alloc, NULL); }
+void lua_abort(void) { abort(); }
+'''
+
+
+def crc_crc32(buf):
+    '''CRC32 matching crc_crc32(0, buf, len) in AP_Math'''
+    return (~zlib.crc32(buf, 0xffffffff)) & 0xffffffff
+
+
+def build_luac(lua_src, build_dir, size_t, cc):
+    '''build a host luac producing bytecode for the target'''
+    os.makedirs(os.path.join(build_dir, 'AP_Filesystem'), exist_ok=True)
+    os.makedirs(os.path.join(build_dir, 'AP_Scripting'), exist_ok=True)
+    with open(os.path.join(build_dir, 'AP_Filesystem', 'posix_compat.h'), 'w') as f:
+        f.write('#pragma once\n')
+    with open(os.path.join(build_dir, 'AP_Scripting', 'lua_common_defs.h'), 'w') as f:
+        f.write(STUB_COMMON_DEFS)
+    stub = os.path.join(build_dir, 'stub.c')
+    with open(stub, 'w') as f:
+        f.write(STUB_SOURCE)
+
+    luac = os.path.join(build_dir, 'luac')
+    cmd = [cc, '-std=gnu99', '-O2', '-w',
+           '-DLUA_32BITS=1', '-DLUA_SUPPORT_LOAD_BINARY=1',
+           '-I', lua_src, '-I', build_dir,
+           '-o', luac]
+    if size_t == 4:
+        cmd.append('-m32')
+    cmd += [os.path.join(lua_src, s) for s in LUA_SOURCES]
+    cmd += [stub, '-lm']
+    subprocess.check_call(cmd)
+    return luac
+
+
+def compile_script(luac, src, dst):
+    '''compile one script and wrap the stripped bytecode with our header'''
+    with tempfile.NamedTemporaryFile(suffix='.out', delete=False) as tmp:
+        tmp_name = tmp.name
+    try:
+        subprocess.check_call([luac, '-s', '-o', tmp_name, src])
+        with open(tmp_name, 'rb') as f:
+            bytecode = f.read()
+    finally:
+        os.unlink(tmp_name)
+
+    header = struct.pack('<4sB3xII', HEADER_MAGIC, HEADER_VERSION, len(bytecode), crc_crc32(bytecode))
+    with open(dst, 'wb') as f:
+        f.write(header + bytecode)
+    return os.path.getsize(src), len(header) + len(bytecode)
+
+
+def main():
+    root = os.path.realpath(os.path.join(os.path.dirname(__file__), '..', '..'))
+    parser = argparse.ArgumentParser(description='compile Lua scripts to bytecode for AP_Scripting')
+    parser.add_argument('--input', default=os.path.join(root, 'libraries', 'AP_Scripting', 'applets'),
+                        help='directory of .lua scripts to compile')
+    parser.add_argument('--output', required=True, help='directory to write .luac files to')
+    parser.add_argument('--size-t', type=int, choices=[4, 8], default=4,
+                        help='sizeof(size_t) on the target, 4 for flight controllers, 8 for 64 bit SITL/Linux')
+    parser.add_argument('--cc', default='gcc', help='host C compiler')
+    args = parser.parse_args()
+
+    lua_src = os.path.join(root, 'libraries', 'AP_Scripting', 'lua', 'src')
+    os.makedirs(args.output, exist_ok=True)
+
+    with tempfile.TemporaryDirectory() as build_dir:
+        luac = build_luac(lua_src, build_dir, args.size_t, args.cc)
+
+        scripts = sorted(f for f in os.listdir(args.input) if f.endswith('.lua'))
+        if len(scripts) == 0:
+            print("No scripts found in %s" % args.input)
+            sys.exit(1)
+        for name in scripts:
+            src = os.path.join(args.input, name)
+            dst = os.path.join(args.output, name + 'c')
+            src_size, dst_size = compile_script(luac, src, dst)
+            print("%-40s %7u -> %7u bytes" % (name, src_size, dst_size))
+
+
+if __name__ == '__main__':
+    main()
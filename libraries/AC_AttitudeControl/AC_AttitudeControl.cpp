@@ -243,6 +243,10 @@ void AC_AttitudeControl::relax_attitude_controllers()
 
 void AC_AttitudeControl::reset_rate_controller_I_terms()
 {
+    if (_rate_targets_published) {
+        _rate_targets.reset_I_count++;
+        return;
+    }
     get_rate_roll_pid().reset_I();
     get_rate_pitch_pid().reset_I();
     get_rate_yaw_pid().reset_I();
@@ -251,11 +255,25 @@ void AC_AttitudeControl::reset_rate_controller_I_terms()
 // reset rate controller I terms smoothly to zero in 0.5 seconds
 void AC_AttitudeControl::reset_rate_controller_I_terms_smoothly()
 {
+    if (_rate_targets_published) {
+        _rate_targets.relax_I = true;
+        return;
+    }
     get_rate_roll_pid().relax_integrator(0.0, _dt, AC_ATTITUDE_RATE_RELAX_TC);
     get_rate_pitch_pid().relax_integrator(0.0, _dt, AC_ATTITUDE_RATE_RELAX_TC);
     get_rate_yaw_pid().relax_integrator(0.0, _dt, AC_ATTITUDE_RATE_RELAX_TC);
 }
 
+// get the rate controller inputs set since the last call
+void AC_AttitudeControl::get_rate_targets(RateTargets &targets)
+{
+    _rate_targets.ang_vel_body = _ang_vel_body + _sysid_ang_vel_body;
+    _rate_targets.actuator_sysid = _actuator_sysid;
+    _rate_targets.pd_scale = _pd_scale;
+    targets = _rate_targets;
+    _rate_targets.relax_I = false;
+}
+
 // Reduce attitude control gains while landed to stop ground resonance
 void AC_AttitudeControl::landed_gain_reduction(bool landed)
 {
@@ -252,6 +252,30 @@ public:
     // optional variant to allow running with different dt
     virtual void rate_controller_run_dt(const Vector3f& gyro, float dt) { AP_BoardConfig::config_error("rate_controller_run_dt() must be defined"); };
 
+    // rate controller inputs, published by the main loop to a rate
+    // controller running on its own thread
+    struct RateTargets {
+        Vector3f ang_vel_body;          // angular velocity target including sysid in rad/s
+        Vector3f actuator_sysid;        // system identification actuator
+        Vector3f pd_scale;              // PD scaling for roll, pitch, yaw
+        float throttle;                 // throttle including angle boost
+        float throttle_avg_max;         // maximum average throttle
+        float throttle_filter_cutoff;   // throttle filter cutoff in Hz
+        uint32_t reset_I_count;         // incremented on each I term reset
+        bool relax_I;                   // relax I terms towards zero
+    };
+
+    // when set the rate controller runs on another thread from the
+    // targets returned by get_rate_targets(), so I term resets and
+    // throttle are deferred to it rather than applied here
+    void set_rate_targets_published(bool published) { _rate_targets_published = published; }
+
+    // get the rate controller inputs set since the last call
+    virtual void get_rate_targets(RateTargets &targets);
+
+    // run the rate controller from published targets and send outputs to the motors
+    virtual void rate_controller_run_targets(const Vector3f& gyro, float dt, const RateTargets &targets) { AP_BoardConfig::config_error("rate_controller_run_targets() must be defined"); };
+
     // Convert a 321-intrinsic euler angle derivative to an angular velocity vector
     void euler_rate_to_ang_vel(const Quaternion& att, const Vector3f& euler_rate_rads, Vector3f& ang_vel_rads);
 
@@ -609,6 +633,12 @@ protected:
     // PD scale used for last loop, used for logging
     Vector3f            _pd_scale_used;
 
+    // rate controller inputs waiting to be published to the rate thread
+    RateTargets         _rate_targets {};
+
+    // true when the rate controller runs from published targets
+    bool                _rate_targets_published;
+
     // ratio of normal gain to landed gain
     float               _landed_gain_ratio;
 
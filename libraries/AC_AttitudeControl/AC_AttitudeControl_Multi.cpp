@@ -351,7 +351,6 @@ void AC_AttitudeControl_Multi::set_throttle_out(float throttle_in, bool apply_an
 {
     _throttle_in = throttle_in;
     update_althold_lean_angle_max(throttle_in);
-    _motors.set_throttle_filter_cutoff(filter_cutoff);
     if (apply_angle_boost) {
         // Apply angle boost
         throttle_in = get_throttle_boosted(throttle_in);
@@ -359,8 +358,16 @@ void AC_AttitudeControl_Multi::set_throttle_out(float throttle_in, bool apply_an
         // Clear angle_boost for logging purposes
         _angle_boost = 0.0f;
     }
-    _motors.set_throttle(throttle_in);
-    _motors.set_throttle_avg_max(get_throttle_avg_max(MAX(throttle_in, _throttle_in)));
+    _rate_targets.throttle = throttle_in;
+    _rate_targets.throttle_avg_max = get_throttle_avg_max(MAX(throttle_in, _throttle_in));
+    _rate_targets.throttle_filter_cutoff = filter_cutoff;
+    if (_rate_targets_published) {
+        // the rate thread sets the motors throttle
+        return;
+    }
+    _motors.set_throttle_filter_cutoff(filter_cutoff);
+    _motors.set_throttle(_rate_targets.throttle);
+    _motors.set_throttle_avg_max(_rate_targets.throttle_avg_max);
 }
 
 void AC_AttitudeControl_Multi::set_throttle_mix_max(float ratio)
@@ -452,19 +459,58 @@ void AC_AttitudeControl_Multi::rate_controller_run_dt(const Vector3f& gyro, floa
 
     ang_vel_body += _sysid_ang_vel_body;
 
+    rate_controller_update(gyro, dt, ang_vel_body, _pd_scale, _actuator_sysid);
+}
+
+// get the rate controller inputs set since the last call
+void AC_AttitudeControl_Multi::get_rate_targets(RateTargets &targets)
+{
+    if (_rate_targets_published) {
+        // the rate thread does not touch the attitude gains or mix
+        update_throttle_gain_boost();
+        update_throttle_rpy_mix();
+    }
+    AC_AttitudeControl::get_rate_targets(targets);
+}
+
+// run the rate controller from targets published by the main loop
+void AC_AttitudeControl_Multi::rate_controller_run_targets(const Vector3f& gyro, float dt, const RateTargets &targets)
+{
+    if (targets.reset_I_count != _reset_I_count_applied) {
+        _reset_I_count_applied = targets.reset_I_count;
+        get_rate_roll_pid().reset_I();
+        get_rate_pitch_pid().reset_I();
+        get_rate_yaw_pid().reset_I();
+    }
+    if (targets.relax_I) {
+        get_rate_roll_pid().relax_integrator(0.0, dt, AC_ATTITUDE_RATE_RELAX_TC);
+        get_rate_pitch_pid().relax_integrator(0.0, dt, AC_ATTITUDE_RATE_RELAX_TC);
+        get_rate_yaw_pid().relax_integrator(0.0, dt, AC_ATTITUDE_RATE_RELAX_TC);
+    }
+
+    _motors.set_throttle_filter_cutoff(targets.throttle_filter_cutoff);
+    _motors.set_throttle(targets.throttle);
+    _motors.set_throttle_avg_max(targets.throttle_avg_max);
+
+    rate_controller_update(gyro, dt, targets.ang_vel_body, targets.pd_scale, targets.actuator_sysid);
+}
+
+// update the rate PIDs and send outputs to the motors
+void AC_AttitudeControl_Multi::rate_controller_update(const Vector3f& gyro, float dt, const Vector3f& ang_vel_body, const Vector3f& pd_scale, const Vector3f& actuator_sysid)
+{
     _rate_gyro = gyro;
     _rate_gyro_time_us = AP_HAL::micros64();
 
-    _motors.set_roll(get_rate_roll_pid().update_all(ang_vel_body.x, gyro.x,  dt, _motors.limit.roll, _pd_scale.x) + _actuator_sysid.x);
+    _motors.set_roll(get_rate_roll_pid().update_all(ang_vel_body.x, gyro.x,  dt, _motors.limit.roll, pd_scale.x) + actuator_sysid.x);
     _motors.set_roll_ff(get_rate_roll_pid().get_ff());
 
-    _motors.set_pitch(get_rate_pitch_pid().update_all(ang_vel_body.y, gyro.y,  dt, _motors.limit.pitch, _pd_scale.y) + _actuator_sysid.y);
+    _motors.set_pitch(get_rate_pitch_pid().update_all(ang_vel_body.y, gyro.y,  dt, _motors.limit.pitch, pd_scale.y) + actuator_sysid.y);
     _motors.set_pitch_ff(get_rate_pitch_pid().get_ff());
 
-    _motors.set_yaw(get_rate_yaw_pid().update_all(ang_vel_body.z, gyro.z,  dt, _motors.limit.yaw, _pd_scale.z) + _actuator_sysid.z);
+    _motors.set_yaw(get_rate_yaw_pid().update_all(ang_vel_body.z, gyro.z,  dt, _motors.limit.yaw, pd_scale.z) + actuator_sysid.z);
     _motors.set_yaw_ff(get_rate_yaw_pid().get_ff()*_feedforward_scalar);
 
-    _pd_scale_used = _pd_scale;
+    _pd_scale_used = pd_scale;
 
     control_monitor_update();
 }
@@ -77,6 +77,8 @@ public:
 
     // run lowest level body-frame rate controller and send outputs to the motors
     void rate_controller_run_dt(const Vector3f& gyro, float dt) override;
+    void get_rate_targets(RateTargets &targets) override;
+    void rate_controller_run_targets(const Vector3f& gyro, float dt, const RateTargets &targets) override;
     void rate_controller_target_reset() override;
     void rate_controller_run() override;
 
@@ -100,6 +102,12 @@ protected:
     // get maximum value throttle can be raised to based on throttle vs attitude prioritisation
     float get_throttle_avg_max(float throttle_in);
 
+    // update the rate PIDs and send outputs to the motors
+    void rate_controller_update(const Vector3f& gyro, float dt, const Vector3f& ang_vel_body, const Vector3f& pd_scale, const Vector3f& actuator_sysid);
+
+    // I term resets from published targets applied so far
+    uint32_t _reset_I_count_applied;
+
     AP_MotorsMulticopter& _motors_multi;
     AC_PID                _pid_rate_roll {
         AC_PID::Defaults{
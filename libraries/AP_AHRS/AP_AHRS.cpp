@@ -363,6 +363,58 @@ void AP_AHRS::update_state(void)
     state.velocity_NED_ok = _get_velocity_NED(state.velocity_NED);
 }
 
+/*
+  publish a snapshot of the main outputs for lock-free readers. This
+  is only called from update() so there is a single writer
+ */
+void AP_AHRS::publish_snapshot(void)
+{
+    const uint32_t seq = _snapshot_seq.load(std::memory_order_relaxed) + 1;
+
+    // readers are currently pointed at the other buffer. The fence
+    // keeps the stores below from becoming visible before the
+    // previous sequence number which moved readers off this buffer
+    std::atomic_thread_fence(std::memory_order_release);
+
+    Snapshot &snap = _snapshot[seq & 1];
+    snap.time_us = AP_HAL::micros64();
+    snap.seq = seq;
+    snap.quat = state.quat;
+    snap.quat_ok = state.quat_ok;
+    snap.roll = roll;
+    snap.pitch = pitch;
+    snap.yaw = yaw;
+    snap.gyro = state.gyro_estimate;
+    snap.velocity_NED = state.velocity_NED;
+    snap.velocity_NED_ok = state.velocity_NED_ok;
+    snap.ground_speed_vec = state.ground_speed_vec;
+    snap.location = state.location;
+    snap.location_ok = state.location_ok;
+    snap.relpos_NED_home_ok = get_relative_position_NED_home(snap.relpos_NED_home);
+
+    _snapshot_seq.store(seq, std::memory_order_release);
+}
+
+/*
+  copy out the latest snapshot without taking the AHRS semaphore. If
+  the update thread starts refilling the buffer while we are copying
+  it we go around again, which needs a full update() period to happen
+ */
+bool AP_AHRS::get_snapshot(Snapshot &snap) const
+{
+    while (true) {
+        const uint32_t seq = _snapshot_seq.load(std::memory_order_acquire);
+        if (seq == 0) {
+            return false;
+        }
+        snap = _snapshot[seq & 1];
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (_snapshot_seq.load(std::memory_order_relaxed) == seq) {
+            return true;
+        }
+    }
+}
+
 void AP_AHRS::update(bool skip_ins_update)
 {
     // periodically checks to see if we should update the AHRS
@@ -483,6 +535,7 @@ void AP_AHRS::update(bool skip_ins_update)
 
     // update published state
     update_state();
+    publish_snapshot();
 
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
     /*
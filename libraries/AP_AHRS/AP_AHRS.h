@@ -24,6 +24,7 @@
 #include "AP_AHRS_config.h"
 
 #include <AP_HAL/Semaphores.h>
+#include <atomic>
 
 #include "AP_AHRS_Backend.h"
 #include <AP_NavEKF2/AP_NavEKF2.h>
@@ -76,6 +77,32 @@ public:
         return _rsem;
     }
 
+    /*
+      consistent copy of the main AHRS outputs, published at the end
+      of each update(). Threads which only need these values should
+      use get_snapshot() rather than taking the semaphore, so they
+      never block and never stall the AHRS update
+     */
+    struct Snapshot {
+        uint64_t time_us{};        // time of the update() which produced this snapshot
+        uint32_t seq{};            // incremented on each update()
+        Quaternion quat;           // body to NED attitude
+        float roll{}, pitch{}, yaw{};  // euler angles, radians
+        Vector3f gyro;             // drift corrected gyro, rad/s
+        Vector3f velocity_NED;     // m/s
+        Vector2f ground_speed_vec; // m/s
+        Location location;
+        Vector3f relpos_NED_home;  // position relative to home, m
+        bool quat_ok{};
+        bool velocity_NED_ok{};
+        bool location_ok{};
+        bool relpos_NED_home_ok{};
+    };
+
+    // fill snap with the most recently published snapshot. Returns
+    // false, leaving snap unchanged, if no snapshot has been published yet
+    bool get_snapshot(Snapshot &snap) const;
+
     // return the smoothed gyro vector corrected for drift
     const Vector3f &get_gyro(void) const { return state.gyro_estimate; }
 
@@ -704,6 +731,13 @@ private:
     // multi-thread access support
     HAL_Semaphore _rsem;
 
+    // double buffered snapshot. The update thread is the only writer
+    // and always fills the buffer readers are not being pointed at,
+    // _snapshot_seq is incremented once the buffer is complete
+    Snapshot _snapshot[2];
+    std::atomic<uint32_t> _snapshot_seq{0};
+    void publish_snapshot(void);
+
     /*
      * Parameters
      */
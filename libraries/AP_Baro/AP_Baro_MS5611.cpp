@@ -169,6 +169,12 @@ bool AP_Baro_MS56XX::_init()
 
     // lower retries for run
     _dev->set_retries(3);
+
+    _adc_xfer.send = &CMD_MS56XX_READ_ADC;
+    _adc_xfer.send_len = 1;
+    _adc_xfer.recv = _adc_buf;
+    _adc_xfer.recv_len = sizeof(_adc_buf);
+    _adc_xfer.cb = FUNCTOR_BIND_MEMBER(&AP_Baro_MS56XX::_adc_read_done, void, bool);
     
     _dev->get_semaphore()->give();
 
@@ -188,15 +194,6 @@ uint16_t AP_Baro_MS56XX::_read_prom_word(uint8_t word)
     return (val[0] << 8) | val[1];
 }
 
-uint32_t AP_Baro_MS56XX::_read_adc()
-{
-    uint8_t val[3];
-    if (!_dev->transfer(&CMD_MS56XX_READ_ADC, 1, val, sizeof(val))) {
-        return 0;
-    }
-    return (val[0] << 16) | (val[1] << 8) | val[2];
-}
-
 bool AP_Baro_MS56XX::_read_prom_5611(uint16_t prom[8])
 {
     /*
@@ -260,6 +257,14 @@ bool AP_Baro_MS56XX::_read_prom_5637(uint16_t prom[8])
     return crc_read == crc_crc4(prom);
 }
 
+/*
+ * Queue a read of the last conversion, which is handled by _adc_read_done()
+ */
+void AP_Baro_MS56XX::_timer(void)
+{
+    _dev->queue_transfer(_adc_xfer);
+}
+
 /*
  * Read the sensor with a state machine
  * We read one time temperature (state=0) and then 4 times pressure (states 1-4)
@@ -267,12 +272,14 @@ bool AP_Baro_MS56XX::_read_prom_5637(uint16_t prom[8])
  * Temperature is used to calculate the compensated pressure and doesn't vary
  * as fast as pressure. Hence we reuse the same temperature for 4 samples of
  * pressure.
+ *
+ * Called from the bus thread with the semaphore held once the ADC has been read
 */
-void AP_Baro_MS56XX::_timer(void)
+void AP_Baro_MS56XX::_adc_read_done(bool ok)
 {
     uint8_t next_cmd;
     uint8_t next_state;
-    uint32_t adc_val = _read_adc();
+    const uint32_t adc_val = ok ? (_adc_buf[0] << 16) | (_adc_buf[1] << 8) | _adc_buf[2] : 0;
 
     /*
      * If read fails, re-initiate a read command for current state or we are
@@ -77,12 +77,17 @@ private:
     bool _read_prom_5637(uint16_t prom[8]);
 
     uint16_t _read_prom_word(uint8_t word);
-    uint32_t _read_adc();
 
     void _timer();
+    void _adc_read_done(bool ok);
 
     AP_HAL::OwnPtr<AP_HAL::Device> _dev;
 
+    // ADC read queued on the bus so it can be batched with the other
+    // devices sharing it
+    AP_HAL::Device::QueuedTransfer _adc_xfer;
+    uint8_t _adc_buf[3];
+
     /* Shared values between thread sampling the HW and main thread */
     struct {
         uint32_t s_D1;
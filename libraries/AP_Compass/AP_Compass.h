@@ -7,6 +7,7 @@
 #include <AP_Common/AP_Common.h>
 #include <AP_Declination/AP_Declination.h>
 #include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/utility/RingBuffer.h>
 #include <AP_Math/AP_Math.h>
 #include <AP_Param/AP_Param.h>
 #include <GCS_MAVLink/GCS_MAVLink.h>
@@ -582,9 +583,30 @@ private:
         // board specific orientation
         enum Rotation rotation;
 
-        // accumulated samples, protected by _sem, used by AP_Compass_Backend
-        Vector3f accum;
-        uint32_t accum_count;
+        // sums of rotated samples queued by the backend thread for
+        // drain_accumulated_samples(). The backend thread is the only
+        // producer and the main thread the only consumer, so no lock
+        // is needed. Each entry is one sample unless the buffer was
+        // full when it arrived
+        struct sample_sum {
+            Vector3f sum;
+            uint32_t count;
+        };
+        ObjectBuffer<sample_sum> *samples;
+        uint32_t max_samples;
+
+        // samples waiting for space in the buffer, only used by the
+        // backend thread
+        sample_sum pending_samples;
+
+        // fused sensor to body rotation, only used by the backend thread
+        struct {
+            Matrix3f m;
+            enum Rotation rotation;
+            enum Rotation post_rotation;
+            bool valid;
+        } sensor_to_body;
+
         // We only copy persistent params
         void copy_from(const mag_state& state);
     };
@@ -13,19 +13,44 @@
 
 extern const AP_HAL::HAL& hal;
 
+// entries queued per instance between reads, enough for the largest
+// max_samples any driver passes to accumulate_sample(). Samples that
+// arrive while it is full are summed into one entry
+#define COMPASS_SAMPLE_BUFFER_SIZE 20
+
 AP_Compass_Backend::AP_Compass_Backend()
     : _compass(AP::compass())
 {
 }
 
-void AP_Compass_Backend::rotate_field(Vector3f &mag, uint8_t instance)
+/*
+  return the matrix taking a sample from the sensor frame to the body
+  frame, combining the board mag orientation, the driver rotation and
+  the board or external orientation. The matrix is only rebuilt when
+  one of them changes
+ */
+const Matrix3f &AP_Compass_Backend::sensor_to_body(uint8_t instance, enum Rotation post_rotation)
 {
     Compass::mag_state &state = _compass._state[Compass::StateIndex(instance)];
-    if (MAG_BOARD_ORIENTATION != ROTATION_NONE) {
-        mag.rotate(MAG_BOARD_ORIENTATION);
+    auto &cache = state.sensor_to_body;
+    if (!cache.valid ||
+        cache.rotation != state.rotation ||
+        cache.post_rotation != post_rotation) {
+        Matrix3f board_m, sensor_m, post_m;
+        board_m.from_rotation(MAG_BOARD_ORIENTATION);
+        sensor_m.from_rotation(state.rotation);
+        post_m.from_rotation(post_rotation);
+        cache.m = post_m * (sensor_m * board_m);
+        cache.rotation = state.rotation;
+        cache.post_rotation = post_rotation;
+        cache.valid = true;
     }
-    mag.rotate(state.rotation);
+    return cache.m;
+}
 
+void AP_Compass_Backend::rotate_field(Vector3f &mag, uint8_t instance)
+{
+    Vector3f heater_ofs;
 #ifdef HAL_HEATER_MAG_OFFSET
     /*
       apply compass compensations for boards that have a heater which
@@ -43,18 +68,46 @@ void AP_Compass_Backend::rotate_field(Vector3f &mag, uint8_t instance)
         if (bc) {
             for (const auto &o : offsets) {
                 if (o.dev_id == dev_id) {
-                    mag += o.ofs * bc->get_heater_duty_cycle() * 0.01;
+                    heater_ofs += o.ofs * bc->get_heater_duty_cycle() * 0.01;
                 }
             }
         }
     }
 #endif
+    rotate_field(mag, instance, heater_ofs);
+}
+
+/*
+  rotate a sample from the sensor frame to the body frame, adding ofs
+  after the driver rotation and before the board or external
+  orientation
+ */
+void AP_Compass_Backend::rotate_field(Vector3f &mag, uint8_t instance, const Vector3f &ofs)
+{
+    Compass::mag_state &state = _compass._state[Compass::StateIndex(instance)];
+
+    // internal compasses follow the board orientation, external
+    // compasses have a user selectable orientation
+    const enum Rotation post_rotation = state.external ? (enum Rotation)state.orientation.get() : _compass._board_orientation;
 
-    if (!state.external) {
-        mag.rotate(_compass._board_orientation);
-    } else {
-        // add user selectable orientation
-        mag.rotate((enum Rotation)state.orientation.get());
+    if (state.rotation >= ROTATION_MAX || post_rotation >= ROTATION_MAX) {
+        // custom rotations can be changed at any time so are never fused
+        if (MAG_BOARD_ORIENTATION != ROTATION_NONE) {
+            mag.rotate(MAG_BOARD_ORIENTATION);
+        }
+        mag.rotate(state.rotation);
+        mag += ofs;
+        mag.rotate(post_rotation);
+        return;
+    }
+
+    mag = sensor_to_body(instance, post_rotation) * mag;
+    if (!ofs.is_zero()) {
+        // the sample has already been through the fused rotation, so
+        // the offset is rotated by the board or external orientation
+        Vector3f body_ofs = ofs;
+        body_ofs.rotate(post_rotation);
+        mag += body_ofs;
     }
 }
 
@@ -73,7 +126,12 @@ void AP_Compass_Backend::publish_raw_field(const Vector3f &mag, uint8_t instance
 #endif
 }
 
-void AP_Compass_Backend::correct_field(Vector3f &mag, uint8_t i)
+/*
+  get the hard iron, soft iron and motor corrections for an instance
+  as a single matrix and offset, so that corrected = m * mag + ofs.
+  This also updates the motor offset of the instance
+ */
+void AP_Compass_Backend::get_field_correction(uint8_t i, Matrix3f &m, Vector3f &ofs)
 {
     Compass::mag_state &state = _compass._state[Compass::StateIndex(i)];
 
@@ -83,13 +141,12 @@ void AP_Compass_Backend::correct_field(Vector3f &mag, uint8_t i)
     const Vector3f &offdiagonals = state.offdiagonals.get();
 #endif
 
-    // add in the basic offsets
-    mag += offsets;
+    m.identity();
 
     // add in scale factor, use a wide sanity check. The calibrator
     // uses a narrower check.
     if (_compass.have_scale_factor(i)) {
-        mag *= state.scale_factor;
+        m *= state.scale_factor.get();
     }
 
 #if AP_COMPASS_DIAGONALS_ENABLED
@@ -101,10 +158,14 @@ void AP_Compass_Backend::correct_field(Vector3f &mag, uint8_t i)
             offdiagonals.y, offdiagonals.z, diagonals.z
             );
 
-        mag = mat * mag;
+        m = mat * m;
     }
 #endif
 
+    // the basic offsets are added before the scale factor and
+    // elliptical correction
+    ofs = m * offsets;
+
 #if COMPASS_MOT_ENABLED
     const Vector3f &mot = state.motor_compensation.get();
     /*
@@ -132,10 +193,22 @@ void AP_Compass_Backend::correct_field(Vector3f &mag, uint8_t i)
       compensation values are calculated, as they are calculated based
       on final field outputs, not on the raw outputs
     */
-    mag += state.motor_offset;
+    ofs += state.motor_offset;
 #endif // COMPASS_MOT_ENABLED
 }
 
+void AP_Compass_Backend::correct_field(Vector3f &mag, uint8_t i)
+{
+    Matrix3f m;
+    Vector3f ofs;
+    get_field_correction(i, m, ofs);
+    mag = m * mag + ofs;
+}
+
+/*
+  rotate a sample and queue it for drain_accumulated_samples(), called
+  from the backend thread
+ */
 void AP_Compass_Backend::accumulate_sample(Vector3f &field, uint8_t instance,
                                            uint32_t max_samples)
 {
@@ -145,44 +218,84 @@ void AP_Compass_Backend::accumulate_sample(Vector3f &field, uint8_t instance,
     /* publish raw_field (uncorrected point sample) for calibration use */
     publish_raw_field(field, instance);
 
-    /* correct raw_field for known errors */
-    correct_field(field, instance);
-
-    if (!field_ok(field)) {
+    Compass::mag_state &state = _compass._state[Compass::StateIndex(instance)];
+    if (state.samples == nullptr) {
         return;
     }
+    state.max_samples = max_samples;
 
-    WITH_SEMAPHORE(_sem);
-
-    Compass::mag_state &state = _compass._state[Compass::StateIndex(instance)];
-    state.accum += field;
-    state.accum_count++;
-    if (max_samples && state.accum_count >= max_samples) {
-        state.accum_count /= 2;
-        state.accum /= 2;
+    /*
+      samples that arrive while the buffer is full are summed until
+      there is space for them, so the newest sample is never dropped.
+      The sum is halved when it reaches max_samples so it follows the
+      newest samples like the old accumulator
+     */
+    Compass::mag_state::sample_sum &pending = state.pending_samples;
+    pending.sum += field;
+    pending.count++;
+    if (state.samples->push(pending)) {
+        pending.sum.zero();
+        pending.count = 0;
+    } else if (max_samples && pending.count >= max_samples) {
+        pending.sum /= 2;
+        pending.count /= 2;
     }
 }
 
+/*
+  correct and average the queued samples of an instance in one pass
+  and publish the result. The correction and motor compensation are
+  worked out once for all samples
+ */
 void AP_Compass_Backend::drain_accumulated_samples(uint8_t instance,
                                                    const Vector3f *scaling)
 {
-    WITH_SEMAPHORE(_sem);
-
     Compass::mag_state &state = _compass._state[Compass::StateIndex(instance)];
+    if (state.samples == nullptr) {
+        return;
+    }
 
-    if (state.accum_count == 0) {
+    uint32_t n = state.samples->available();
+    if (n == 0) {
         return;
     }
 
-    if (scaling) {
-        state.accum *= *scaling;
+    // only average the newest max_samples entries
+    const uint32_t max_samples = state.max_samples;
+    while (max_samples && n > max_samples) {
+        state.samples->pop();
+        n--;
     }
-    state.accum /= state.accum_count;
 
-    publish_filtered_field(state.accum, instance);
+    Matrix3f m;
+    Vector3f ofs;
+    get_field_correction(instance, m, ofs);
+
+    Vector3f accum;
+    uint32_t accum_count = 0;
+    Compass::mag_state::sample_sum entry;
+    while (n-- && state.samples->pop(entry)) {
+        /* correct raw_field for known errors, the correction is
+           linear so it applies to the mean of a summed entry */
+        Vector3f field = entry.sum / entry.count;
+        field = m * field + ofs;
+        if (!field_ok(field)) {
+            continue;
+        }
+        accum += field * entry.count;
+        accum_count += entry.count;
+    }
 
-    state.accum.zero();
-    state.accum_count = 0;
+    if (accum_count == 0) {
+        return;
+    }
+
+    if (scaling) {
+        accum *= *scaling;
+    }
+    accum /= accum_count;
+
+    publish_filtered_field(accum, instance);
 }
 
 /*
@@ -210,7 +323,18 @@ void AP_Compass_Backend::set_last_update_usec(uint32_t last_update, uint8_t inst
  */
 bool AP_Compass_Backend::register_compass(int32_t dev_id, uint8_t& instance) const
 { 
-    return _compass.register_compass(dev_id, instance);
+    if (!_compass.register_compass(dev_id, instance)) {
+        return false;
+    }
+    Compass::mag_state &state = _compass._state[Compass::StateIndex(instance)];
+    if (state.samples == nullptr) {
+        state.samples = NEW_NOTHROW ObjectBuffer<Compass::mag_state::sample_sum>(COMPASS_SAMPLE_BUFFER_SIZE);
+        if (state.samples != nullptr && state.samples->get_size() == 0) {
+            delete state.samples;
+            state.samples = nullptr;
+        }
+    }
+    return state.samples != nullptr;
 }
 
 
@@ -99,9 +99,16 @@ protected:
      * 4. publish_filtered_field - legacy filtered magnetic field
      *
      * All those functions expect the mag field to be in milligauss.
+     *
+     * accumulate_sample() does steps 1 and 2 in the backend thread and
+     * queues the sample. drain_accumulated_samples() does step 3 for
+     * all queued samples of an instance in one pass before step 4.
      */
 
     void rotate_field(Vector3f &mag, uint8_t instance);
+    // rotate_field() with ofs added after the driver rotation, used
+    // for the heater offset
+    void rotate_field(Vector3f &mag, uint8_t instance, const Vector3f &ofs);
     void publish_raw_field(const Vector3f &mag, uint8_t instance);
     void correct_field(Vector3f &mag, uint8_t i);
     void publish_filtered_field(const Vector3f &mag, uint8_t instance);
@@ -135,15 +142,18 @@ protected:
     // access to frontend
     Compass &_compass;
 
-    // semaphore for access to shared frontend data
-    HAL_Semaphore _sem;
-
     // Check that the compass field is valid by using a mean filter on the vector length
     bool field_ok(const Vector3f &field);
     
     uint32_t get_error_count() const { return _error_count; }
 private:
     void apply_corrections(Vector3f &mag, uint8_t i);
+
+    // get the cached fused rotation for an instance
+    const Matrix3f &sensor_to_body(uint8_t instance, enum Rotation post_rotation);
+
+    // get the correction for an instance as corrected = m * mag + ofs
+    void get_field_correction(uint8_t i, Matrix3f &m, Vector3f &ofs);
     
     // mean field length for range filter
     float _mean_field_length;
@@ -0,0 +1,130 @@
+/*
+  benchmark the compass sample path with three external compasses at
+  100Hz read at 10Hz, with throttle based motor compensation. The
+  reference is the previous path which rotated and corrected each
+  sample in the backend thread under a semaphore
+ */
+#include <AP_gbenchmark.h>
+
+#include <AP_Compass/AP_Compass.h>
+#include <AP_Compass/AP_Compass_Backend.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static const uint8_t num_compasses = 3;
+static const uint8_t samples_per_read = 10;
+
+class AP_Compass_Bench : public AP_Compass_Backend
+{
+public:
+    AP_Compass_Bench(uint32_t id)
+    {
+        register_compass(id, instance);
+        set_dev_id(instance, id);
+        set_external(instance, true);
+        set_rotation(instance, ROTATION_YAW_90);
+    }
+
+    void read() override {
+        drain_accumulated_samples(instance);
+    }
+
+    void push_samples(const Vector3f *samples)
+    {
+        for (uint8_t i = 0; i < samples_per_read; i++) {
+            Vector3f f = samples[i];
+            accumulate_sample(f, instance, samples_per_read);
+        }
+    }
+
+    void push_per_sample_reference(const Vector3f *samples)
+    {
+        for (uint8_t i = 0; i < samples_per_read; i++) {
+            Vector3f f = samples[i];
+            f.rotate(MAG_BOARD_ORIENTATION);
+            f.rotate(ROTATION_YAW_90);
+            f.rotate(ROTATION_NONE);
+            publish_raw_field(f, instance);
+            correct_field(f, instance);
+            if (!field_ok(f)) {
+                continue;
+            }
+            WITH_SEMAPHORE(sem);
+            accum += f;
+            accum_count++;
+        }
+    }
+
+    void read_reference()
+    {
+        WITH_SEMAPHORE(sem);
+        if (accum_count == 0) {
+            return;
+        }
+        publish_filtered_field(accum / accum_count, instance);
+        accum.zero();
+        accum_count = 0;
+    }
+
+    uint8_t instance;
+
+private:
+    HAL_Semaphore sem;
+    Vector3f accum;
+    uint32_t accum_count;
+};
+
+static Compass compass;
+static AP_Compass_Bench *backends[num_compasses];
+static Vector3f mag_samples[samples_per_read];
+
+static void setup_backends()
+{
+    if (backends[0] != nullptr) {
+        return;
+    }
+    compass.motor_compensation_type(AP_COMPASS_MOT_COMP_THROTTLE);
+    for (uint8_t i = 0; i < num_compasses; i++) {
+        backends[i] = NEW_NOTHROW AP_Compass_Bench(0x100 + i);
+        compass.set_offsets(i, Vector3f(10.0f * i, -20.0f, 30.0f));
+        compass.set_motor_compensation(i, Vector3f(5.0f, -3.0f, 1.0f));
+    }
+    compass.set_throttle(0.5f);
+    for (uint8_t i = 0; i < samples_per_read; i++) {
+        mag_samples[i] = Vector3f(200.0f + i, -100.0f, 400.0f - i);
+    }
+}
+
+static void BM_CompassAccumulateDrain(benchmark::State& state)
+{
+    setup_backends();
+    while (state.KeepRunning()) {
+        for (uint8_t i = 0; i < num_compasses; i++) {
+            backends[i]->push_samples(mag_samples);
+        }
+        for (uint8_t i = 0; i < num_compasses; i++) {
+            backends[i]->read();
+        }
+        gbenchmark_escape(backends[0]);
+    }
+}
+
+BENCHMARK(BM_CompassAccumulateDrain);
+
+static void BM_CompassPerSampleReference(benchmark::State& state)
+{
+    setup_backends();
+    while (state.KeepRunning()) {
+        for (uint8_t i = 0; i < num_compasses; i++) {
+            backends[i]->push_per_sample_reference(mag_samples);
+        }
+        for (uint8_t i = 0; i < num_compasses; i++) {
+            backends[i]->read_reference();
+        }
+        gbenchmark_escape(backends[0]);
+    }
+}
+
+BENCHMARK(BM_CompassPerSampleReference);
+
+BENCHMARK_MAIN();
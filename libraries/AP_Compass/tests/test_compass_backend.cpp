@@ -0,0 +1,157 @@
+#include <AP_gtest.h>
+
+/*
+  tests for the fused sensor to body rotation and the sample queue in
+  AP_Compass_Backend
+ */
+
+#include <AP_Compass/AP_Compass.h>
+#include <AP_Compass/AP_Compass_Backend.h>
+
+#include <AP_HAL/AP_HAL.h>
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+
+class AP_Compass_Test : public AP_Compass_Backend
+{
+public:
+    AP_Compass_Test(uint32_t id)
+    {
+        registered = register_compass(id, instance);
+        set_dev_id(instance, id);
+    }
+
+    void read() override {
+        drain_accumulated_samples(instance);
+    }
+
+    void accumulate(const Vector3f &sample, uint32_t max_samples)
+    {
+        Vector3f field = sample;
+        accumulate_sample(field, instance, max_samples);
+    }
+
+    // rotate a sample the way a driver does, with an optional heater offset
+    Vector3f rotate(const Vector3f &sample, bool external, enum Rotation rotation, const Vector3f *heater_ofs = nullptr)
+    {
+        set_external(instance, external);
+        set_rotation(instance, rotation);
+        Vector3f mag = sample;
+        if (heater_ofs == nullptr) {
+            rotate_field(mag, instance);
+        } else {
+            rotate_field(mag, instance, *heater_ofs);
+        }
+        return mag;
+    }
+
+    uint8_t instance;
+    bool registered;
+};
+
+/*
+  the rotations rotate_field() applied one at a time before they were
+  fused, with the heater offset added before the board orientation
+ */
+static Vector3f sequential_rotation(Vector3f mag, enum Rotation rotation, enum Rotation post_rotation, const Vector3f &heater_ofs)
+{
+    if (MAG_BOARD_ORIENTATION != ROTATION_NONE) {
+        mag.rotate(MAG_BOARD_ORIENTATION);
+    }
+    mag.rotate(rotation);
+    mag += heater_ofs;
+    mag.rotate(post_rotation);
+    return mag;
+}
+
+static Compass compass;
+
+static const Vector3f sample { 213.5f, -127.25f, 431.75f };
+static const Vector3f heater_ofs { 12.5f, -7.0f, 3.25f };
+
+static void check_rotation(const Vector3f &fused, const Vector3f &expected, enum Rotation rotation, enum Rotation post_rotation)
+{
+    EXPECT_NEAR(fused.x, expected.x, 1e-3) << "rotation " << unsigned(rotation) << " post rotation " << unsigned(post_rotation);
+    EXPECT_NEAR(fused.y, expected.y, 1e-3) << "rotation " << unsigned(rotation) << " post rotation " << unsigned(post_rotation);
+    EXPECT_NEAR(fused.z, expected.z, 1e-3) << "rotation " << unsigned(rotation) << " post rotation " << unsigned(post_rotation);
+}
+
+// internal compasses follow the board orientation
+TEST(AP_Compass, fused_rotation_internal)
+{
+    AP_Compass_Test backend(0x100);
+    ASSERT_TRUE(backend.registered);
+    for (uint8_t p = 0; p < ROTATION_MAX; p++) {
+        const enum Rotation post_rotation = (enum Rotation)p;
+        compass.set_board_orientation(post_rotation);
+        for (uint8_t r = 0; r < ROTATION_MAX; r++) {
+            const enum Rotation rotation = (enum Rotation)r;
+            check_rotation(backend.rotate(sample, false, rotation),
+                           sequential_rotation(sample, rotation, post_rotation, Vector3f()),
+                           rotation, post_rotation);
+            check_rotation(backend.rotate(sample, false, rotation, &heater_ofs),
+                           sequential_rotation(sample, rotation, post_rotation, heater_ofs),
+                           rotation, post_rotation);
+        }
+    }
+    compass.set_board_orientation(ROTATION_NONE);
+}
+
+/*
+  external compasses use their orientation parameter and ignore the
+  board orientation. The loops are the other way round to the internal
+  test, so the cached matrix is rebuilt by a change of either rotation
+ */
+TEST(AP_Compass, fused_rotation_external)
+{
+    AP_Compass_Test backend(0x200);
+    ASSERT_TRUE(backend.registered);
+    compass.set_board_orientation(ROTATION_ROLL_180);
+    for (uint8_t r = 0; r < ROTATION_MAX; r++) {
+        const enum Rotation rotation = (enum Rotation)r;
+        for (uint8_t p = 0; p < ROTATION_MAX; p++) {
+            const enum Rotation post_rotation = (enum Rotation)p;
+            // the first compasses registered have the same priority
+            // as their instance
+            compass.set_and_save_orientation(backend.instance, post_rotation);
+            check_rotation(backend.rotate(sample, true, rotation),
+                           sequential_rotation(sample, rotation, post_rotation, Vector3f()),
+                           rotation, post_rotation);
+            check_rotation(backend.rotate(sample, true, rotation, &heater_ofs),
+                           sequential_rotation(sample, rotation, post_rotation, heater_ofs),
+                           rotation, post_rotation);
+        }
+    }
+    compass.set_board_orientation(ROTATION_NONE);
+}
+
+/*
+  samples that arrive while the sample buffer is full are summed and
+  queued once there is space, so none of them are lost
+ */
+TEST(AP_Compass, accumulate_full_buffer)
+{
+    AP_Compass_Test backend(0x300);
+    ASSERT_TRUE(backend.registered);
+
+    // fill the buffer with one field then keep sampling another
+    const Vector3f field_b = sample * -0.5f;
+    for (uint8_t i = 0; i < 40; i++) {
+        backend.accumulate(i < 20 ? sample : field_b, 100);
+    }
+    backend.read();
+    const Vector3f field_a = sequential_rotation(sample, ROTATION_NONE, ROTATION_NONE, Vector3f());
+    check_rotation(compass.get_field(backend.instance), field_a, ROTATION_NONE, ROTATION_NONE);
+
+    // the next sample is queued with the 20 that were held back
+    const Vector3f field_c = sample * 0.25f;
+    backend.accumulate(field_c, 100);
+    backend.read();
+    const Vector3f expected = sequential_rotation((field_b * 20 + field_c) / 21, ROTATION_NONE, ROTATION_NONE, Vector3f());
+    check_rotation(compass.get_field(backend.instance), expected, ROTATION_NONE, ROTATION_NONE);
+}
+
+AP_GTEST_MAIN()
+
+#endif // HAL_SITL or HAL_LINUX
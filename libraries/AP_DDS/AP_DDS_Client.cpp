@@ -398,8 +398,8 @@ void AP_DDS_Client::update_topic(geometry_msgs_msg_PoseStamped& msg)
     update_topic(msg.header.stamp);
     STRCPY(msg.header.frame_id, BASE_LINK_FRAME_ID);
 
-    auto &ahrs = AP::ahrs();
-    WITH_SEMAPHORE(ahrs.get_semaphore());
+    AP_AHRS::Snapshot ahrs;
+    AP::ahrs().get_snapshot(ahrs);
 
     // ROS REP 103 uses the ENU convention:
     // X - East
@@ -413,8 +413,8 @@ void AP_DDS_Client::update_topic(geometry_msgs_msg_PoseStamped& msg)
     // As a consequence, to follow ROS REP 103, it is necessary to switch X and Y,
     // as well as invert Z
 
-    Vector3f position;
-    if (ahrs.get_relative_position_NED_home(position)) {
+    if (ahrs.relpos_NED_home_ok) {
+        const Vector3f &position = ahrs.relpos_NED_home;
         msg.pose.position.x = position[1];
         msg.pose.position.y = position[0];
         msg.pose.position.z = -position[2];
@@ -428,8 +428,8 @@ void AP_DDS_Client::update_topic(geometry_msgs_msg_PoseStamped& msg)
     // As a consequence, to follow ROS REP 103, it is necessary to switch X and Y,
     // as well as invert Z (NED to ENU conversion) as well as a 90 degree rotation in the Z axis
     // for x to point forward
-    Quaternion orientation;
-    if (ahrs.get_quaternion(orientation)) {
+    if (ahrs.quat_ok) {
+        Quaternion orientation = ahrs.quat;
         Quaternion aux(orientation[0], orientation[2], orientation[1], -orientation[3]); //NED to ENU transformation
         Quaternion transformation (sqrtF(2) * 0.5,0,0,sqrtF(2) * 0.5); // Z axis 90 degree rotation
         orientation = aux * transformation;
@@ -449,8 +449,8 @@ void AP_DDS_Client::update_topic(geometry_msgs_msg_TwistStamped& msg)
     update_topic(msg.header.stamp);
     STRCPY(msg.header.frame_id, BASE_LINK_FRAME_ID);
 
-    auto &ahrs = AP::ahrs();
-    WITH_SEMAPHORE(ahrs.get_semaphore());
+    AP_AHRS::Snapshot ahrs;
+    AP::ahrs().get_snapshot(ahrs);
 
     // ROS REP 103 uses the ENU convention:
     // X - East
@@ -463,8 +463,8 @@ void AP_DDS_Client::update_topic(geometry_msgs_msg_TwistStamped& msg)
     // Z - Down
     // As a consequence, to follow ROS REP 103, it is necessary to switch X and Y,
     // as well as invert Z
-    Vector3f velocity;
-    if (ahrs.get_velocity_NED(velocity)) {
+    if (ahrs.velocity_NED_ok) {
+        const Vector3f &velocity = ahrs.velocity_NED;
         msg.twist.linear.x = velocity[1];
         msg.twist.linear.y = velocity[0];
         msg.twist.linear.z = -velocity[2];
@@ -480,7 +480,7 @@ void AP_DDS_Client::update_topic(geometry_msgs_msg_TwistStamped& msg)
     // Y - Right
     // Z - Down
     // As a consequence, to follow ROS REP 103, it is necessary to invert Y and Z
-    Vector3f angular_velocity = ahrs.get_gyro();
+    const Vector3f &angular_velocity = ahrs.gyro;
     msg.twist.angular.x = angular_velocity[0];
     msg.twist.angular.y = -angular_velocity[1];
     msg.twist.angular.z = -angular_velocity[2];
@@ -521,11 +521,11 @@ void AP_DDS_Client::update_topic(geographic_msgs_msg_GeoPoseStamped& msg)
     update_topic(msg.header.stamp);
     STRCPY(msg.header.frame_id, BASE_LINK_FRAME_ID);
 
-    auto &ahrs = AP::ahrs();
-    WITH_SEMAPHORE(ahrs.get_semaphore());
+    AP_AHRS::Snapshot ahrs;
+    AP::ahrs().get_snapshot(ahrs);
 
-    Location loc;
-    if (ahrs.get_location(loc)) {
+    if (ahrs.location_ok) {
+        const Location &loc = ahrs.location;
         msg.pose.position.latitude = loc.lat * 1E-7;
         msg.pose.position.longitude = loc.lng * 1E-7;
         // TODO this is assumed to be absolute frame in WGS-84 as per the GeoPose message definition in ROS.
@@ -541,8 +541,8 @@ void AP_DDS_Client::update_topic(geographic_msgs_msg_GeoPoseStamped& msg)
     // As a consequence, to follow ROS REP 103, it is necessary to switch X and Y,
     // as well as invert Z (NED to ENU conversion) as well as a 90 degree rotation in the Z axis
     // for x to point forward
-    Quaternion orientation;
-    if (ahrs.get_quaternion(orientation)) {
+    if (ahrs.quat_ok) {
+        Quaternion orientation = ahrs.quat;
         Quaternion aux(orientation[0], orientation[2], orientation[1], -orientation[3]); //NED to ENU transformation
         Quaternion transformation(sqrtF(2) * 0.5, 0, 0, sqrtF(2) * 0.5); // Z axis 90 degree rotation
         orientation = aux * transformation;
@@ -10,6 +10,7 @@ extern const AP_HAL::HAL& hal;
 #define LOG_TAG "DroneCANIface"
 #include <canard.h>
 #include <AP_CANManager/AP_CANSensor.h>
+#include <AP_Common/ExpandingString.h>
 
 #define DEBUG_PKTS 0
 
@@ -204,15 +205,32 @@ void CanardInterface::processTestRx() {
 }
 #endif
 
-void CanardInterface::processTx(bool raw_commands_only = false) {
+// return the transmit priority level of a frame from its CAN ID
+CanardInterface::TxPriority CanardInterface::tx_priority(uint32_t can_id)
+{
+    const uint8_t priority = (can_id >> 24U) & 0x1FU;
+    if (priority <= CANARD_TRANSFER_PRIORITY_HIGH) {
+        return TxPriority::URGENT;
+    }
+    if (priority <= CANARD_TRANSFER_PRIORITY_MEDIUM) {
+        return TxPriority::MEDIUM;
+    }
+    if (priority <= CANARD_TRANSFER_PRIORITY_LOW) {
+        return TxPriority::LOW;
+    }
+    return TxPriority::LOWEST;
+}
+
+void CanardInterface::processTx(bool urgent_only = false) {
     WITH_SEMAPHORE(_sem_tx);
 
+    const uint64_t now_us = AP_HAL::micros64();
+
     for (uint8_t iface = 0; iface < num_ifaces; iface++) {
         if (ifaces[iface] == NULL) {
             continue;
         }
-        auto txq = canard.tx_queue;
-        if (txq == nullptr) {
+        if (canard.tx_queue == nullptr) {
             return;
         }
         // volatile as the value can change at any time during can interrupt
@@ -220,7 +238,7 @@ void CanardInterface::processTx(bool raw_commands_only = false) {
         volatile const auto *stats = ifaces[iface]->get_statistics();
         uint64_t last_transmit_us = stats==nullptr?0:stats->last_transmit_us;
         bool iface_down = true;
-        if (stats == nullptr || (AP_HAL::micros64() - last_transmit_us) < 200000UL) {
+        if (stats == nullptr || (now_us - last_transmit_us) < 200000UL) {
             /*
             We were not able to queue the frame for
             sending. Only mark the send as failing if the
@@ -229,17 +247,24 @@ void CanardInterface::processTx(bool raw_commands_only = false) {
             */
             iface_down = false;
         } 
-        // scan through list of pending transfers
-        while (true) {
+        // scan through list of pending transfers, canard keeps these
+        // sorted by priority so the most urgent frames are sent first
+        for (auto txq = canard.tx_queue; txq != nullptr; txq = txq->next) {
             auto txf = &txq->frame;
-            if (raw_commands_only &&
-                CANARD_MSG_TYPE_FROM_ID(txf->id) != UAVCAN_EQUIPMENT_ESC_RAWCOMMAND_ID &&
-                CANARD_MSG_TYPE_FROM_ID(txf->id) != COM_HOBBYWING_ESC_RAWCOMMAND_ID) {
-                // look at next transfer
-                txq = txq->next;
-                if (txq == nullptr) {
-                    break;
-                }
+            const TxPriority level = tx_priority(txf->id);
+            if (urgent_only && level != TxPriority::URGENT) {
+                // everything after this is less urgent
+                break;
+            }
+            if ((txf->iface_mask & (1U<<iface)) == 0) {
+                // already sent or dropped on this interface
+                continue;
+            }
+            struct tx_stats &lstats = tx_stats[uint8_t(level)];
+            if (now_us >= txf->deadline_usec) {
+                // stale, drop it on this interface rather than send it late
+                txf->iface_mask &= ~(1U<<iface);
+                lstats.dropped++;
                 continue;
             }
             AP_HAL::CANFrame txmsg {};
@@ -252,37 +277,45 @@ void CanardInterface::processTx(bool raw_commands_only = false) {
             bool write = true;
             bool read = false;
             ifaces[iface]->select(read, write, &txmsg, 0);
-            if (!write) {
+            // try sending to interfaces, clearing the mask if we succeed
+            if (write && ifaces[iface]->send(txmsg, txf->deadline_usec, 0) > 0) {
+                txf->iface_mask &= ~(1U<<iface);
+                const uint32_t slack_us = txf->deadline_usec - now_us;
+                lstats.min_slack_us = (lstats.frames == 0) ? slack_us : MIN(lstats.min_slack_us, slack_us);
+                lstats.slack_sum_us += slack_us;
+                lstats.frames++;
+                continue;
+            }
+            if (!iface_down) {
                 // if there is no space then we need to start from the
                 // top of the queue, so wait for the next loop
-                if (!iface_down) {
-                    break;
-                } else {
-                    txf->iface_mask &= ~(1U<<iface);
-                }
-            } else if ((txf->iface_mask & (1U<<iface)) && (AP_HAL::micros64() < txf->deadline_usec)) {
-                // try sending to interfaces, clearing the mask if we succeed
-                if (ifaces[iface]->send(txmsg, txf->deadline_usec, 0) > 0) {
-                    txf->iface_mask &= ~(1U<<iface);
-                } else {
-                    // if we fail to send then we try sending on next interface
-                    if (!iface_down) {
-                        break;
-                    } else {
-                        txf->iface_mask &= ~(1U<<iface);
-                    }
-                }
-            }
-            // look at next transfer
-            txq = txq->next;
-            if (txq == nullptr) {
                 break;
             }
+            txf->iface_mask &= ~(1U<<iface);
+            lstats.dropped++;
         }
     }
 
 }
 
+// per-priority transmit statistics for @SYS/dronecan_tx.txt
+void CanardInterface::tx_stats_info(ExpandingString &str)
+{
+    static const char *names[] { "URGENT", "MEDIUM", "LOW", "LOWEST" };
+    static_assert(ARRAY_SIZE(names) == uint8_t(TxPriority::NUM_LEVELS), "names must match priority levels");
+
+    WITH_SEMAPHORE(_sem_tx);
+    for (uint8_t i = 0; i < ARRAY_SIZE(tx_stats); i++) {
+        const struct tx_stats &lstats = tx_stats[i];
+        str.printf("%-6s TX=%8u DROP=%6u SLACK_MIN=%7u SLACK_AVG=%7u\n",
+                   names[i],
+                   unsigned(lstats.frames),
+                   unsigned(lstats.dropped),
+                   unsigned(lstats.min_slack_us),
+                   unsigned(lstats.frames > 0 ? lstats.slack_sum_us / lstats.frames : 0));
+    }
+}
+
 void CanardInterface::update_rx_protocol_stats(int16_t res)
 {
     switch (res) {
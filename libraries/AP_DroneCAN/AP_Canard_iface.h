@@ -6,6 +6,7 @@
 
 class AP_DroneCAN;
 class CANSensor;
+class ExpandingString;
 
 class CanardInterface : public Canard::Interface {
     friend class AP_DroneCAN;
@@ -36,7 +37,9 @@ public:
     /// @return true if response was added to the queue
     bool respond(uint8_t destination_node_id, const Canard::Transfer &res_transfer) override;
 
-    void processTx(bool raw_commands_only);
+    // send queued frames, if urgent_only is set only frames in the
+    // URGENT priority level (ESC and actuator commands) are sent
+    void processTx(bool urgent_only);
     void processRx();
 
     void process(uint32_t duration);
@@ -64,7 +67,29 @@ public:
     void update_rx_protocol_stats(int16_t res);
 
     uint8_t get_node_id() const override { return canard.node_id; }
+
+    // per-priority transmit statistics for @SYS/dronecan_tx.txt
+    void tx_stats_info(ExpandingString &str);
+
 private:
+    // transmit priority levels, from the CAN ID priority field
+    enum class TxPriority : uint8_t {
+        URGENT = 0, // CANARD_TRANSFER_PRIORITY_HIGH and above
+        MEDIUM,     // up to CANARD_TRANSFER_PRIORITY_MEDIUM
+        LOW,        // up to CANARD_TRANSFER_PRIORITY_LOW
+        LOWEST,
+        NUM_LEVELS
+    };
+    static TxPriority tx_priority(uint32_t can_id);
+
+    // transmit statistics for a priority level, protected by _sem_tx
+    struct tx_stats {
+        uint32_t frames;       // frames sent, counted once per interface
+        uint32_t dropped;      // frames not sent on an interface before their deadline
+        uint32_t min_slack_us; // least time remaining before the deadline when a frame was sent
+        uint64_t slack_sum_us; // total time remaining before the deadline, for the average
+    } tx_stats[uint8_t(TxPriority::NUM_LEVELS)];
+
     CanardInstance canard;
     AP_HAL::CANIface* ifaces[HAL_NUM_CAN_IFACES];
 #if AP_TEST_DRONECAN_DRIVERS
@@ -16,6 +16,7 @@
  */
 
 #include <AP_Common/AP_Common.h>
+#include <AP_Common/ExpandingString.h>
 #include <AP_HAL/AP_HAL.h>
 
 #if HAL_ENABLE_DRONECAN_DRIVERS
@@ -703,6 +704,13 @@ void AP_DroneCAN::send_node_status(void)
     }
 }
 
+// per-priority transmit statistics for @SYS/dronecan_tx.txt
+void AP_DroneCAN::tx_stats_info(ExpandingString &str)
+{
+    str.printf("DroneCAN%u\n", unsigned(_driver_index+1));
+    canard_iface.tx_stats_info(str);
+}
+
 void AP_DroneCAN::handle_node_info_request(const CanardRxTransfer& transfer, const uavcan_protocol_GetNodeInfoRequest& req)
 {
     node_info_rsp.status = node_status_msg;
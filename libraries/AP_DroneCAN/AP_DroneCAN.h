@@ -75,6 +75,7 @@
 // fwd-declare callback classes
 class AP_DroneCAN_DNA_Server;
 class CANSensor;
+class ExpandingString;
 
 class AP_DroneCAN : public AP_CANDriver, public AP_ESC_Telem_Backend {
     friend class AP_DroneCAN_DNA_Server;
@@ -109,6 +110,9 @@ public:
 
     void send_node_status();
 
+    // per-priority transmit statistics for @SYS/dronecan_tx.txt
+    void tx_stats_info(ExpandingString &str);
+
     ///// SRV output /////
     void SRV_push_servos(void);
 
@@ -26,6 +26,8 @@
 #include <AP_CANManager/AP_CANManager.h>
 #include <AP_Scheduler/AP_Scheduler.h>
 #include <AP_Common/ExpandingString.h>
+#include <AP_Scripting/AP_Scripting.h>
+#include <AP_DroneCAN/AP_DroneCAN.h>
 
 extern const AP_HAL::HAL& hal;
 
@@ -40,9 +42,17 @@ static const SysFileList sysfs_file_list[] = {
     {"memory.txt"},
     {"uarts.txt"},
     {"timers.txt"},
+    {"storage.txt"},
+    {"buses.txt"},
+#if AP_SCRIPTING_ENABLED
+    {"scripts.txt"},
+#endif
 #if HAL_MAX_CAN_PROTOCOL_DRIVERS
     {"can_log.txt"},
 #endif
+#if HAL_ENABLE_DRONECAN_DRIVERS
+    {"dronecan_tx.txt"},
+#endif
 #if HAL_NUM_CAN_IFACES > 0
     {"can0_stats.txt"},
     {"can1_stats.txt"},
@@ -120,11 +130,35 @@ int AP_Filesystem_Sys::open(const char *fname, int flags, bool allow_absolute_pa
     if (strcmp(fname, "timers.txt") == 0) {
         hal.util->timer_info(*r.str);
     }
+    if (strcmp(fname, "storage.txt") == 0) {
+        hal.storage->storage_info(*r.str);
+    }
+    if (strcmp(fname, "buses.txt") == 0) {
+        hal.util->bus_info(*r.str);
+    }
+#if AP_SCRIPTING_ENABLED
+    if (strcmp(fname, "scripts.txt") == 0) {
+        AP_Scripting *scripting = AP::scripting();
+        if (scripting != nullptr) {
+            scripting->scripts_info(*r.str);
+        }
+    }
+#endif
 #if HAL_CANMANAGER_ENABLED
     if (strcmp(fname, "can_log.txt") == 0) {
         AP::can().log_retrieve(*r.str);
     }
 #endif
+#if HAL_ENABLE_DRONECAN_DRIVERS
+    if (strcmp(fname, "dronecan_tx.txt") == 0) {
+        for (uint8_t i = 0; i < HAL_MAX_CAN_PROTOCOL_DRIVERS; i++) {
+            AP_DroneCAN *dronecan = AP_DroneCAN::get_dronecan(i);
+            if (dronecan != nullptr) {
+                dronecan->tx_stats_info(*r.str);
+            }
+        }
+    }
+#endif
 #if HAL_NUM_CAN_IFACES > 0
     int8_t can_stats_num = -1;
     if (strcmp(fname, "can0_stats.txt") == 0) {
@@ -19,6 +19,7 @@
 #include <AP_FlashStorage/AP_FlashStorage.h>
 #include <AP_Math/AP_Math.h>
 #include <AP_InternalError/AP_InternalError.h>
+#include <AP_Common/ExpandingString.h>
 #include <stdio.h>
 
 #define FLASHSTORAGE_DEBUG 0
@@ -55,22 +56,37 @@ bool AP_FlashStorage::init(void)
     struct sector_header header[2];
 
     // read headers and possibly initialise if bad signature
+    bool bad_header[2];
     for (uint8_t i=0; i<2; i++) {
         if (!flash_read(i, 0, (uint8_t *)&header[i], sizeof(header[i]))) {
             return false;
         }
-        bool bad_header = !header[i].signature_ok();
+        bad_header[i] = !header[i].signature_ok();
         enum SectorState state = header[i].get_state();
         if (state != SECTOR_STATE_AVAILABLE &&
             state != SECTOR_STATE_IN_USE &&
             state != SECTOR_STATE_FULL) {
-            bad_header = true;
+            bad_header[i] = true;
         }
+    }
 
-        // initialise if bad header
-        if (bad_header) {
-            return erase_all();
+    for (uint8_t i=0; i<2; i++) {
+        if (!bad_header[i]) {
+            continue;
         }
+        if (!bad_header[i^1] &&
+            header[i^1].get_state() == SECTOR_STATE_IN_USE &&
+            header[i].erased()) {
+            // we lost power between erasing this sector and marking
+            // it available. The other sector holds all of storage
+            if (!erase_sector(i, true)) {
+                return false;
+            }
+            header[i].set_state(SECTOR_STATE_AVAILABLE);
+            continue;
+        }
+        // initialise if bad header
+        return erase_all();
     }
 
     // work out the first sector to read from using sector states
@@ -78,24 +94,20 @@ bool AP_FlashStorage::init(void)
     uint8_t first_sector;
 
     if (states[0] == states[1]) {
-        if (states[0] != SECTOR_STATE_AVAILABLE) {
-            return erase_all();
-        }
-        first_sector = 0;
+        // both available means nothing has been written
+        return erase_all();
     } else if (states[0] == SECTOR_STATE_FULL) {
         first_sector = 0;
     } else if (states[1] == SECTOR_STATE_FULL) {
         first_sector = 1;
     } else if (states[0] == SECTOR_STATE_IN_USE) {
         first_sector = 0;
-    } else if (states[1] == SECTOR_STATE_IN_USE) {
-        first_sector = 1;
     } else {
-        // doesn't matter which is first
-        first_sector = 0;
+        first_sector = 1;
     }
 
-    // load data from any current sectors
+    // load data from any current sectors, the last one loaded is
+    // the one we continue writing to
     for (uint8_t i=0; i<2; i++) {
         uint8_t sector = (first_sector + i) & 1;
         if (states[sector] == SECTOR_STATE_IN_USE ||
@@ -103,16 +115,28 @@ bool AP_FlashStorage::init(void)
             if (!load_sector(sector)) {
                 return erase_all();
             }
+            current_sector = sector;
         }
     }
 
     // clear any write error
     write_error = false;
     reserved_space = 0;
+    compacting = false;
     
     // if the first sector is full then write out all data so we can erase it
     if (states[first_sector] == SECTOR_STATE_FULL) {
         current_sector = first_sector ^ 1;
+        if (states[current_sector] == SECTOR_STATE_AVAILABLE) {
+            // we lost power in switch_sectors() between marking the
+            // full sector and the new one
+            header[current_sector].set_state(SECTOR_STATE_IN_USE);
+            if (!flash_write(current_sector, 0, (const uint8_t *)&header[current_sector], sizeof(header[current_sector]))) {
+                return false;
+            }
+            write_offset = sizeof(struct sector_header);
+            current_chunks.clearall();
+        }
         if (!write_all()) {
             return erase_all();
         }
@@ -146,7 +170,11 @@ bool AP_FlashStorage::switch_full_sector(void)
         return false;
     }
     in_switch_full_sector = true;
+    const uint32_t start_us = AP_HAL::micros();
     bool ret = protected_switch_full_sector();
+    stats.last_compaction_us = AP_HAL::micros() - start_us;
+    stats.max_compaction_us = MAX(stats.max_compaction_us, stats.last_compaction_us);
+    stats.compactions++;
     in_switch_full_sector = false;
     return ret;
 }
@@ -161,6 +189,8 @@ bool AP_FlashStorage::protected_switch_full_sector(void)
     // clear any write error
     write_error = false;
     reserved_space = 0;
+    // the write_all() below replaces any background copy
+    compacting = false;
     
     if (!write_all()) {
         return false;
@@ -173,8 +203,94 @@ bool AP_FlashStorage::protected_switch_full_sector(void)
     return switch_sectors();
 }
 
+/*
+  continue a background compaction after a sector switch. The old
+  sector stays marked full until all of mem_buffer has been copied to
+  the current sector, so init() can recover from a power loss at any
+  point by loading both sectors
+ */
+bool AP_FlashStorage::compact_step(void)
+{
+    if (!compacting || write_error) {
+        return !write_error;
+    }
+    if (compact_offset < storage_size) {
+        const uint32_t start_us = AP_HAL::micros();
+        const bool ret = compact_copy();
+        stats.max_compact_copy_us = MAX(stats.max_compact_copy_us, AP_HAL::micros() - start_us);
+        return ret;
+    }
+    if (!flash_erase_ok()) {
+        // try again later
+        return true;
+    }
+    debug("compaction erasing sector %u\n", current_sector ^ 1);
+    if (!erase_sector(current_sector ^ 1, true)) {
+        return false;
+    }
+    // the other sector is available again, so we no longer need the
+    // space for init() to copy storage
+    compacting = false;
+    reserved_space = 0;
+    stats.background_compactions++;
+    return true;
+}
+
+// copy the next few non-zero blocks of mem_buffer to the current sector
+bool AP_FlashStorage::compact_copy(void)
+{
+    uint8_t nwrites = 0;
+    while (compact_offset < storage_size && nwrites < AP_FLASHSTORAGE_COMPACT_WRITES) {
+        // local variable needed to overcome problem with MIN() macro and -O0
+        const uint8_t max_write_local = max_write;
+        const uint8_t n = MIN(max_write_local, storage_size-compact_offset);
+        if (!current_chunks.get(compact_offset / max_write) && !all_zero(compact_offset, n)) {
+            if (flash_sector_size - write_offset < sizeof(struct block_header) + max_write + reserved_space) {
+                // the sector has filled before the copy finished,
+                // leave the reserved space for init() and let the
+                // next write() do a full sector switch
+                return true;
+            }
+            if (!write_blocks(compact_offset, n)) {
+                return false;
+            }
+            nwrites++;
+        }
+        compact_offset += n;
+    }
+    return true;
+}
+
 // write some data to virtual EEPROM
 bool AP_FlashStorage::write(uint16_t offset, uint16_t length)
+{
+    if (write_error) {
+        return false;
+    }
+    stats.write_bytes += length;
+    return write_blocks(offset, length);
+}
+
+// print flash usage statistics, with write amplification relative to
+// the bytes written to storage by the HAL
+void AP_FlashStorage::stats_info(ExpandingString &str, uint32_t written_bytes) const
+{
+    str.printf("Flushed: %u bytes\n", unsigned(stats.write_bytes));
+    str.printf("Flash: %u bytes amplification %.2f\n",
+               unsigned(stats.flash_bytes),
+               written_bytes > 0 ? float(stats.flash_bytes) / float(written_bytes) : 0.0f);
+    str.printf("Compactions: %u last %.1fms max %.1fms\n",
+               unsigned(stats.compactions),
+               stats.last_compaction_us * 0.001f,
+               stats.max_compaction_us * 0.001f);
+    str.printf("Background compactions: %u max copy %.1fms\n",
+               unsigned(stats.background_compactions),
+               stats.max_compact_copy_us * 0.001f);
+}
+
+// write blocks covering offset to offset+length, used both for caller
+// writes and for writing out all of mem_buffer when changing sectors
+bool AP_FlashStorage::write_blocks(uint16_t offset, uint16_t length)
 {
     if (write_error) {
         return false;
@@ -214,7 +330,11 @@ bool AP_FlashStorage::write(uint16_t offset, uint16_t length)
         uint16_t block_ofs = blk.header.block_num*block_size;
         uint16_t block_nbytes = (blk.header.num_blocks_minus_one+1)*block_size;
 
-        memcpy(blk.data, &mem_buffer[block_ofs], block_nbytes);
+        // when storage_size is not a multiple of block_size the last
+        // block extends past the end of mem_buffer, pad it with zeros
+        const uint16_t storage_nbytes = MIN(block_nbytes, uint16_t(storage_size - block_ofs));
+        memcpy(blk.data, &mem_buffer[block_ofs], storage_nbytes);
+        memset(&blk.data[storage_nbytes], 0, block_nbytes - storage_nbytes);
 
 #if AP_FLASHSTORAGE_TYPE == AP_FLASHSTORAGE_TYPE_F4
         if (!flash_write(current_sector, write_offset, (uint8_t*)&blk.header, sizeof(blk.header))) {
@@ -240,6 +360,8 @@ bool AP_FlashStorage::write(uint16_t offset, uint16_t length)
 #endif
 
         write_offset += sizeof(blk.header) + block_nbytes;
+        stats.flash_bytes += sizeof(blk.header) + block_nbytes;
+        mark_current(block_ofs, block_nbytes);
 
         uint8_t n2 = block_nbytes - (offset % block_size);
         //debug("write_block at %u for %u n2=%u\n", block_ofs, block_nbytes, n2);
@@ -264,6 +386,8 @@ bool AP_FlashStorage::write(uint16_t offset, uint16_t length)
 bool AP_FlashStorage::load_sector(uint8_t sector)
 {
     uint32_t ofs = sizeof(sector_header);
+    // only the last sector loaded becomes the current sector
+    current_chunks.clearall();
     while (ofs < flash_sector_size - sizeof(struct block_header)) {
         struct block_header header;
         if (!flash_read(sector, ofs, (uint8_t *)&header, sizeof(header))) {
@@ -295,13 +419,16 @@ bool AP_FlashStorage::load_sector(uint8_t sector)
         case BLOCK_STATE_VALID: {
             uint16_t block_nbytes = (header.num_blocks_minus_one+1)*block_size;
             uint16_t block_ofs = header.block_num*block_size;
-            if (block_ofs + block_nbytes > storage_size) {
+            if (block_ofs >= storage_size) {
                 // the data is invalid (out of range)
                 return false;
             }
-            if (!flash_read(sector, ofs+sizeof(header), &mem_buffer[block_ofs], block_nbytes)) {
+            // the last block may extend past the end of storage, see write()
+            const uint16_t storage_nbytes = MIN(block_nbytes, uint16_t(storage_size - block_ofs));
+            if (!flash_read(sector, ofs+sizeof(header), &mem_buffer[block_ofs], storage_nbytes)) {
                 return false;
             }
+            mark_current(block_ofs, block_nbytes);
             //debug("read at %u for %u\n", block_ofs, block_nbytes);
             ofs += block_nbytes + sizeof(header);
             break;
@@ -344,6 +471,8 @@ bool AP_FlashStorage::erase_sector(uint8_t sector, bool mark_available)
 bool AP_FlashStorage::erase_all(void)
 {
     write_error = false;
+    compacting = false;
+    current_chunks.clearall();
 
     current_sector = 0;
     write_offset = sizeof(struct sector_header);
@@ -362,7 +491,10 @@ bool AP_FlashStorage::erase_all(void)
 }
 
 /*
-  write all of mem_buffer to current sector
+  write all of mem_buffer to current sector, skipping chunks that are
+  already there. This lets an init() interrupted by a power loss
+  continue where it left off rather than needing space for another
+  full copy
  */
 bool AP_FlashStorage::write_all()
 {
@@ -372,8 +504,8 @@ bool AP_FlashStorage::write_all()
         // local variable needed to overcome problem with MIN() macro and -O0
         const uint8_t max_write_local = max_write;
         uint8_t n = MIN(max_write_local, storage_size-ofs);
-        if (!all_zero(ofs, n)) {
-            if (!write(ofs, n)) {
+        if (!current_chunks.get(ofs / max_write) && !all_zero(ofs, n)) {
+            if (!write_blocks(ofs, n)) {
                 return false;
             }
         }
@@ -381,6 +513,35 @@ bool AP_FlashStorage::write_all()
     return true;
 }
 
+// return true if the header has not been written since an erase
+bool AP_FlashStorage::sector_header::erased(void) const
+{
+    const uint8_t *b = (const uint8_t *)this;
+    for (uint8_t i=0; i<sizeof(*this); i++) {
+        if (b[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+  note that the block at block_ofs holds the latest data for the chunk
+  of max_write bytes starting there if it covers the whole chunk. A
+  chunk only partly rewritten is copied again when changing sectors
+ */
+void AP_FlashStorage::mark_current(uint16_t block_ofs, uint16_t block_nbytes)
+{
+    if (block_ofs % max_write != 0) {
+        return;
+    }
+    // local variable needed to overcome problem with MIN() macro and -O0
+    const uint8_t max_write_local = max_write;
+    if (block_nbytes >= MIN(max_write_local, storage_size-block_ofs)) {
+        current_chunks.set(block_ofs / max_write);
+    }
+}
+
 // return true if all bytes are zero
 bool AP_FlashStorage::all_zero(uint16_t ofs, uint16_t size)
 {
@@ -443,6 +604,11 @@ bool AP_FlashStorage::switch_sectors(void)
     reserved_space = reserve_size;
     
     write_offset = sizeof(header);
+
+    // start copying storage so the full sector can be erased
+    compacting = true;
+    compact_offset = 0;
+    current_chunks.clearall();
     return true;    
 }
 
@@ -633,6 +799,9 @@ AP_FlashStorage::SectorState AP_FlashStorage::sector_header::get_state(void) con
 
 void AP_FlashStorage::sector_header::set_state(SectorState state)
 {
+    // leave the padding after signature1 erased so that later state
+    // changes only clear bits
+    memset((void *)this, 0xff, sizeof(*this));
     signature1 = signature;
     switch (state) {
     case SECTOR_STATE_AVAILABLE:
@@ -34,10 +34,18 @@
     128k flash sectors with 16k storage size.
 
   - assumes two flash sectors are available
+
+  - after a switch to a new sector the contents of storage are copied
+    to it a few blocks at a time by compact_step(), after which the
+    old sector is erased. This avoids writing out all of storage in
+    one go when the new sector fills
  */
 #pragma once
 
 #include <AP_HAL/AP_HAL.h>
+#include <AP_Common/Bitmask.h>
+
+class ExpandingString;
 
 /*
   we support 3 different types of flash which have different restrictions
@@ -72,6 +80,11 @@
 #endif
 #endif
 
+// number of blocks compact_step() writes in one call
+#ifndef AP_FLASHSTORAGE_COMPACT_WRITES
+#define AP_FLASHSTORAGE_COMPACT_WRITES 4
+#endif
+
 /*
   The StorageManager holds the layout of non-volatile storage
  */
@@ -90,6 +103,7 @@ private:
     static const uint8_t max_write = 64;
 #endif
     static const uint16_t num_blocks = (HAL_STORAGE_SIZE+(block_size-1)) / block_size;
+    static const uint16_t num_chunks = (HAL_STORAGE_SIZE+(max_write-1)) / max_write;
 
 public:
     // caller provided function to write to a flash sector
@@ -130,8 +144,36 @@ public:
     // write some data to storage from mem_buffer
     bool write(uint16_t offset, uint16_t length) WARN_IF_UNUSED;
 
+    // continue copying storage to the current sector after a sector
+    // switch, erasing the old sector once the copy is complete and
+    // erasing is allowed. Each call does at most
+    // AP_FLASHSTORAGE_COMPACT_WRITES block writes or one erase
+    bool compact_step(void) WARN_IF_UNUSED;
+
+    // true if the old sector still needs to be copied or erased
+    bool compact_pending(void) const { return compacting; }
+
     // fixed storage size
     static const uint16_t storage_size = HAL_STORAGE_SIZE;
+
+    // largest write that is stored as a single block
+    static const uint8_t max_write_size = max_write;
+
+    // statistics on flash usage since boot
+    struct Stats {
+        uint32_t write_bytes;           // bytes of mem_buffer written by the caller
+        uint32_t flash_bytes;           // bytes written to flash, including block headers and compaction
+        uint16_t compactions;           // number of full sector switches, each needing an erase
+        uint32_t last_compaction_us;    // time taken by the last full sector switch
+        uint32_t max_compaction_us;     // longest time taken by a full sector switch
+        uint16_t background_compactions; // number of old sectors erased by compact_step()
+        uint32_t max_compact_copy_us;   // longest block copy done by compact_step()
+    };
+    const Stats &get_stats(void) const { return stats; }
+
+    // print the statistics for the HAL storage_info() report,
+    // written_bytes is the number of bytes written to storage by the HAL
+    void stats_info(ExpandingString &str, uint32_t written_bytes) const;
     
 private:
     uint8_t *mem_buffer;
@@ -145,6 +187,16 @@ private:
     uint32_t write_offset;
     uint32_t reserved_space;
     bool write_error;
+    Stats stats;
+
+    // background compaction state, compact_offset is the next byte of
+    // mem_buffer to copy to the current sector
+    bool compacting;
+    uint16_t compact_offset;
+
+    // chunks of max_write bytes of mem_buffer whose latest data is in
+    // the current sector, so don't need copying when changing sectors
+    Bitmask<num_chunks> current_chunks;
 
     // 24 bit signature
 #if AP_FLASHSTORAGE_TYPE == AP_FLASHSTORAGE_TYPE_F4
@@ -196,6 +248,7 @@ private:
         uint32_t signature3;
 #endif
         bool signature_ok(void) const;
+        bool erased(void) const;
         SectorState get_state() const;
         void set_state(SectorState state);
     };
@@ -214,8 +267,10 @@ private:
         uint16_t num_blocks_minus_one:3;
     };
 
-    // amount of space needed to write full storage
-    static const uint32_t reserve_size = (storage_size / max_write) * (sizeof(block_header) + max_write) + max_write;
+    // amount of space needed to write full storage. This includes two
+    // blocks left unfinished by power losses, one during a full
+    // sector switch and one during the init() that completes it
+    static const uint32_t reserve_size = (num_chunks + 2) * (sizeof(block_header) + max_write);
         
     // load data from a sector
     bool load_sector(uint8_t sector) WARN_IF_UNUSED;
@@ -226,15 +281,25 @@ private:
     // erase all sectors and reset
     bool erase_all() WARN_IF_UNUSED;
 
-    // write all of mem_buffer to current sector
+    // write all of mem_buffer not already in the current sector
     bool write_all() WARN_IF_UNUSED;
 
+    // write blocks covering part of mem_buffer, without counting it as a caller write
+    bool write_blocks(uint16_t offset, uint16_t length) WARN_IF_UNUSED;
+
+    // note chunks fully covered by a block in the current sector
+    void mark_current(uint16_t block_ofs, uint16_t block_nbytes);
+
     // return true if all bytes are zero
     bool all_zero(uint16_t ofs, uint16_t size) WARN_IF_UNUSED;
 
     // switch to next sector for writing
     bool switch_sectors(void) WARN_IF_UNUSED;
 
+    // copy up to AP_FLASHSTORAGE_COMPACT_WRITES blocks of mem_buffer
+    // to the current sector
+    bool compact_copy(void) WARN_IF_UNUSED;
+
     // _switch_full_sector is protected by switch_full_sector to avoid
     // an infinite recursion problem; switch_full_sector calls
     // write() which can call switch_full_sector.  This has been seen
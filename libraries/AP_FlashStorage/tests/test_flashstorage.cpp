@@ -0,0 +1,311 @@
+#include <AP_gtest.h>
+
+/*
+  tests for AP_FlashStorage write statistics, background compaction
+  and recovery from power loss
+ */
+
+#include <AP_FlashStorage/AP_FlashStorage.h>
+#include <AP_Math/AP_Math.h>
+#include <AP_Common/ExpandingString.h>
+
+#include <AP_HAL/AP_HAL.h>
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+
+// two sectors of RAM emulating flash which can only clear bits
+class FlashStorageHarness {
+public:
+    static const uint32_t flash_sector_size = 48U * 1024U;
+
+    FlashStorageHarness() {
+        memset(flash, 0xFF, sizeof(flash));
+        memset(mem_mirror, 0, sizeof(mem_mirror));
+        memset(mem_prev, 0, sizeof(mem_prev));
+    }
+
+    uint8_t mem_buffer[AP_FlashStorage::storage_size];
+    uint8_t mem_mirror[AP_FlashStorage::storage_size];
+    // contents before the write in progress, after a power loss
+    // each byte may hold either this or the mem_mirror value
+    uint8_t mem_prev[AP_FlashStorage::storage_size];
+    uint8_t flash[2][flash_sector_size];
+    bool erase_ok = true;
+
+    // check recovery from a power loss before every flash write and erase
+    bool check_power_loss = false;
+    uint32_t recovery_checks = 0;
+    uint32_t recovery_failures = 0;
+
+    // flash writes and erases to allow before power is lost, -1 for no limit
+    int32_t power_loss_countdown = -1;
+    uint32_t flash_ops = 0;
+
+    AP_FlashStorage storage{mem_buffer,
+            flash_sector_size,
+            FUNCTOR_BIND_MEMBER(&FlashStorageHarness::flash_write, bool, uint8_t, uint32_t, const uint8_t *, uint16_t),
+            FUNCTOR_BIND_MEMBER(&FlashStorageHarness::flash_read, bool, uint8_t, uint32_t, uint8_t *, uint16_t),
+            FUNCTOR_BIND_MEMBER(&FlashStorageHarness::flash_erase, bool, uint8_t),
+            FUNCTOR_BIND_MEMBER(&FlashStorageHarness::flash_erase_ok, bool)};
+
+    // write to storage and mem_mirror
+    bool write(uint16_t offset, const uint8_t *data, uint16_t length) {
+        memcpy(&mem_mirror[offset], data, length);
+        memcpy(&mem_buffer[offset], data, length);
+        const bool ret = storage.write(offset, length);
+        memcpy(&mem_prev[offset], data, length);
+        return ret;
+    }
+
+    // return true if buf holds the expected data
+    bool check_data(const uint8_t *buf) const {
+        for (uint16_t i=0; i<AP_FlashStorage::storage_size; i++) {
+            if (buf[i] != mem_mirror[i] && buf[i] != mem_prev[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    // called before each flash write or erase
+    bool flash_op(void) {
+        if (check_power_loss && recovery_failures == 0) {
+            check_recovery();
+        }
+        if (power_loss_countdown == 0) {
+            return false;
+        }
+        if (power_loss_countdown > 0) {
+            power_loss_countdown--;
+        }
+        flash_ops++;
+        return true;
+    }
+    void check_recovery(void);
+
+    bool flash_write(uint8_t sector, uint32_t offset, const uint8_t *data, uint16_t length) {
+        if (!flash_op()) {
+            return false;
+        }
+        for (uint16_t i=0; i<length; i++) {
+            if (data[i] & ~flash[sector][offset+i]) {
+                return false;
+            }
+            flash[sector][offset+i] = data[i];
+        }
+        return true;
+    }
+    bool flash_read(uint8_t sector, uint32_t offset, uint8_t *data, uint16_t length) {
+        memcpy(data, &flash[sector][offset], length);
+        return true;
+    }
+    bool flash_erase(uint8_t sector) {
+        if (!flash_op()) {
+            return false;
+        }
+        memset(flash[sector], 0xFF, flash_sector_size);
+        return true;
+    }
+    bool flash_erase_ok(void) {
+        return erase_ok;
+    }
+};
+
+// repeatable random numbers for the power loss test
+static uint32_t fuzz_random(uint32_t &state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// write random data at a random offset
+static bool random_write(FlashStorageHarness &h, uint32_t &state)
+{
+    const uint16_t ofs = fuzz_random(state) % AP_FlashStorage::storage_size;
+    const uint16_t length = MIN(uint16_t(1 + (fuzz_random(state) & 0x1F)), AP_FlashStorage::storage_size - ofs);
+    uint8_t data[32];
+    for (uint8_t j=0; j<length; j++) {
+        data[j] = fuzz_random(state) & 0xFF;
+    }
+    return h.write(ofs, data, length);
+}
+
+/*
+  boot from a copy of flash as if power was lost before the next flash
+  operation. Some boots lose power again part way through init(), and
+  some carry on writing to check storage is usable afterwards
+ */
+void FlashStorageHarness::check_recovery(void)
+{
+    recovery_checks++;
+
+    FlashStorageHarness *r = new FlashStorageHarness;
+    memcpy(r->flash, flash, sizeof(flash));
+    r->power_loss_countdown = (recovery_checks * 7919U) % 700U;
+    if (!r->storage.init()) {
+        r->power_loss_countdown = -1;
+        if (!r->storage.init()) {
+            ADD_FAILURE() << "init failed after power loss at flash op " << flash_ops;
+            recovery_failures++;
+            delete r;
+            return;
+        }
+    }
+    r->power_loss_countdown = -1;
+    if (!check_data(r->mem_buffer)) {
+        ADD_FAILURE() << "data lost after power loss at flash op " << flash_ops;
+        recovery_failures++;
+        delete r;
+        return;
+    }
+
+    if (recovery_checks % 16 == 0) {
+        memcpy(r->mem_mirror, r->mem_buffer, sizeof(r->mem_mirror));
+        memcpy(r->mem_prev, r->mem_buffer, sizeof(r->mem_prev));
+        uint32_t state = recovery_checks;
+        for (uint8_t i=0; i<50; i++) {
+            if (!random_write(*r, state) || !r->storage.compact_step()) {
+                ADD_FAILURE() << "write failed after power loss at flash op " << flash_ops;
+                recovery_failures++;
+                break;
+            }
+        }
+        memset(r->mem_buffer, 0, sizeof(r->mem_buffer));
+        if (!r->storage.init() || !r->check_data(r->mem_buffer)) {
+            ADD_FAILURE() << "data lost after writes following power loss at flash op " << flash_ops;
+            recovery_failures++;
+        }
+    }
+    delete r;
+}
+
+// one write covering several small ranges needs fewer block headers
+TEST(AP_FlashStorage, coalesced_write)
+{
+    uint8_t data[64];
+    for (uint8_t i=0; i<sizeof(data); i++) {
+        data[i] = i+1;
+    }
+
+    FlashStorageHarness *separate = new FlashStorageHarness;
+    ASSERT_TRUE(separate->storage.init());
+    for (uint8_t ofs=0; ofs<sizeof(data); ofs += 8) {
+        EXPECT_TRUE(separate->write(ofs, &data[ofs], 8));
+    }
+
+    FlashStorageHarness *coalesced = new FlashStorageHarness;
+    ASSERT_TRUE(coalesced->storage.init());
+    EXPECT_TRUE(coalesced->write(0, data, sizeof(data)));
+
+    EXPECT_EQ(separate->storage.get_stats().write_bytes, sizeof(data));
+    EXPECT_EQ(coalesced->storage.get_stats().write_bytes, sizeof(data));
+    EXPECT_LT(coalesced->storage.get_stats().flash_bytes, separate->storage.get_stats().flash_bytes);
+    EXPECT_GE(coalesced->storage.get_stats().flash_bytes, sizeof(data));
+
+    delete separate;
+    delete coalesced;
+}
+
+// fill the sectors until they are compacted, then check the data survives a reload
+TEST(AP_FlashStorage, compaction_stats)
+{
+    FlashStorageHarness *h = new FlashStorageHarness;
+    ASSERT_TRUE(h->storage.init());
+
+    uint32_t write_bytes = 0;
+    for (uint32_t i=0; i<20000; i++) {
+        const uint16_t ofs = get_random16() % AP_FlashStorage::storage_size;
+        const uint16_t length = MIN(uint16_t(1 + (get_random16() & 0x1F)), AP_FlashStorage::storage_size - ofs);
+        uint8_t data[32];
+        for (uint8_t j=0; j<length; j++) {
+            data[j] = get_random16() & 0xFF;
+        }
+        ASSERT_TRUE(h->write(ofs, data, length));
+        write_bytes += length;
+    }
+
+    const AP_FlashStorage::Stats &stats = h->storage.get_stats();
+    EXPECT_EQ(stats.write_bytes, write_bytes);
+    EXPECT_GT(stats.flash_bytes, write_bytes);
+    EXPECT_GT(stats.compactions, 0);
+    EXPECT_GE(stats.max_compaction_us, stats.last_compaction_us);
+
+    // the HAL storage_info() report
+    ExpandingString str;
+    h->storage.stats_info(str, write_bytes);
+    char flushed[32];
+    snprintf(flushed, sizeof(flushed), "Flushed: %u bytes\n", unsigned(write_bytes));
+    EXPECT_EQ(strncmp(str.get_string(), flushed, strlen(flushed)), 0);
+    EXPECT_NE(strstr(str.get_string(), "Background compactions: "), nullptr);
+
+    memset(h->mem_buffer, 0, sizeof(h->mem_buffer));
+    ASSERT_TRUE(h->storage.init());
+    EXPECT_EQ(memcmp(h->mem_buffer, h->mem_mirror, sizeof(h->mem_buffer)), 0);
+
+    delete h;
+}
+
+// background compaction keeps up with writes without a full sector switch
+TEST(AP_FlashStorage, background_compaction)
+{
+    FlashStorageHarness *h = new FlashStorageHarness;
+    ASSERT_TRUE(h->storage.init());
+
+    uint32_t state = 1;
+    for (uint32_t i=0; i<20000; i++) {
+        ASSERT_TRUE(random_write(*h, state));
+        ASSERT_TRUE(h->storage.compact_step());
+    }
+    while (h->storage.compact_pending()) {
+        ASSERT_TRUE(h->storage.compact_step());
+    }
+
+    const AP_FlashStorage::Stats &stats = h->storage.get_stats();
+    EXPECT_GT(stats.background_compactions, 0);
+    EXPECT_EQ(stats.compactions, 0);
+
+    memset(h->mem_buffer, 0, sizeof(h->mem_buffer));
+    ASSERT_TRUE(h->storage.init());
+    EXPECT_EQ(memcmp(h->mem_buffer, h->mem_mirror, sizeof(h->mem_buffer)), 0);
+
+    delete h;
+}
+
+/*
+  writes with background compaction, some of it while erasing is not
+  allowed, then a long run without compaction so that the sectors fill
+  and a full sector switch is needed. Storage must survive a power
+  loss before every flash operation
+ */
+TEST(AP_FlashStorage, power_loss)
+{
+    FlashStorageHarness *h = new FlashStorageHarness;
+    ASSERT_TRUE(h->storage.init());
+    h->check_power_loss = true;
+    h->flash_ops = 0;
+
+    uint32_t state = 1;
+    for (uint32_t i=0; i<6000 && h->recovery_failures == 0; i++) {
+        h->erase_ok = i < 300 || i >= 600;
+        ASSERT_TRUE(random_write(*h, state));
+        if (i < 1500 || i >= 5000) {
+            ASSERT_TRUE(h->storage.compact_step());
+        }
+    }
+
+    const AP_FlashStorage::Stats &stats = h->storage.get_stats();
+    EXPECT_EQ(h->recovery_failures, 0U);
+    EXPECT_EQ(h->recovery_checks, h->flash_ops);
+    EXPECT_GT(stats.background_compactions, 0);
+    EXPECT_GT(stats.compactions, 0);
+
+    delete h;
+}
+
+AP_GTEST_MAIN()
+
+#endif // HAL_SITL or HAL_LINUX
@@ -58,20 +58,25 @@ extern const AP_HAL::HAL& hal;
 
 bool AP_GPS_NMEA::read(void)
 {
-    int16_t numc;
     bool parsed = false;
 
     send_config();
 
-    numc = port->available();
-    while (numc--) {
-        char c = port->read();
-#if AP_GPS_DEBUG_LOGGING_ENABLED
-        log_data((const uint8_t *)&c, 1);
-#endif
-        if (_decode(c)) {
-            parsed = true;
+    uint32_t numc = port->available();
+    while (numc > 0) {
+        uint32_t n;
+        const uint8_t *buf = read_span(n);
+        if (buf == nullptr) {
+            break;
+        }
+        n = MIN(n, numc);
+        for (uint32_t i = 0; i < n; i++) {
+            if (_decode(char(buf[i]))) {
+                parsed = true;
+            }
         }
+        consume_span(n);
+        numc -= n;
     }
     return parsed;
 }
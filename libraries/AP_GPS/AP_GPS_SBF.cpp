@@ -89,12 +89,18 @@ AP_GPS_SBF::read(void)
 {
     bool ret = false;
     uint32_t available_bytes = port->available();
-    for (uint32_t i = 0; i < available_bytes; i++) {
-        uint8_t temp = port->read();
-#if AP_GPS_DEBUG_LOGGING_ENABLED
-        log_data(&temp, 1);
-#endif
-        ret |= parse(temp);
+    while (available_bytes > 0) {
+        uint32_t n;
+        const uint8_t *buf = read_span(n);
+        if (buf == nullptr) {
+            break;
+        }
+        n = MIN(n, available_bytes);
+        for (uint32_t i = 0; i < n; i++) {
+            ret |= parse(buf[i]);
+        }
+        consume_span(n);
+        available_bytes -= n;
     }
 
     const uint32_t now = AP_HAL::millis();
@@ -685,17 +685,65 @@ AP_GPS_UBLOX::read(void)
         }
     }
 
-    const uint16_t numc = MIN(port->available(), 8192U);
-    for (uint16_t i = 0; i < numc; i++) {        // Process bytes received
-
-        // read the next byte
-        uint8_t data;
-        if (!port->read(data)) {
+    // process received bytes a span at a time, straight from the
+    // UART receive buffer
+    uint32_t numc = MIN(port->available(), 8192U);
+    while (numc > 0) {
+        uint32_t n;
+        const uint8_t *buf = read_span(n);
+        if (buf == nullptr) {
+            break;
+        }
+        n = MIN(n, numc);
+        bool stop = false;
+        const uint32_t used = _parse_span(buf, n, parsed, stop);
+        consume_span(used);
+        numc -= used;
+        if (stop) {
             break;
         }
-#if AP_GPS_DEBUG_LOGGING_ENABLED
-        log_data(&data, 1);
+    }
+    return parsed;
+}
+
+/*
+  run the parser over a span of received bytes, returning the number
+  of bytes consumed. stop is set if parsing should pause to let a
+  RTCMv3 packet be handled
+ */
+uint32_t AP_GPS_UBLOX::_parse_span(const uint8_t *buf, uint32_t len, bool &parsed, bool &stop)
+{
+#if GPS_MOVING_BASELINE
+    // the RTCMv3 parser needs to see every byte
+    const bool scan_ok = rtcm3_parser == nullptr;
+#else
+    const bool scan_ok = true;
 #endif
+    uint32_t i = 0;
+    while (i < len) {
+        if (scan_ok && _step == 0) {
+            // skip straight to the next possible start of a message
+            const uint8_t *p = (const uint8_t *)memchr(&buf[i], PREAMBLE1, len - i);
+            if (p == nullptr) {
+                return len;
+            }
+            i = p - buf;
+        } else if (scan_ok && _step == 6) {
+            // copy as much of the payload as we have and checksum it in place
+            const uint32_t count = MIN(len - i, uint32_t(_payload_length - _payload_counter));
+            memcpy(&_buffer[_payload_counter], &buf[i], count);
+            for (uint32_t k = 0; k < count; k++) {
+                _ck_b += (_ck_a += buf[i+k]);
+            }
+            _payload_counter += count;
+            i += count;
+            if (_payload_counter == _payload_length) {
+                _step++;
+            }
+            continue;
+        }
+
+        const uint8_t data = buf[i++];
 
 #if GPS_MOVING_BASELINE
         if (rtcm3_parser) {
@@ -706,7 +754,8 @@ AP_GPS_UBLOX::read(void)
                 // chance to send the RTCMv3 packet to another (rover)
                 // GPS
                 _step = 0;
-                break;
+                stop = true;
+                return i;
             }
         }
 #endif
@@ -819,7 +868,7 @@ AP_GPS_UBLOX::read(void)
             break;
         }
     }
-    return parsed;
+    return len;
 }
 
 // Private Methods /////////////////////////////////////////////////////////////
@@ -802,6 +802,7 @@ private:
 
     // Buffer parse & GPS state update
     bool        _parse_gps();
+    uint32_t    _parse_span(const uint8_t *buf, uint32_t len, bool &parsed, bool &stop);
 
     // used to update fix between status and position packets
     AP_GPS::GPS_Status next_fix { AP_GPS::NO_FIX };
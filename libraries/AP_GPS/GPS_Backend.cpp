@@ -465,6 +465,36 @@ void AP_GPS_Backend::set_alt_amsl_cm(AP_GPS::GPS_State &_state, int32_t alt_amsl
     }
 }
 
+/*
+  get the next span of received bytes. If the UART can't give us its
+  receive buffer directly we fall back to reading a byte at a time
+ */
+const uint8_t *AP_GPS_Backend::read_span(uint32_t &n)
+{
+    _span = port->read_span(n);
+    _span_copied = false;
+    if (_span == nullptr) {
+        if (!port->read(_span_byte)) {
+            n = 0;
+            return nullptr;
+        }
+        _span = &_span_byte;
+        _span_copied = true;
+        n = 1;
+    }
+    return _span;
+}
+
+void AP_GPS_Backend::consume_span(uint32_t n)
+{
+#if AP_GPS_DEBUG_LOGGING_ENABLED
+    log_data(_span, n);
+#endif
+    if (!_span_copied) {
+        port->read_span_advance(n);
+    }
+}
+
 #if AP_GPS_DEBUG_LOGGING_ENABLED
 
 /*
@@ -171,10 +171,24 @@ protected:
     void log_data(const uint8_t *data, uint16_t length);
 #endif
 
+    /*
+      get the next span of received bytes without copying them out of
+      the UART, see AP_HAL::UARTDriver::read_span(). The bytes used
+      are consumed with consume_span(). UARTs without span support
+      give one byte at a time
+     */
+    const uint8_t *read_span(uint32_t &n);
+    void consume_span(uint32_t n);
+
     // set alt in location, honouring GPS driver option for ellipsoid height
     void set_alt_amsl_cm(AP_GPS::GPS_State &_state, int32_t alt_amsl_cm);
 
 private:
+    // current span from read_span()
+    const uint8_t *_span;
+    uint8_t _span_byte;
+    bool _span_copied;
+
     // itow from previous message
     uint64_t _pseudo_itow;
     int32_t _pseudo_itow_delta_ms;
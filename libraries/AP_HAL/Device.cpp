@@ -17,6 +17,16 @@
 
 #include <stdio.h>
 #include <AP_Common/AP_Common.h>
+#include "Semaphores.h"
+
+#if HAL_DEVICE_STATS_ENABLED
+#include "AP_HAL.h"
+#include <AP_Common/ExpandingString.h>
+#include <AP_Math/AP_Math.h>
+#if HAL_LOGGING_ENABLED
+#include <AP_Logger/AP_Logger.h>
+#endif
+#endif
 
 /*
   using checked registers allows a device check that a set of critical
@@ -55,6 +65,34 @@ bool AP_HAL::Device::setup_checked_registers(uint8_t nregs, uint8_t frequency)
     return true;
 }
 
+/*
+  do a queued transfer straight away. This is used on boards which do
+  not batch transfers in a bus thread
+ */
+bool AP_HAL::Device::queue_transfer(QueuedTransfer &t)
+{
+    t.dev = this;
+    t.next = nullptr;
+    WITH_SEMAPHORE(get_semaphore());
+    run_queued_transfer(t);
+    return true;
+}
+
+/*
+  do a transfer taken from a bus queue and call its completion
+  callback. The callback may queue the descriptor again
+ */
+void AP_HAL::Device::run_queued_transfer(QueuedTransfer &t)
+{
+    const bool ret = transfer(t.send, t.send_len, t.recv, t.recv_len);
+#if HAL_DEVICE_STATS_ENABLED
+    _stats.queued++;
+#endif
+    if (t.cb) {
+        t.cb(ret);
+    }
+}
+
 void AP_HAL::Device::set_device_type(uint8_t devtype) {
     _bus_id.devid_s.devtype = devtype;
 }
@@ -272,3 +310,148 @@ uint8_t AP_HAL::Device::devid_get_devtype(uint32_t dev_id) {
     d.devid = dev_id;
     return d.devid_s.devtype;
 }
+
+#if HAL_DEVICE_STATS_ENABLED
+/*
+  bus usage statistics for each device, reported in @SYS/buses.txt and
+  the BUSD log message
+ */
+AP_HAL::Device *AP_HAL::Device::_stats_devices;
+static HAL_Semaphore stats_sem;
+
+void AP_HAL::Device::stats_register(void)
+{
+    WITH_SEMAPHORE(stats_sem);
+    _stats_next = _stats_devices;
+    _stats_devices = this;
+}
+
+void AP_HAL::Device::stats_unregister(void)
+{
+    WITH_SEMAPHORE(stats_sem);
+    for (Device **d = &_stats_devices; *d != nullptr; d = &(*d)->_stats_next) {
+        if (*d == this) {
+            *d = _stats_next;
+            break;
+        }
+    }
+}
+
+/*
+  upper limit of each lateness histogram bucket
+ */
+uint32_t AP_HAL::Device::stats_late_limit_us(uint8_t bucket)
+{
+    static const uint32_t limits_us[HAL_DEVICE_STATS_LATE_BUCKETS-1] {
+        100, 200, 500, 1000, 2000, 5000, 10000
+    };
+    if (bucket >= ARRAY_SIZE(limits_us)) {
+        return UINT32_MAX;
+    }
+    return limits_us[bucket];
+}
+
+void AP_HAL::Device::stats_transfer(uint32_t len, uint64_t start_us, bool ok)
+{
+    _stats.transfers++;
+    _stats.bytes += len;
+    _stats.busy_us += uint32_t(AP_HAL::micros64() - start_us);
+    if (!ok) {
+        _stats.errors++;
+    }
+}
+
+void AP_HAL::Device::stats_callback(uint32_t late_us)
+{
+    _stats.callbacks++;
+    uint8_t bucket = 0;
+    while (late_us >= stats_late_limit_us(bucket)) {
+        bucket++;
+    }
+    _stats.late_hist[bucket]++;
+    if (late_us > _stats.late_max_us) {
+        _stats.late_max_us = late_us;
+    }
+    if (late_us > _late_max_log_us) {
+        _late_max_log_us = late_us;
+    }
+}
+
+/*
+  rates since the last read and the lateness histogram since boot
+ */
+void AP_HAL::Device::stats_info(ExpandingString &str)
+{
+    static uint32_t last_ms;
+    const uint32_t now_ms = AP_HAL::millis();
+    const uint32_t dt_ms = MAX(now_ms - last_ms, 1U);
+    last_ms = now_ms;
+
+    str.printf("BUSDEVV1\n");
+    WITH_SEMAPHORE(stats_sem);
+    for (Device *d = _stats_devices; d != nullptr; d = d->_stats_next) {
+        const Stats s = d->_stats;
+        Stats &last = d->_stats_info_last;
+        if (s.transfers == 0 && s.callbacks == 0) {
+            continue;
+        }
+        str.printf("%s%u 0x%02x T:%02x XFR:%6lu/s B:%7lu/s UTIL:%5.1f%% ERR:%lu CB:%5lu/s Q:%5lu/s LATE:",
+                   d->bus_type() == BUS_TYPE_I2C ? "I2C" : d->bus_type() == BUS_TYPE_SPI ? "SPI" : "BUS",
+                   unsigned(d->bus_num()), unsigned(d->get_bus_address()),
+                   unsigned(d->_bus_id.devid_s.devtype),
+                   (unsigned long)((s.transfers - last.transfers) * 1000ULL / dt_ms),
+                   (unsigned long)((s.bytes - last.bytes) * 1000ULL / dt_ms),
+                   (s.busy_us - last.busy_us) * 0.1f / dt_ms,
+                   (unsigned long)(s.errors - last.errors),
+                   (unsigned long)((s.callbacks - last.callbacks) * 1000ULL / dt_ms),
+                   (unsigned long)((s.queued - last.queued) * 1000ULL / dt_ms));
+        for (uint8_t i=0; i<HAL_DEVICE_STATS_LATE_BUCKETS; i++) {
+            str.printf(" %lu", (unsigned long)s.late_hist[i]);
+        }
+        str.printf(" MAX:%luus\n", (unsigned long)s.late_max_us);
+        last = s;
+    }
+}
+
+#if HAL_LOGGING_ENABLED
+void AP_HAL::Device::stats_log(void)
+{
+    static uint32_t last_ms;
+    const uint32_t now_ms = AP_HAL::millis();
+    const uint32_t dt_ms = MAX(now_ms - last_ms, 1U);
+    last_ms = now_ms;
+
+    WITH_SEMAPHORE(stats_sem);
+    for (Device *d = _stats_devices; d != nullptr; d = d->_stats_next) {
+        const Stats s = d->_stats;
+        Stats &last = d->_stats_log_last;
+        if (s.transfers == last.transfers && s.callbacks == last.callbacks) {
+            continue;
+        }
+        // callbacks which ran at least 1ms late
+        uint32_t late_1ms = 0;
+        for (uint8_t i=1; i<HAL_DEVICE_STATS_LATE_BUCKETS; i++) {
+            if (stats_late_limit_us(i-1) >= 1000) {
+                late_1ms += s.late_hist[i] - last.late_hist[i];
+            }
+        }
+        const struct log_BUSD pkt {
+            LOG_PACKET_HEADER_INIT(LOG_BUSD_MSG),
+            time_us   : AP_HAL::micros64(),
+            bus_id    : d->get_bus_id(),
+            xfr_rate  : uint16_t(MIN((s.transfers - last.transfers) * 1000ULL / dt_ms, UINT16_MAX)),
+            byte_rate : uint32_t((s.bytes - last.bytes) * 1000ULL / dt_ms),
+            util      : (s.busy_us - last.busy_us) * 0.1f / dt_ms,
+            errors    : uint16_t(MIN(s.errors - last.errors, UINT16_MAX)),
+            cb_rate   : uint16_t(MIN((s.callbacks - last.callbacks) * 1000ULL / dt_ms, UINT16_MAX)),
+            late_max  : d->_late_max_log_us,
+            late_1ms  : uint16_t(MIN(late_1ms, UINT16_MAX)),
+            q_rate    : uint16_t(MIN((s.queued - last.queued) * 1000ULL / dt_ms, UINT16_MAX)),
+        };
+        AP::logger().WriteBlock(&pkt, sizeof(pkt));
+        d->_late_max_log_us = 0;
+        last = s;
+    }
+}
+#endif // HAL_LOGGING_ENABLED
+#endif // HAL_DEVICE_STATS_ENABLED
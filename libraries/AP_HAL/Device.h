@@ -21,12 +21,22 @@
 #include "AP_HAL_Namespace.h"
 #include "utility/functor.h"
 #include "AP_HAL_Boards.h"
+#include <AP_Logger/AP_Logger_config.h>
 
 #if CONFIG_HAL_BOARD != HAL_BOARD_QURT
 // we need utility for std::move, but not on QURT due to a include error in hexagon SDK
 #include <utility>
 #endif
 
+#ifndef HAL_DEVICE_STATS_ENABLED
+#define HAL_DEVICE_STATS_ENABLED (CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX)
+#endif
+
+// number of buckets in the periodic callback lateness histogram
+#define HAL_DEVICE_STATS_LATE_BUCKETS 8
+
+class ExpandingString;
+
 /*
  * This is an interface abstracting I2C and SPI devices
  */
@@ -71,6 +81,9 @@ public:
     Device(enum BusType type)
     {
         _bus_id.devid_s.bus_type = type;
+#if HAL_DEVICE_STATS_ENABLED
+        stats_register();
+#endif
     }
 
     // return bus type
@@ -97,6 +110,9 @@ public:
     void set_device_type(uint8_t devtype);
 
     virtual ~Device() {
+#if HAL_DEVICE_STATS_ENABLED
+        stats_unregister();
+#endif
         delete[] _checked.regs;
     }
 
@@ -125,6 +141,46 @@ public:
                           uint8_t *recv, uint32_t recv_len) = 0;
 
 
+    FUNCTOR_TYPEDEF(TransferCb, void, bool);
+
+    /*
+     * A transfer for #queue_transfer(). The caller owns the descriptor
+     * and the send and receive buffers, which must not be touched until
+     * the completion callback has been called.
+     */
+    struct QueuedTransfer {
+        const uint8_t *send;
+        uint32_t send_len;
+        uint8_t *recv;
+        uint32_t recv_len;
+        // called with the bus semaphore held and the result of the
+        // transfer. The descriptor may be queued again from here
+        TransferCb cb;
+
+        // used by the bus while the transfer is queued
+        Device *dev;
+        QueuedTransfer *next;
+    };
+
+    /*
+     * Queue a transfer to be done by the bus thread. Transfers queued by
+     * all the devices on a bus are done back to back, taking the bus
+     * semaphore (and on some boards the DMA channels) once for the
+     * whole batch rather than once per transfer.
+     *
+     * Boards without a bus thread do the transfer straight away, so the
+     * completion callback may be called before this returns.
+     *
+     * Return: true if the transfer was queued, false otherwise.
+     */
+    virtual bool queue_transfer(QueuedTransfer &t);
+
+    /*
+     * Do a transfer taken from a bus queue and call its completion
+     * callback. Called by the HAL with the bus semaphore held.
+     */
+    void run_queued_transfer(QueuedTransfer &t);
+
     /*
      * Sets the required flags before transaction starts
      * this is to be used by Wide SPI communication interfaces like
@@ -346,6 +402,47 @@ public:
     /* set number of retries on transfers */
     virtual void set_retries(uint8_t retries) {};
 
+#if HAL_DEVICE_STATS_ENABLED
+    /*
+     * Bus usage of this device since boot. Bucket i of late_hist counts
+     * periodic callbacks which ran less than stats_late_limit_us(i) after
+     * they were due, the last bucket counts all later callbacks
+     */
+    struct Stats {
+        uint32_t transfers;
+        uint32_t errors;
+        uint32_t bytes;
+        uint32_t busy_us;
+        uint32_t callbacks;
+        uint32_t queued;
+        uint32_t late_hist[HAL_DEVICE_STATS_LATE_BUCKETS];
+        uint32_t late_max_us;
+    };
+    const Stats &get_stats() const { return _stats; }
+
+    static uint32_t stats_late_limit_us(uint8_t bucket);
+
+    /*
+     * Record a transfer of len bytes which started at start_us. Called
+     * by the HAL from transfer() with the bus semaphore held
+     */
+    void stats_transfer(uint32_t len, uint64_t start_us, bool ok);
+
+    /*
+     * Record a periodic callback which ran late_us after it was due.
+     * Called by the HAL from the bus thread
+     */
+    void stats_callback(uint32_t late_us);
+
+    // bus usage of all devices for @SYS/buses.txt
+    static void stats_info(ExpandingString &str);
+
+#if HAL_LOGGING_ENABLED
+    // log bus usage of all devices since the last call
+    static void stats_log(void);
+#endif
+#endif // HAL_DEVICE_STATS_ENABLED
+
 protected:
     uint8_t _read_flag = 0;
 
@@ -380,6 +477,20 @@ protected:
     }
 
 private:
+#if HAL_DEVICE_STATS_ENABLED
+    void stats_register(void);
+    void stats_unregister(void);
+
+    Stats _stats;
+    // snapshots at the last @SYS read and the last log
+    Stats _stats_info_last;
+    Stats _stats_log_last;
+    uint32_t _late_max_log_us;
+    // list of all devices
+    Device *_stats_next;
+    static Device *_stats_devices;
+#endif
+
     BankSelectCb _bank_select;
     RegisterRWCb _register_rw_callback;
     struct {
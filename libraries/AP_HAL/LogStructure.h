@@ -2,9 +2,11 @@
 
 #include <AP_Logger/LogStructure.h>
 #include "UARTDriver.h"
+#include "Device.h"
 
 #define LOG_IDS_FROM_HAL \
-    LOG_UART_MSG
+    LOG_UART_MSG, \
+    LOG_BUSD_MSG
 
 // @LoggerMessage: UART
 // @Description: UART stats
@@ -20,10 +22,48 @@ struct PACKED log_UART {
     float rx_rate;
 };
 
+// @LoggerMessage: BUSD
+// @Description: I2C and SPI device bus usage
+// @Field: TimeUS: Time since system startup
+// @Field: Id: bus ID of the device
+// @Field: Xfr: transfers per second
+// @Field: BR: bytes transferred per second
+// @Field: Util: percentage of time spent in transfers
+// @Field: Err: failed transfers since the last message
+// @Field: Cb: periodic callbacks per second
+// @Field: LMx: largest periodic callback lateness since the last message
+// @Field: L1: periodic callbacks at least 1ms late since the last message
+// @Field: Q: queued transfers per second
+struct PACKED log_BUSD {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint32_t bus_id;
+    uint16_t xfr_rate;
+    uint32_t byte_rate;
+    float util;
+    uint16_t errors;
+    uint16_t cb_rate;
+    uint32_t late_max;
+    uint16_t late_1ms;
+    uint16_t q_rate;
+};
+
 #if !HAL_UART_STATS_ENABLED
-#define LOG_STRUCTURE_FROM_HAL
+#define LOG_STRUCTURE_FROM_HAL_UART
 #else
-#define LOG_STRUCTURE_FROM_HAL                          \
+#define LOG_STRUCTURE_FROM_HAL_UART                     \
     { LOG_UART_MSG, sizeof(log_UART),                   \
       "UART","QBff","TimeUS,I,Tx,Rx", "s#BB", "F---" },
 #endif
+
+#if !HAL_DEVICE_STATS_ENABLED
+#define LOG_STRUCTURE_FROM_HAL_DEVICE
+#else
+#define LOG_STRUCTURE_FROM_HAL_DEVICE                   \
+    { LOG_BUSD_MSG, sizeof(log_BUSD),                   \
+      "BUSD","QIHIfHHIHH","TimeUS,Id,Xfr,BR,Util,Err,Cb,LMx,L1,Q", "s-zB%-zs-z", "F-00000F00" },
+#endif
+
+#define LOG_STRUCTURE_FROM_HAL                          \
+    LOG_STRUCTURE_FROM_HAL_UART                         \
+    LOG_STRUCTURE_FROM_HAL_DEVICE
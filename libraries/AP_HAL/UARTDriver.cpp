@@ -121,6 +121,49 @@ int16_t AP_HAL::UARTDriver::read(void)
     return b;
 }
 
+const uint8_t *AP_HAL::UARTDriver::read_span(uint32_t &n)
+{
+    if (lock_read_key != 0) {
+        n = 0;
+        return nullptr;
+    }
+    return _read_span(n);
+}
+
+bool AP_HAL::UARTDriver::read_span_advance(uint32_t n)
+{
+    if (lock_read_key != 0) {
+        return false;
+    }
+#if AP_UART_MONITOR_ENABLED
+    auto monitor = _monitor_read_buffer;
+    if (monitor != nullptr) {
+        uint32_t len;
+        const uint8_t *span = _read_span(len);
+        if (span != nullptr) {
+            monitor->write(span, MIN(n, len));
+        }
+    }
+#endif
+    return _read_span_advance(n);
+}
+
+uint8_t AP_HAL::UARTDriver::write_reserve(ByteBuffer::IoVec vec[2], uint32_t len)
+{
+    if (lock_write_key != 0 || len == 0) {
+        return 0;
+    }
+    return _write_reserve(vec, len);
+}
+
+bool AP_HAL::UARTDriver::write_commit(uint32_t len)
+{
+    if (lock_write_key != 0) {
+        return false;
+    }
+    return _write_commit(len);
+}
+
 
 uint32_t AP_HAL::UARTDriver::available()
 {
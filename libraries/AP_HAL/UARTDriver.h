@@ -4,6 +4,7 @@
 
 #include "AP_HAL_Namespace.h"
 #include "utility/BetterStream.h"
+#include "utility/RingBuffer.h"
 #include <AP_Logger/AP_Logger_config.h>
 
 #ifndef HAL_UART_STATS_ENABLED
@@ -15,7 +16,6 @@
 #endif
 
 class ExpandingString;
-class ByteBuffer;
 
 /* Pure virtual UARTDriver class */
 class AP_HAL::UARTDriver : public AP_HAL::BetterStream {
@@ -55,6 +55,28 @@ public:
     int16_t read(void) override;
     bool read(uint8_t &b) override WARN_IF_UNUSED;
     ssize_t read(uint8_t *buffer, uint16_t count) override;
+
+    /*
+      zero copy reads. read_span() returns the next contiguous block
+      of received bytes in the receive buffer and sets n to its
+      length, without consuming them. Bytes are consumed with
+      read_span_advance(). Returns nullptr if there is no data or the
+      driver does not support spans, in which case use read()
+     */
+    const uint8_t *read_span(uint32_t &n) WARN_IF_UNUSED;
+    bool read_span_advance(uint32_t n);
+
+    /*
+      zero copy writes. write_reserve() reserves len bytes in the
+      transmit buffer, returning the number of spans (one or two) to
+      fill. write_commit() must then be called to queue the bytes for
+      transmit, and no other writes may be made to the port in
+      between. The reservation is all or nothing, returning 0 if there
+      isn't room or the driver doesn't support it, in which case use
+      write()
+     */
+    uint8_t write_reserve(ByteBuffer::IoVec vec[2], uint32_t len) WARN_IF_UNUSED;
+    bool write_commit(uint32_t len);
     
     void end();
     void flush();
@@ -236,6 +258,20 @@ protected:
      */
     virtual ssize_t _read(uint8_t *buffer, uint16_t count)  WARN_IF_UNUSED = 0;
 
+    /*
+      backend span read methods, only for drivers with a contiguous
+      receive buffer
+     */
+    virtual const uint8_t *_read_span(uint32_t &n) { n = 0; return nullptr; }
+    virtual bool _read_span_advance(uint32_t n) { return false; }
+
+    /*
+      backend span write methods, _write_commit() is only called after
+      a successful _write_reserve()
+     */
+    virtual uint8_t _write_reserve(ByteBuffer::IoVec vec[2], uint32_t len) { return 0; }
+    virtual bool _write_commit(uint32_t len) { return false; }
+
     /*
       end control of the port, freeing buffers
      */
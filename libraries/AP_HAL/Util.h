@@ -196,6 +196,14 @@ public:
     // request information on timer frequencies
     virtual void timer_info(ExpandingString &str) {}
 
+    // request information on I2C and SPI bus utilisation
+    virtual void bus_info(ExpandingString &str) {}
+
+#if HAL_LOGGING_ENABLED
+    // log I2C and SPI bus utilisation
+    virtual void bus_log() {}
+#endif
+
     // generate Random values
     virtual bool get_random_vals(uint8_t* data, size_t size) { return false; }
 
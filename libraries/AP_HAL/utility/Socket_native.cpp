@@ -11,6 +11,48 @@
 #define IN_SOCKET_NATIVE_CPP
 #define SOCKET_CLASS_NAME SocketAPM_native
 #include "Socket.cpp"
+
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <AP_Math/AP_Math.h>
+
+/*
+  Datagrams bigger than SOCKET_RECV_BATCH_SLOT_SIZE only fit in the
+  first slot, which takes any space left over from the others
+ */
+ssize_t socket_recv_datagrams(int fd, uint8_t *buf, uint32_t space)
+{
+#if defined(__linux__)
+    const uint8_t nslots = MIN(space / SOCKET_RECV_BATCH_SLOT_SIZE, SOCKET_RECV_BATCH_MAX);
+    if (nslots > 1) {
+        struct mmsghdr msgs[SOCKET_RECV_BATCH_MAX] {};
+        struct iovec iov[SOCKET_RECV_BATCH_MAX];
+        uint32_t ofs = 0;
+        for (uint8_t i = 0; i < nslots; i++) {
+            iov[i].iov_base = buf + ofs;
+            iov[i].iov_len = i == 0 ? space - (nslots - 1) * SOCKET_RECV_BATCH_SLOT_SIZE : SOCKET_RECV_BATCH_SLOT_SIZE;
+            ofs += iov[i].iov_len;
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        const int ret = recvmmsg(fd, msgs, nslots, MSG_DONTWAIT, nullptr);
+        if (ret <= 0) {
+            return ret;
+        }
+        // close the gaps left by datagrams shorter than their slot
+        ssize_t nread = 0;
+        for (int i = 0; i < ret; i++) {
+            if (iov[i].iov_base != buf + nread) {
+                memmove(buf + nread, iov[i].iov_base, msgs[i].msg_len);
+            }
+            nread += msgs[i].msg_len;
+        }
+        return nread;
+    }
+#endif
+    return ::recv(fd, buf, space, MSG_DONTWAIT);
+}
 #endif
 
 #endif
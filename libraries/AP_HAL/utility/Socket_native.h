@@ -12,6 +12,19 @@
 #define AP_NETWORKING_SOCKETS_ENABLED 1
 #endif
 #include "Socket.hpp"
+
+#include <sys/types.h>
+
+// datagrams read per socket_recv_datagrams() call and space reserved for each
+#define SOCKET_RECV_BATCH_MAX       8
+#define SOCKET_RECV_BATCH_SLOT_SIZE 2048
+
+/*
+  read all queued datagrams on a non-blocking datagram socket, packed
+  into buf, returning the total length. On Linux this is one
+  recvmmsg() call, elsewhere one datagram per call
+ */
+ssize_t socket_recv_datagrams(int fd, uint8_t *buf, uint32_t space);
 #elif !AP_SIM_ENABLED
 #error "attempt to use Socket_native.h without native sockets"
 #endif
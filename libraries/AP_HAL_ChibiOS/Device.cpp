@@ -26,6 +26,9 @@
 #include "Semaphores.h"
 #include "Util.h"
 #include "hwdef/common/stm32_util.h"
+#if !defined(HAL_BOOTLOADER_BUILD)
+#include <AP_Common/ExpandingString.h>
+#endif
 
 #ifndef HAL_DEVICE_THREAD_STACK
 #define HAL_DEVICE_THREAD_STACK 1024
@@ -35,11 +38,18 @@ using namespace ChibiOS;
 
 extern const AP_HAL::HAL& hal;
 
+// wakes the bus thread when a transfer is queued
+#define EVT_TRANSFER_QUEUED EVENT_MASK(0)
+
+DeviceBus *DeviceBus::all_buses;
+
 DeviceBus::DeviceBus(uint8_t _thread_priority) :
         thread_priority(_thread_priority)
 {
     bouncebuffer_init(&bounce_buffer_tx, 10, false);
     bouncebuffer_init(&bounce_buffer_rx, 10, false);
+    next_bus = all_buses;
+    all_buses = this;
 }
 
 DeviceBus::DeviceBus(uint8_t _thread_priority, bool axi_sram) :
@@ -47,6 +57,8 @@ DeviceBus::DeviceBus(uint8_t _thread_priority, bool axi_sram) :
 {
     bouncebuffer_init(&bounce_buffer_tx, 10, axi_sram);
     bouncebuffer_init(&bounce_buffer_rx, 10, axi_sram);
+    next_bus = all_buses;
+    all_buses = this;
 }
 
 /*
@@ -72,6 +84,8 @@ void DeviceBus::bus_thread(void *arg)
             }
         }
 
+        binfo->run_queued_transfers();
+
         // work out when next loop is needed
         uint64_t next_needed = 0;
         now = AP_HAL::micros64();
@@ -96,47 +110,102 @@ void DeviceBus::bus_thread(void *arg)
         if (delay < 100) {
             delay = 100;
         }
-        hal.scheduler->delay_microseconds(delay);
+        // wait for the next callback or a queued transfer
+        sysinterval_t ticks = chTimeUS2I(delay);
+        if (ticks < CH_CFG_ST_TIMEDELTA) {
+            ticks = CH_CFG_ST_TIMEDELTA;
+        }
+        if (ticks == 0) {
+            // a zero timeout would not wait at all
+            ticks = 1;
+        }
+        chEvtWaitAnyTimeout(EVT_TRANSFER_QUEUED, ticks);
     }
     return;
 }
 
+/*
+  do all the queued transfers back to back, with the bus semaphore
+  taken once. Transfers queued while we run are left for the next loop
+*/
+void DeviceBus::run_queued_transfers(void)
+{
+    chSysLock();
+    AP_HAL::Device::QueuedTransfer *t = queue_head;
+    queue_head = nullptr;
+    queue_tail = nullptr;
+    chSysUnlock();
+
+    if (t == nullptr) {
+        return;
+    }
+
+    WITH_SEMAPHORE(semaphore);
+    if (batch_dma && dma_handle != nullptr) {
+        dma_handle->lock();
+        dma_held = true;
+    }
+    stats.batches++;
+    while (t != nullptr) {
+        // the callback may queue the descriptor again
+        AP_HAL::Device::QueuedTransfer *next = t->next;
+        t->dev->run_queued_transfer(*t);
+        stats.queued++;
+        t = next;
+    }
+    if (dma_held) {
+        dma_held = false;
+        dma_handle->unlock();
+    }
+}
+
 #if CH_CFG_USE_HEAP == TRUE
-AP_HAL::Device::PeriodicHandle DeviceBus::register_periodic_callback(uint32_t period_usec, AP_HAL::Device::PeriodicCb cb, AP_HAL::Device *_hal_device)
+/*
+  start the bus thread if it is not already running
+*/
+void DeviceBus::start_thread(AP_HAL::Device *_hal_device)
 {
-    if (!thread_started) {
-        thread_started = true;
-
-        hal_device = _hal_device;
-        // setup a name for the thread
-        const uint8_t name_len = 7;
-        char *name = (char *)malloc(name_len);
-        if (name == nullptr){
-            return nullptr;
-        }
+    // a transfer may be queued from another thread while we create
+    // the bus thread, so thread_started is only set once thread_ctx
+    // is valid for chEvtSignal(). Drivers normally queue from the bus
+    // thread with the semaphore already held, so this is cheap
+    WITH_SEMAPHORE(semaphore);
+    if (thread_started) {
+        return;
+    }
+
+    hal_device = _hal_device;
+    // setup a name for the thread
+    if (name[0] == 0) {
         switch (hal_device->bus_type()) {
         case AP_HAL::Device::BUS_TYPE_I2C:
-            snprintf(name, name_len, "I2C%u",
+            snprintf(name, sizeof(name), "I2C%u",
                      hal_device->bus_num());
             break;
 
         case AP_HAL::Device::BUS_TYPE_SPI:
-            snprintf(name, name_len, "SPI%u",
+            snprintf(name, sizeof(name), "SPI%u",
                      hal_device->bus_num());
             break;
         default:
             break;
         }
+    }
 
-        thread_ctx = thread_create_alloc(THD_WORKING_AREA_SIZE(HAL_DEVICE_THREAD_STACK),
-                                         name,
-                                         thread_priority,           /* Initial priority.    */
-                                         DeviceBus::bus_thread,    /* Thread function.     */
-                                         this);                     /* Thread parameter.    */
-        if (thread_ctx == nullptr) {
-            AP_HAL::panic("Failed to create bus thread %s", name);
-        }
+    thread_ctx = thread_create_alloc(THD_WORKING_AREA_SIZE(HAL_DEVICE_THREAD_STACK),
+                                     name,
+                                     thread_priority,           /* Initial priority.    */
+                                     DeviceBus::bus_thread,    /* Thread function.     */
+                                     this);                     /* Thread parameter.    */
+    if (thread_ctx == nullptr) {
+        AP_HAL::panic("Failed to create bus thread %s", name);
     }
+    thread_started = true;
+}
+
+AP_HAL::Device::PeriodicHandle DeviceBus::register_periodic_callback(uint32_t period_usec, AP_HAL::Device::PeriodicCb cb, AP_HAL::Device *_hal_device)
+{
+    start_thread(_hal_device);
     DeviceBus::callback_info *callback = NEW_NOTHROW DeviceBus::callback_info;
     if (callback == nullptr) {
         return nullptr;
@@ -151,6 +220,29 @@ AP_HAL::Device::PeriodicHandle DeviceBus::register_periodic_callback(uint32_t pe
 
     return callback;
 }
+
+/*
+  add a transfer to the queue for the bus thread
+*/
+bool DeviceBus::queue_transfer(AP_HAL::Device::QueuedTransfer &t, AP_HAL::Device *_hal_device)
+{
+    start_thread(_hal_device);
+    t.dev = _hal_device;
+    t.next = nullptr;
+
+    chSysLock();
+    if (queue_tail != nullptr) {
+        queue_tail->next = &t;
+    } else {
+        queue_head = &t;
+    }
+    queue_tail = &t;
+    chSysUnlock();
+
+    chEvtSignal(thread_ctx, EVT_TRANSFER_QUEUED);
+
+    return true;
+}
 #endif // CH_CFG_USE_HEAP
 
 /*
@@ -171,6 +263,43 @@ bool DeviceBus::adjust_timer(AP_HAL::Device::PeriodicHandle h, uint32_t period_u
     return true;
 }
 
+#if !defined(HAL_BOOTLOADER_BUILD)
+/*
+  report utilisation of each bus since the last call
+ */
+void DeviceBus::bus_info(ExpandingString &str)
+{
+    const uint32_t now_ms = AP_HAL::millis();
+    str.printf("BUSV1\n");
+    for (DeviceBus *b = all_buses; b != nullptr; b = b->next_bus) {
+        if (b->name[0] == 0) {
+            continue;
+        }
+        // not worth waiting for the bus semaphore, a torn copy
+        // only skews one report
+        const struct bus_stats s = b->stats;
+        uint32_t dt_ms = now_ms - b->last_info_ms;
+        if (dt_ms == 0) {
+            dt_ms = 1;
+        }
+        const uint32_t transfers = s.transfers - b->last_stats.transfers;
+        const uint32_t bytes = s.bytes - b->last_stats.bytes;
+        const uint32_t busy_us = s.busy_us - b->last_stats.busy_us;
+        const uint32_t queued = s.queued - b->last_stats.queued;
+        const uint32_t batches = s.batches - b->last_stats.batches;
+        str.printf("%-5s XFR:%7lu/s B:%8lu/s UTIL:%5.1f%% Q:%6lu/s BATCH:%5.1f\n",
+                   b->name,
+                   (unsigned long)(transfers * 1000ULL / dt_ms),
+                   (unsigned long)(bytes * 1000ULL / dt_ms),
+                   busy_us * 0.1f / dt_ms,
+                   (unsigned long)(queued * 1000ULL / dt_ms),
+                   batches > 0 ? float(queued) / batches : 0.0f);
+        b->last_stats = s;
+        b->last_info_ms = now_ms;
+    }
+}
+#endif // HAL_BOOTLOADER_BUILD
+
 /*
   setup to use DMA-safe bouncebuffers for device transfers
  */
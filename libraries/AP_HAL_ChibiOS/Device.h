@@ -47,12 +47,39 @@ public:
 
     AP_HAL::Device::PeriodicHandle register_periodic_callback(uint32_t period_usec, AP_HAL::Device::PeriodicCb, AP_HAL::Device *hal_device);
     bool adjust_timer(AP_HAL::Device::PeriodicHandle h, uint32_t period_usec);
+    bool queue_transfer(AP_HAL::Device::QueuedTransfer &t, AP_HAL::Device *hal_device);
     static void bus_thread(void *arg);
 
     bool bouncebuffer_setup(const uint8_t *&buf_tx, uint16_t tx_len,
                             uint8_t *&buf_rx, uint16_t rx_len) WARN_IF_UNUSED;
     void bouncebuffer_finish(const uint8_t *buf_tx, uint8_t *buf_rx, uint16_t rx_len);
 
+    // name of the bus thread and in @SYS/buses.txt, eg. "SPI1"
+    char name[7];
+
+    // keep the DMA channels locked for a batch of queued transfers
+    bool batch_dma;
+    bool dma_held;
+
+    // bus utilisation, updated with the bus semaphore held
+    struct bus_stats {
+        uint32_t transfers;
+        uint32_t bytes;
+        uint32_t busy_us;
+        uint32_t queued;
+        uint32_t batches;
+    } stats;
+
+    // record a transfer of len bytes which started at start_us
+    void transfer_done(uint32_t len, uint32_t start_us) {
+        stats.transfers++;
+        stats.bytes += len;
+        stats.busy_us += AP_HAL::micros() - start_us;
+    }
+
+    // @SYS/buses.txt
+    static void bus_info(ExpandingString &str);
+
 private:
     struct callback_info {
         struct callback_info *next;
@@ -65,6 +92,19 @@ private:
     bool thread_started;
     AP_HAL::Device *hal_device;
 
+    void start_thread(AP_HAL::Device *_hal_device);
+
+    // transfers waiting for the bus thread
+    AP_HAL::Device::QueuedTransfer *queue_head;
+    AP_HAL::Device::QueuedTransfer *queue_tail;
+    void run_queued_transfers(void);
+
+    // all buses, for @SYS/buses.txt
+    static DeviceBus *all_buses;
+    DeviceBus *next_bus;
+    struct bus_stats last_stats;
+    uint32_t last_info_ms;
+
     // support for bounce buffers for DMA-safe transfers
     struct bouncebuffer_t *bounce_buffer_tx;
     struct bouncebuffer_t *bounce_buffer_rx;
@@ -201,6 +201,7 @@ I2CDeviceManager::I2CDeviceManager(void)
 {
     for (uint8_t i=0; i<ARRAY_SIZE(I2CD); i++) {
         businfo[i].busnum = i;
+        snprintf(businfo[i].name, sizeof(businfo[i].name), "I2C%u", i);
         businfo[i].dma_init();
         /*
           setup default I2C config. As each device is opened we will
@@ -369,6 +370,8 @@ bool I2CDevice::_transfer(const uint8_t *send, uint32_t send_len,
         return false;
     }
 
+    const uint32_t start_us = AP_HAL::micros();
+
     for(uint8_t i=0 ; i <= _retries; i++) {
         int ret;
         // calculate a timeout as twice the expected transfer time, and set as min of 4ms
@@ -412,6 +415,7 @@ bool I2CDevice::_transfer(const uint8_t *send, uint32_t send_len,
         if (ret == MSG_OK) {
             bus.bouncebuffer_finish(send, recv, recv_len);
             i2cReleaseBus(I2CD[bus.busnum].i2c);
+            bus.transfer_done(send_len + recv_len, start_us);
             return true;
         }
 #if HAL_I2C_CLEAR_ON_TIMEOUT
@@ -422,6 +426,7 @@ bool I2CDevice::_transfer(const uint8_t *send, uint32_t send_len,
     }
     bus.bouncebuffer_finish(send, recv, recv_len);
     i2cReleaseBus(I2CD[bus.busnum].i2c);
+    bus.transfer_done(send_len + recv_len, start_us);
     return false;
 }
 
@@ -449,6 +454,11 @@ bool I2CDevice::adjust_periodic_callback(AP_HAL::Device::PeriodicHandle h, uint3
     return bus.adjust_timer(h, period_usec);
 }
 
+bool I2CDevice::queue_transfer(AP_HAL::Device::QueuedTransfer &t)
+{
+    return bus.queue_transfer(t, this);
+}
+
 AP_HAL::OwnPtr<AP_HAL::I2CDevice>
 I2CDeviceManager::get_device(uint8_t bus, uint8_t address,
                              uint32_t bus_clock,
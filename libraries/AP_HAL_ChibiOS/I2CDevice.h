@@ -89,6 +89,9 @@ public:
     /* See AP_HAL::Device::adjust_periodic_callback() */
     bool adjust_periodic_callback(AP_HAL::Device::PeriodicHandle h, uint32_t period_usec) override;
 
+    /* See AP_HAL::Device::queue_transfer() */
+    bool queue_transfer(AP_HAL::Device::QueuedTransfer &t) override;
+
     AP_HAL::Semaphore* get_semaphore() override {
         // if asking for invalid bus number use bus 0 semaphore
         return &bus.semaphore;
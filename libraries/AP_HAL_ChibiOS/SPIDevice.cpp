@@ -87,6 +87,11 @@ SPIBus::SPIBus(uint8_t _bus) :
                                 FUNCTOR_BIND_MEMBER(&SPIBus::dma_allocate, void, Shared_DMA *),
                                 FUNCTOR_BIND_MEMBER(&SPIBus::dma_deallocate, void, Shared_DMA *));
 
+    snprintf(name, sizeof(name), "SPI%u", spi_devices[bus].busid);
+
+    // keep the DMA channels for a whole batch of queued transfers
+    batch_dma = true;
+
     // remember the SCK line for stop_peripheral()/start_peripheral()
 #if HAL_SPI_SCK_SAVE_RESTORE
     sck_mode = palReadLineMode(spi_devices[bus].sck_line);
@@ -180,6 +185,7 @@ bool SPIDevice::do_transfer(const uint8_t *send, uint8_t *recv, uint32_t len)
     }
 
     bool ret = true;
+    const uint32_t start_us = AP_HAL::micros();
 
 #if defined(HAL_SPI_USE_POLLED)
     for (uint32_t i=0; i<len; i++) {
@@ -219,6 +225,7 @@ bool SPIDevice::do_transfer(const uint8_t *send, uint8_t *recv, uint32_t len)
     bus.bouncebuffer_finish(send, recv, len);
 #endif
     set_chip_select(old_cs_forced);
+    bus.transfer_done(len, start_us);
     return ret;
 }
 
@@ -341,6 +348,11 @@ bool SPIDevice::adjust_periodic_callback(AP_HAL::Device::PeriodicHandle h, uint3
     return bus.adjust_timer(h, period_usec);
 }
 
+bool SPIDevice::queue_transfer(AP_HAL::Device::QueuedTransfer &t)
+{
+    return bus.queue_transfer(t, this);
+}
+
 /*
   stop the SPI peripheral and set the SCK line as a GPIO to prevent the clock
   line floating while we are waiting for the next spiStart()
@@ -403,9 +415,13 @@ bool SPIDevice::acquire_bus(bool set, bool skip_cs)
         }
         spiReleaseBus(spi_devices[device_desc.bus].driver);              /* Ownership release.               */
         cs_forced = false;
-        bus.dma_handle->unlock();
+        if (!bus.dma_held) {
+            bus.dma_handle->unlock();
+        }
     } else {
-        bus.dma_handle->lock();
+        if (!bus.dma_held) {
+            bus.dma_handle->lock();
+        }
         spiAcquireBus(spi_devices[device_desc.bus].driver);              /* Acquire ownership of the bus.    */
         bus.spicfg.ssport = PAL_PORT(device_desc.pal_line);
         bus.spicfg.sspad = PAL_PAD(device_desc.pal_line);
@@ -22,6 +22,7 @@
 #include "Scheduler.h"
 #include "hwdef/common/flash.h"
 #include <AP_Filesystem/AP_Filesystem.h>
+#include <AP_Common/ExpandingString.h>
 #include <stdio.h>
 
 using namespace ChibiOS;
@@ -220,6 +221,8 @@ void Storage::_mark_dirty(uint16_t loc, uint16_t length)
          line++) {
         _dirty_mask.set(line);
     }
+    _last_dirty_ms = AP_HAL::millis();
+    _write_bytes += length;
 }
 
 void Storage::read_block(void *dst, uint16_t loc, size_t n)
@@ -249,13 +252,33 @@ void Storage::_timer_tick(void)
     if (_initialisedType == StorageBackend::None) {
         return;
     }
+    const uint32_t now_ms = AP_HAL::millis();
     if (_dirty_mask.empty()) {
-        _last_empty_ms = AP_HAL::millis();
+        _last_empty_ms = now_ms;
+#ifdef STORAGE_FLASH_PAGE
+        // with nothing to write, continue copying storage to the
+        // new flash sector after a sector switch a few blocks at a
+        // time, so that a full sector switch is rarely needed
+        if (_initialisedType == StorageBackend::Flash && _flash.compact_pending()) {
+            EXPECT_DELAY_MS(1);
+            IGNORE_RETURN(_flash.compact_step());
+        }
+#endif
+        return;
+    }
+
+#ifdef STORAGE_FLASH_PAGE
+    // let a burst of changes finish so it can be coalesced, the
+    // oldest dirty line was changed after _last_empty_ms
+    if (_initialisedType == StorageBackend::Flash &&
+        now_ms - _last_dirty_ms < CH_STORAGE_FLUSH_IDLE_MS &&
+        now_ms - _last_empty_ms < CH_STORAGE_FLUSH_MAX_DELAY_MS) {
         return;
     }
+#endif
 
-    // write out the first dirty line. We don't write more
-    // than one to keep the latency of this call to a minimum
+    // write out the first run of dirty lines. We don't write more
+    // than one run to keep the latency of this call to a minimum
     uint16_t i;
     for (i=0; i<CH_STORAGE_NUM_LINES; i++) {
         if (_dirty_mask.get(i)) {
@@ -266,18 +289,26 @@ void Storage::_timer_tick(void)
         // this shouldn't be possible
         return;
     }
+    uint16_t num_lines = 1;
+    while (num_lines < CH_STORAGE_FLUSH_MAX_LINES &&
+           i+num_lines < CH_STORAGE_NUM_LINES &&
+           _dirty_mask.get(i+num_lines)) {
+        num_lines++;
+    }
+    const uint32_t offset = CH_STORAGE_LINE_SIZE*i;
+    const uint16_t length = CH_STORAGE_LINE_SIZE*num_lines;
 
     {
-        // take a copy of the line we are writing with a semaphore held
+        // take a copy of the lines we are writing with a semaphore held
         WITH_SEMAPHORE(sem);
-        memcpy(tmpline, &_buffer[CH_STORAGE_LINE_SIZE*i], CH_STORAGE_LINE_SIZE);
+        memcpy(tmpline, &_buffer[offset], length);
     }
 
     bool write_ok = false;
 
 #if HAL_WITH_RAMTRON
     if (_initialisedType == StorageBackend::FRAM) {
-        if (fram.write(CH_STORAGE_LINE_SIZE*i, tmpline, CH_STORAGE_LINE_SIZE)) {
+        if (fram.write(offset, tmpline, length)) {
             write_ok = true;
         }
     }
@@ -285,11 +316,10 @@ void Storage::_timer_tick(void)
 
 #ifdef USE_POSIX
     if ((_initialisedType == StorageBackend::SDCard) && log_fd != -1) {
-        uint32_t offset = CH_STORAGE_LINE_SIZE*i;
         if (AP::FS().lseek(log_fd, offset, SEEK_SET) != offset) {
             return;
         }
-        if (AP::FS().write(log_fd, &_buffer[offset], CH_STORAGE_LINE_SIZE) != CH_STORAGE_LINE_SIZE) {
+        if (AP::FS().write(log_fd, &_buffer[offset], length) != length) {
             return;
         }
         if (AP::FS().fsync(log_fd) != 0) {
@@ -302,7 +332,7 @@ void Storage::_timer_tick(void)
 #ifdef STORAGE_FLASH_PAGE
     if (_initialisedType == StorageBackend::Flash) {
         // save to storage backend
-        if (_flash_write(i)) {
+        if (_flash_write(i, num_lines)) {
             write_ok = true;
         }
     }
@@ -310,14 +340,17 @@ void Storage::_timer_tick(void)
 
     if (write_ok) {
         WITH_SEMAPHORE(sem);
-        // while holding the semaphore we check if the copy of the
+        // while holding the semaphore we check if the copy of each
         // line is different from the original line. If it is
         // different then someone has re-dirtied the line while we
         // were writing it, in which case we should not mark it
         // clean. If it matches then we know we can mark the line as
         // clean
-        if (memcmp(tmpline, &_buffer[CH_STORAGE_LINE_SIZE*i], CH_STORAGE_LINE_SIZE) == 0) {
-            _dirty_mask.clear(i);
+        for (uint16_t n=0; n<num_lines; n++) {
+            const uint16_t line_ofs = CH_STORAGE_LINE_SIZE*n;
+            if (memcmp(&tmpline[line_ofs], &_buffer[offset+line_ofs], CH_STORAGE_LINE_SIZE) == 0) {
+                _dirty_mask.clear(i+n);
+            }
         }
     }
 }
@@ -345,13 +378,13 @@ void Storage::_flash_load(void)
 }
 
 /*
-  write one storage line. This also updates _dirty_mask.
+  write num_lines storage lines starting at line
 */
-bool Storage::_flash_write(uint16_t line)
+bool Storage::_flash_write(uint16_t line, uint16_t num_lines)
 {
 #ifdef STORAGE_FLASH_PAGE
     EXPECT_DELAY_MS(1);
-    return _flash.write(line*CH_STORAGE_LINE_SIZE, CH_STORAGE_LINE_SIZE);
+    return _flash.write(line*CH_STORAGE_LINE_SIZE, num_lines*CH_STORAGE_LINE_SIZE);
 #else
     return false;
 #endif
@@ -505,5 +538,19 @@ bool Storage::get_storage_ptr(void *&ptr, size_t &size)
     return true;
 }
 
+/*
+  report storage write statistics. Write amplification is bytes
+  written to flash per byte changed by callers
+ */
+void Storage::storage_info(ExpandingString &str)
+{
+    str.printf("Written: %u bytes\n", unsigned(_write_bytes));
+#ifdef STORAGE_FLASH_PAGE
+    if (_initialisedType == StorageBackend::Flash) {
+        _flash.stats_info(str, _write_bytes);
+    }
+#endif
+}
+
 
 #endif // HAL_USE_EMPTY_STORAGE
@@ -47,6 +47,29 @@
 static_assert(CH_STORAGE_SIZE % CH_STORAGE_LINE_SIZE == 0,
               "Storage is not multiple of line size");
 
+/*
+  contiguous dirty lines are written out together, up to this many
+  bytes at a time. When writing to flash we also wait until storage
+  has not been changed for CH_STORAGE_FLUSH_IDLE_MS, but never hold
+  dirty lines for more than CH_STORAGE_FLUSH_MAX_DELAY_MS. This turns
+  a burst of small changes, such as a parameter save, into a few
+  larger flash blocks with less header overhead and fewer compactions
+ */
+#ifndef CH_STORAGE_FLUSH_MAX_BYTES
+#define CH_STORAGE_FLUSH_MAX_BYTES 64
+#endif
+#ifndef CH_STORAGE_FLUSH_IDLE_MS
+#define CH_STORAGE_FLUSH_IDLE_MS 100
+#endif
+#ifndef CH_STORAGE_FLUSH_MAX_DELAY_MS
+#define CH_STORAGE_FLUSH_MAX_DELAY_MS 500
+#endif
+#if CH_STORAGE_FLUSH_MAX_BYTES > CH_STORAGE_LINE_SIZE
+#define CH_STORAGE_FLUSH_MAX_LINES (CH_STORAGE_FLUSH_MAX_BYTES/CH_STORAGE_LINE_SIZE)
+#else
+#define CH_STORAGE_FLUSH_MAX_LINES 1
+#endif
+
 /*
   on boards with 8k sector sizes we double up to treat pairs of sectors as one
  */
@@ -64,6 +87,7 @@ public:
     void _timer_tick(void) override;
     bool healthy(void) override;
     bool get_storage_ptr(void *&ptr, size_t &size) override;
+    void storage_info(ExpandingString &str) override;
 
 private:
     enum class StorageBackend: uint8_t {
@@ -80,7 +104,9 @@ private:
     uint8_t _buffer[CH_STORAGE_SIZE] __attribute__((aligned(4)));
     Bitmask<CH_STORAGE_NUM_LINES> _dirty_mask;
     HAL_Semaphore sem;
-    uint8_t tmpline[CH_STORAGE_LINE_SIZE];
+    uint8_t tmpline[CH_STORAGE_FLUSH_MAX_LINES*CH_STORAGE_LINE_SIZE];
+    uint32_t _last_dirty_ms;    // last time a line was marked dirty
+    uint32_t _write_bytes;      // bytes changed by write_block(), for write amplification
 
     bool _flash_write_data(uint8_t sector, uint32_t offset, const uint8_t *data, uint16_t length);
     bool _flash_read_data(uint8_t sector, uint32_t offset, uint8_t *data, uint16_t length);
@@ -105,7 +131,7 @@ private:
 #endif
 
     void _flash_load(void);
-    bool _flash_write(uint16_t line);
+    bool _flash_write(uint16_t line, uint16_t num_lines);
 
 #if HAL_WITH_RAMTRON
     AP_RAMTRON fram;
@@ -771,6 +771,31 @@ ssize_t UARTDriver::_read(uint8_t *buffer, uint16_t count)
     return ret;
 }
 
+const uint8_t *UARTDriver::_read_span(uint32_t &n)
+{
+    if (_uart_owner_thd != chThdGetSelfX() || !_rx_initialised) {
+        n = 0;
+        return nullptr;
+    }
+    return _readbuf.readptr(n);
+}
+
+bool UARTDriver::_read_span_advance(uint32_t n)
+{
+    if (_uart_owner_thd != chThdGetSelfX() || !_rx_initialised) {
+        return false;
+    }
+    if (!_readbuf.advance(n)) {
+        return false;
+    }
+
+    if (!_rts_is_active) {
+        update_rts_line();
+    }
+
+    return true;
+}
+
 /* write a block of bytes to the port */
 size_t UARTDriver::_write(const uint8_t *buffer, size_t size)
 {
@@ -787,6 +812,39 @@ size_t UARTDriver::_write(const uint8_t *buffer, size_t size)
     return ret;
 }
 
+/*
+  reserve space in the write buffer. The write mutex is held until
+  _write_commit()
+ */
+uint8_t UARTDriver::_write_reserve(ByteBuffer::IoVec vec[2], uint32_t len)
+{
+    if (!_tx_initialised) {
+        return 0;
+    }
+
+    _write_mutex.take_blocking();
+
+    if (_writebuf.space() < len) {
+        _write_mutex.give();
+        return 0;
+    }
+    const uint8_t ret = _writebuf.reserve(vec, len);
+    if (ret == 0) {
+        _write_mutex.give();
+    }
+    return ret;
+}
+
+bool UARTDriver::_write_commit(uint32_t len)
+{
+    const bool ret = _writebuf.commit(len);
+    _write_mutex.give();
+    if (unbuffered_writes) {
+        chEvtSignal(uart_thread_ctx, EVT_TRANSMIT_DATA_READY);
+    }
+    return ret;
+}
+
 /*
   wait for data to arrive, or a timeout. Return true if data has
   arrived, false on timeout
@@ -283,6 +283,10 @@ protected:
     void _flush() override;
     size_t _write(const uint8_t *buffer, size_t size) override;
     ssize_t _read(uint8_t *buffer, uint16_t count) override;
+    const uint8_t *_read_span(uint32_t &n) override;
+    bool _read_span_advance(uint32_t n) override;
+    uint8_t _write_reserve(ByteBuffer::IoVec vec[2], uint32_t len) override;
+    bool _write_commit(uint32_t len) override;
     uint32_t _available() override;
     bool _discard_input() override;
 
@@ -30,6 +30,7 @@
 #include <AP_InternalError/AP_InternalError.h>
 #include "sdcard.h"
 #include "shared_dma.h"
+#include "Device.h"
 #if defined(HAL_PWM_ALARM) || HAL_DSHOT_ALARM_ENABLED || HAL_CANMANAGER_ENABLED || HAL_USE_PWM == TRUE
 #include <AP_Notify/AP_Notify.h>
 #endif
@@ -700,6 +701,14 @@ void Util::timer_info(ExpandingString &str)
 }
 #endif
 
+// request information on I2C and SPI bus utilisation
+#if HAL_USE_I2C == TRUE || HAL_USE_SPI == TRUE || HAL_USE_WSPI == TRUE
+void Util::bus_info(ExpandingString &str)
+{
+    DeviceBus::bus_info(str);
+}
+#endif
+
 /**
  * This method will generate random values with set size. It will fall back to AP_Math's get_random16()
  * if True RNG fails or enough entropy is not present.
@@ -105,6 +105,9 @@ public:
 
 #if HAL_USE_PWM == TRUE
     void timer_info(ExpandingString &str) override;
+#endif
+#if HAL_USE_I2C == TRUE || HAL_USE_SPI == TRUE || HAL_USE_WSPI == TRUE
+    void bus_info(ExpandingString &str) override;
 #endif
     // returns random values
     bool get_random_vals(uint8_t* data, size_t size) override;
@@ -87,6 +87,8 @@ public:
     void start_cb() override;
     void end_cb() override;
 
+    void start_thread();
+
     int open(uint8_t n);
 
     PollerThread thread;
@@ -103,6 +105,22 @@ I2CBus::~I2CBus()
     }
 }
 
+void I2CBus::start_thread()
+{
+    // transfers may be queued from any thread
+    WITH_SEMAPHORE(sem);
+    if (thread.is_started()) {
+        return;
+    }
+
+    char name[16];
+    snprintf(name, sizeof(name), "ap-i2c-%u", bus);
+
+    thread.set_stack_size(AP_LINUX_SENSORS_STACK_SIZE);
+    thread.start(name, AP_LINUX_SENSORS_SCHED_POLICY,
+                 AP_LINUX_SENSORS_SCHED_PRIO);
+}
+
 void I2CBus::start_cb()
 {
     sem.take_blocking();
@@ -190,9 +208,13 @@ bool I2CDevice::transfer(const uint8_t *send, uint32_t send_len,
 
     int r;
     unsigned retries = _retries;
+    const uint64_t start_us = AP_HAL::micros64();
     do {
         r = ::ioctl(_bus.fd, I2C_RDWR, &i2c_data);
     } while (r == -1 && retries-- > 0);
+#if HAL_DEVICE_STATS_ENABLED
+    stats_transfer(send_len + recv_len, start_us, r != -1);
+#endif
 
     return r != -1;
 }
@@ -229,9 +251,13 @@ bool I2CDevice::read_registers_multiple(uint8_t first_reg, uint8_t *recv,
 
         int r;
         unsigned retries = _retries;
+        const uint64_t start_us = AP_HAL::micros64();
         do {
             r = ::ioctl(_bus.fd, I2C_RDWR, &i2c_data);
         } while (r == -1 && retries-- > 0);
+#if HAL_DEVICE_STATS_ENABLED
+        stats_transfer(n * (1 + recv_len), start_us, r != -1);
+#endif
 
         if (r == -1) {
             return false;
@@ -251,19 +277,12 @@ AP_HAL::Semaphore *I2CDevice::get_semaphore()
 AP_HAL::Device::PeriodicHandle I2CDevice::register_periodic_callback(
     uint32_t period_usec, AP_HAL::Device::PeriodicCb cb)
 {
-    TimerPollable *p = _bus.thread.add_timer(cb, &_bus, period_usec);
+    TimerPollable *p = _bus.thread.add_timer(cb, &_bus, period_usec, this);
     if (!p) {
         AP_HAL::panic("Could not create periodic callback");
     }
 
-    if (!_bus.thread.is_started()) {
-        char name[16];
-        snprintf(name, sizeof(name), "ap-i2c-%u", _bus.bus);
-
-        _bus.thread.set_stack_size(AP_LINUX_SENSORS_STACK_SIZE);
-        _bus.thread.start(name, AP_LINUX_SENSORS_SCHED_POLICY,
-                          AP_LINUX_SENSORS_SCHED_PRIO);
-    }
+    _bus.start_thread();
 
     return static_cast<AP_HAL::Device::PeriodicHandle>(p);
 }
@@ -274,6 +293,15 @@ bool I2CDevice::adjust_periodic_callback(
     return _bus.thread.adjust_timer(static_cast<TimerPollable*>(h), period_usec);
 }
 
+bool I2CDevice::queue_transfer(AP_HAL::Device::QueuedTransfer &t)
+{
+    if (!_bus.thread.queue_transfer(t, &_bus, this)) {
+        return false;
+    }
+    _bus.start_thread();
+    return true;
+}
+
 I2CDeviceManager::I2CDeviceManager()
 {
     /* Reserve space up-front for 4 buses */
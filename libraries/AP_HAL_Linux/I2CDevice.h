@@ -71,6 +71,9 @@ public:
     bool adjust_periodic_callback(
         AP_HAL::Device::PeriodicHandle h, uint32_t period_usec) override;
 
+    /* See AP_HAL::Device::queue_transfer() */
+    bool queue_transfer(AP_HAL::Device::QueuedTransfer &t) override;
+
     /* set split transfers flag */
     void set_split_transfers(bool set) override {
         _split_transfers = set;
@@ -21,6 +21,7 @@
 #include <sys/epoll.h>
 #include <sys/timerfd.h>
 
+#include <AP_HAL/AP_HAL.h>
 #include <AP_Math/AP_Math.h>
 
 namespace Linux {
@@ -37,10 +38,21 @@ void TimerPollable::on_can_read()
         return;
     }
 
+    // the latest expiry was nevents-1 periods after the one we expected
+    const uint64_t due_usec = _next_usec + (nevents - 1) * _period_usec;
+    _next_usec = due_usec + _period_usec;
+
     if (_wrapper) {
         _wrapper->start_cb();
     }
 
+#if HAL_DEVICE_STATS_ENABLED
+    if (_dev != nullptr) {
+        const uint64_t now_usec = AP_HAL::micros64();
+        _dev->stats_callback(now_usec > due_usec ? uint32_t(now_usec - due_usec) : 0);
+    }
+#endif
+
     _cb();
 
     if (_wrapper) {
@@ -83,17 +95,21 @@ bool TimerPollable::adjust_timer(uint32_t timeout_usec)
         return false;
     }
 
+    _period_usec = timeout_usec;
+    _next_usec = AP_HAL::micros64() + timeout_usec;
+
     return true;
 }
 
 TimerPollable *PollerThread::add_timer(TimerPollable::PeriodicCb cb,
                                        TimerPollable::WrapperCb *wrapper,
-                                       uint32_t timeout_usec)
+                                       uint32_t timeout_usec,
+                                       AP_HAL::Device *dev)
 {
     if (!_poller) {
         return nullptr;
     }
-    TimerPollable *p = NEW_NOTHROW TimerPollable(cb, wrapper);
+    TimerPollable *p = NEW_NOTHROW TimerPollable(cb, wrapper, dev);
     if (!p || !p->setup_timer(timeout_usec) ||
         !_poller.register_pollable(p, POLLIN)) {
         delete p;
@@ -132,6 +148,66 @@ void PollerThread::_cleanup_timers()
     }
 }
 
+bool PollerThread::queue_transfer(AP_HAL::Device::QueuedTransfer &t,
+                                  TimerPollable::WrapperCb *wrapper,
+                                  AP_HAL::Device *dev)
+{
+    if (!_poller) {
+        return false;
+    }
+
+    t.dev = dev;
+    t.next = nullptr;
+
+    {
+        WITH_SEMAPHORE(_queue_sem);
+        _queue_wrapper = wrapper;
+        if (_queue_tail != nullptr) {
+            _queue_tail->next = &t;
+        } else {
+            _queue_head = &t;
+        }
+        _queue_tail = &t;
+    }
+
+    // transfers queued from our own callbacks are done once the
+    // current poll() returns
+    if (!is_current_thread()) {
+        _poller.wakeup();
+    }
+
+    return true;
+}
+
+void PollerThread::_run_queued_transfers()
+{
+    AP_HAL::Device::QueuedTransfer *t;
+    TimerPollable::WrapperCb *wrapper;
+    {
+        WITH_SEMAPHORE(_queue_sem);
+        t = _queue_head;
+        wrapper = _queue_wrapper;
+        _queue_head = nullptr;
+        _queue_tail = nullptr;
+    }
+    if (t == nullptr) {
+        return;
+    }
+
+    if (wrapper) {
+        wrapper->start_cb();
+    }
+    while (t != nullptr) {
+        // the callback may queue the descriptor again
+        AP_HAL::Device::QueuedTransfer *next = t->next;
+        t->dev->run_queued_transfer(*t);
+        t = next;
+    }
+    if (wrapper) {
+        wrapper->end_cb();
+    }
+}
+
 void PollerThread::mainloop()
 {
     if (!_poller) {
@@ -140,6 +216,7 @@ void PollerThread::mainloop()
 
     while (!_should_exit) {
         _poller.poll();
+        _run_queued_transfers();
         _cleanup_timers();
     }
 
@@ -48,15 +48,22 @@ public:
     bool adjust_timer(uint32_t timeout_usec);
 
 protected:
-    TimerPollable(PeriodicCb cb, WrapperCb *wrapper)
+    TimerPollable(PeriodicCb cb, WrapperCb *wrapper, AP_HAL::Device *dev)
         : _cb(cb)
         , _wrapper(wrapper)
+        , _dev(dev)
     {
     }
 
     PeriodicCb _cb;
     WrapperCb *_wrapper;
     bool _removeme = false;
+
+    // device which registered the callback, for its statistics
+    AP_HAL::Device *_dev;
+    // when the timer is next due, to measure how late callbacks run
+    uint64_t _next_usec = 0;
+    uint32_t _period_usec = 0;
 };
 
 
@@ -67,18 +74,34 @@ public:
 
     TimerPollable *add_timer(TimerPollable::PeriodicCb cb,
                              TimerPollable::WrapperCb *wrapper,
-                             uint32_t timeout_usec);
+                             uint32_t timeout_usec,
+                             AP_HAL::Device *dev = nullptr);
     bool adjust_timer(TimerPollable *p, uint32_t timeout_usec);
 
+    /*
+     * Queue a transfer to be done by this thread. Transfers queued while
+     * the thread handles an event are done back to back afterwards, with
+     * @wrapper's start_cb() and end_cb() called once around the batch.
+     */
+    bool queue_transfer(AP_HAL::Device::QueuedTransfer &t,
+                        TimerPollable::WrapperCb *wrapper,
+                        AP_HAL::Device *dev);
+
     void mainloop();
 
     bool stop() override;
 
 protected:
     void _cleanup_timers();
+    void _run_queued_transfers();
 
     Poller _poller{};
     std::vector<TimerPollable*> _timers{};
+
+    Semaphore _queue_sem;
+    AP_HAL::Device::QueuedTransfer *_queue_head = nullptr;
+    AP_HAL::Device::QueuedTransfer *_queue_tail = nullptr;
+    TimerPollable::WrapperCb *_queue_wrapper = nullptr;
 };
 
 }
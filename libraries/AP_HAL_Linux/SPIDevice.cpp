@@ -185,6 +185,8 @@ public:
     void start_cb() override;
     void end_cb() override;
 
+    void start_thread();
+
     void open(uint16_t subdev);
 
     PollerThread thread;
@@ -208,6 +210,22 @@ SPIBus::~SPIBus()
     }
 }
 
+void SPIBus::start_thread()
+{
+    // transfers may be queued from any thread
+    WITH_SEMAPHORE(sem);
+    if (thread.is_started()) {
+        return;
+    }
+
+    char name[16];
+    snprintf(name, sizeof(name), "ap-spi-%u", bus);
+
+    thread.set_stack_size(AP_LINUX_SENSORS_STACK_SIZE);
+    thread.start(name, AP_LINUX_SENSORS_SCHED_POLICY,
+                 AP_LINUX_SENSORS_SCHED_PRIO);
+}
+
 void SPIBus::start_cb()
 {
     sem.take_blocking();
@@ -344,9 +362,13 @@ bool SPIDevice::transfer(const uint8_t *send, uint32_t send_len,
         _bus.last_mode = _desc.mode;
     }
 
+    const uint64_t start_us = AP_HAL::micros64();
     _cs_assert();
     r = ioctl(fd, SPI_IOC_MESSAGE(nmsgs), &msgs);
     _cs_release();
+#if HAL_DEVICE_STATS_ENABLED
+    stats_transfer(send_len + recv_len, start_us, r != -1);
+#endif
 
     if (r == -1) {
         hal.console->printf("SPIDevice: error transferring data fd=%d (%s)\n",
@@ -382,9 +404,13 @@ bool SPIDevice::transfer_fullduplex(const uint8_t *send, uint8_t *recv,
         return false;
     }
 
+    const uint64_t start_us = AP_HAL::micros64();
     _cs_assert();
     r = ioctl(fd, SPI_IOC_MESSAGE(1), &msgs);
     _cs_release();
+#if HAL_DEVICE_STATS_ENABLED
+    stats_transfer(len, start_us, r != -1);
+#endif
 
     if (r == -1) {
         hal.console->printf("SPIDevice: error transferring data fd=%d (%s)\n",
@@ -422,19 +448,12 @@ AP_HAL::Semaphore *SPIDevice::get_semaphore()
 AP_HAL::Device::PeriodicHandle SPIDevice::register_periodic_callback(
     uint32_t period_usec, AP_HAL::Device::PeriodicCb cb)
 {
-    TimerPollable *p = _bus.thread.add_timer(cb, &_bus, period_usec);
+    TimerPollable *p = _bus.thread.add_timer(cb, &_bus, period_usec, this);
     if (!p) {
         AP_HAL::panic("Could not create periodic callback");
     }
 
-    if (!_bus.thread.is_started()) {
-        char name[16];
-        snprintf(name, sizeof(name), "ap-spi-%u", _bus.bus);
-
-        _bus.thread.set_stack_size(AP_LINUX_SENSORS_STACK_SIZE);
-        _bus.thread.start(name, AP_LINUX_SENSORS_SCHED_POLICY,
-                          AP_LINUX_SENSORS_SCHED_PRIO);
-    }
+    _bus.start_thread();
 
     return static_cast<AP_HAL::Device::PeriodicHandle>(p);
 }
@@ -445,6 +464,15 @@ bool SPIDevice::adjust_periodic_callback(
     return _bus.thread.adjust_timer(static_cast<TimerPollable*>(h), period_usec);
 }
 
+bool SPIDevice::queue_transfer(AP_HAL::Device::QueuedTransfer &t)
+{
+    if (!_bus.thread.queue_transfer(t, &_bus, this)) {
+        return false;
+    }
+    _bus.start_thread();
+    return true;
+}
+
 
 AP_HAL::OwnPtr<AP_HAL::SPIDevice>
 SPIDeviceManager::get_device(const char *name)
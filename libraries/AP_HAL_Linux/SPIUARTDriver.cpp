@@ -139,6 +139,16 @@ int SPIUARTDriver::_read_fd(uint8_t *buf, uint16_t n)
     return n;
 }
 
+int SPIUARTDriver::_poll_fd()
+{
+    if (_external) {
+        return UARTDriver::_poll_fd();
+    }
+
+    /* SPI has nothing to wait on, poll at the SPI update rate */
+    return -1;
+}
+
 void SPIUARTDriver::_timer_tick(void)
 {
     if (_external) {
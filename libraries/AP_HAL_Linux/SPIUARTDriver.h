@@ -18,6 +18,7 @@ public:
 protected:
     int _write_fd(const uint8_t *buf, uint16_t n) override;
     int _read_fd(uint8_t *buf, uint16_t n) override;
+    int _poll_fd() override;
 
     AP_HAL::OwnPtr<AP_HAL::SPIDevice> _dev;
 
@@ -274,13 +274,16 @@ void Scheduler::_run_io(void)
 }
 
 /*
-  run timers for all UARTs
+  run timers for UARTs with pending events, or all UARTs
  */
-void Scheduler::_run_uarts()
+void Scheduler::_run_uarts(bool all)
 {
     // process any pending serial bytes
     for (uint8_t i=0;i<hal.num_serial; i++) {
-        hal.serial(i)->_timer_tick();
+        UARTDriver *uart = UARTDriver::from(hal.serial(i));
+        if (uart->_poll_pending() || all) {
+            uart->_timer_tick();
+        }
     }
 }
 
@@ -289,9 +292,31 @@ void Scheduler::_rcin_task()
     RCInput::from(hal.rcin)->_timer_tick();
 }
 
+/*
+  sleep until a UART is readable or writable or has bytes queued,
+  servicing every UART at least at APM_LINUX_UART_RATE for devices
+  that can't be waited on
+ */
 void Scheduler::_uart_task()
 {
-    _run_uarts();
+    const uint64_t period_usec = AP_USEC_PER_SEC / APM_LINUX_UART_RATE;
+
+    uint64_t dt = AP_HAL::micros64() - _last_uart_run_usec;
+    if (dt < period_usec) {
+        if (!_uart_poller || _uart_poller.poll((period_usec - dt + 999) / 1000) < 0) {
+            // without epoll sleep for the rest of the period as the
+            // fixed rate thread used to
+            delay_microseconds(period_usec - dt);
+        }
+        dt = AP_HAL::micros64() - _last_uart_run_usec;
+    }
+
+    const bool all = dt >= period_usec;
+    if (all) {
+        _last_uart_run_usec = AP_HAL::micros64();
+    }
+
+    _run_uarts(all);
 }
 
 void Scheduler::_io_task()
@@ -359,6 +384,31 @@ bool Scheduler::SchedulerThread::_run()
     return PeriodicThread::_run();
 }
 
+bool Scheduler::UARTThread::_run()
+{
+    _sched._wait_all_threads();
+
+    while (!_should_exit) {
+        _task();
+    }
+
+    _started = false;
+    _should_exit = false;
+
+    return true;
+}
+
+bool Scheduler::UARTThread::stop()
+{
+    if (!SchedulerThread::stop()) {
+        return false;
+    }
+
+    _sched.wakeup_uart_thread();
+
+    return true;
+}
+
 void Scheduler::teardown()
 {
     _timer_thread.stop();
@@ -4,6 +4,7 @@
 
 #include "AP_HAL_Linux.h"
 
+#include "Poller.h"
 #include "Semaphores.h"
 #include "Thread.h"
 
@@ -60,6 +61,13 @@ public:
      */
     void set_cpu_affinity(const cpu_set_t &cpu_affinity) { _cpu_affinity = cpu_affinity; }
 
+    /*
+      file descriptors the UART thread sleeps on between passes
+     */
+    bool register_uart_pollable(Pollable *p, uint32_t events) { return _uart_poller.register_pollable(p, events); }
+    void unregister_uart_pollable(const Pollable *p) { _uart_poller.unregister_pollable(p); }
+    void wakeup_uart_thread() { _uart_poller.wakeup(); }
+
 private:
     class SchedulerThread : public PeriodicThread {
     public:
@@ -74,6 +82,20 @@ private:
         Scheduler &_sched;
     };
 
+    /*
+      the UART thread sleeps on the UART poller rather than a fixed
+      period, the rate is the minimum rate every port is serviced at
+     */
+    class UARTThread : public SchedulerThread {
+    public:
+        using SchedulerThread::SchedulerThread;
+
+        bool stop() override;
+
+    protected:
+        bool _run() override;
+    };
+
     void     init_realtime();
 
     void     init_cpu_affinity();
@@ -101,7 +123,7 @@ private:
     SchedulerThread _timer_thread{FUNCTOR_BIND_MEMBER(&Scheduler::_timer_task, void), *this};
     SchedulerThread _io_thread{FUNCTOR_BIND_MEMBER(&Scheduler::_io_task, void), *this};
     SchedulerThread _rcin_thread{FUNCTOR_BIND_MEMBER(&Scheduler::_rcin_task, void), *this};
-    SchedulerThread _uart_thread{FUNCTOR_BIND_MEMBER(&Scheduler::_uart_task, void), *this};
+    UARTThread _uart_thread{FUNCTOR_BIND_MEMBER(&Scheduler::_uart_task, void), *this};
 
     void _timer_task();
     void _io_task();
@@ -109,7 +131,10 @@ private:
     void _uart_task();
 
     void _run_io();
-    void _run_uarts();
+    void _run_uarts(bool all);
+
+    Poller _uart_poller;
+    uint64_t _last_uart_run_usec;
 
     uint64_t _stopped_clock_usec;
     uint64_t _last_stack_debug_msec;
@@ -10,6 +10,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
@@ -18,8 +19,10 @@
 #include <unistd.h>
 
 #include <AP_HAL/AP_HAL.h>
+#include <AP_Common/ExpandingString.h>
 
 #include "ConsoleDevice.h"
+#include "Scheduler.h"
 #include "TCPServerDevice.h"
 #include "UARTDevice.h"
 #include "UDPDevice.h"
@@ -212,6 +215,7 @@ void UARTDriver::_end()
         hal.scheduler->delay(1);
     }
 
+    _unregister_pollable();
     _device->close();
     _deallocate_buffers();
 }
@@ -271,6 +275,23 @@ ssize_t UARTDriver::_read(uint8_t *buffer, uint16_t count)
     return _readbuf.read(buffer, count);
 }
 
+const uint8_t *UARTDriver::_read_span(uint32_t &n)
+{
+    if (!_initialised) {
+        n = 0;
+        return nullptr;
+    }
+    return _readbuf.readptr(n);
+}
+
+bool UARTDriver::_read_span_advance(uint32_t n)
+{
+    if (!_initialised) {
+        return false;
+    }
+    return _readbuf.advance(n);
+}
+
 bool UARTDriver::_discard_input()
 {
     if (!_initialised) {
@@ -294,9 +315,56 @@ size_t UARTDriver::_write(const uint8_t *buffer, size_t size)
 
     size_t ret = _writebuf.write(buffer, size);
     _write_mutex.give();
+    if (ret > 0) {
+        _wakeup_uart_thread();
+    }
+    return ret;
+}
+
+/*
+  reserve space in the write buffer. The write mutex is held until
+  _write_commit()
+ */
+uint8_t UARTDriver::_write_reserve(ByteBuffer::IoVec vec[2], uint32_t len)
+{
+    if (!_initialised) {
+        return 0;
+    }
+    if (!_write_mutex.take_nonblocking()) {
+        return 0;
+    }
+    if (_writebuf.space() < len) {
+        _write_mutex.give();
+        return 0;
+    }
+    const uint8_t ret = _writebuf.reserve(vec, len);
+    if (ret == 0) {
+        _write_mutex.give();
+    }
+    return ret;
+}
+
+bool UARTDriver::_write_commit(uint32_t len)
+{
+    const bool ret = _writebuf.commit(len);
+    _write_mutex.give();
+    if (ret && len > 0) {
+        _wakeup_uart_thread();
+    }
     return ret;
 }
 
+/*
+  wake the UART thread to send newly queued bytes. Only the first
+  write after the thread has run makes the system call
+ */
+void UARTDriver::_wakeup_uart_thread()
+{
+    if (!_write_wakeup.exchange(true)) {
+        Scheduler::from(hal.scheduler)->wakeup_uart_thread();
+    }
+}
+
 /*
   try writing n bytes, handling an unresponsive port
  */
@@ -313,7 +381,12 @@ int UARTDriver::_write_fd(const uint8_t *buf, uint16_t n)
         return 0;
     }
 
-    return _device->write(buf, n);
+    _stats_syscalls++;
+    const int ret = _device->write(buf, n);
+    if (ret > 0) {
+        _tx_stats_bytes += ret;
+    }
+    return ret;
 }
 
 /*
@@ -321,7 +394,64 @@ int UARTDriver::_write_fd(const uint8_t *buf, uint16_t n)
  */
 int UARTDriver::_read_fd(uint8_t *buf, uint16_t n)
 {
-    return _device->read(buf, n);
+    _stats_syscalls++;
+    const int ret = _device->read(buf, n);
+    if (ret > 0) {
+        _rx_stats_bytes += ret;
+    }
+    return ret;
+}
+
+int UARTDriver::_poll_fd()
+{
+    return _connected ? _device->get_fd() : -1;
+}
+
+/*
+  keep the UART thread waiting on the current device fd. This changes
+  when a network client connects or disconnects
+ */
+void UARTDriver::_update_pollable()
+{
+    const int fd = _poll_fd();
+    if (fd == _pollable.get_fd() || fd == _pollable.unpollable_fd) {
+        return;
+    }
+
+    _unregister_pollable();
+    if (fd < 0) {
+        return;
+    }
+
+    _pollable.set_fd(fd);
+    /*
+      edge triggered so a full read buffer or an idle writable
+      socket doesn't keep waking the thread
+     */
+    if (!Scheduler::from(hal.scheduler)->register_uart_pollable(&_pollable, EPOLLIN | EPOLLOUT | EPOLLET)) {
+        // not pollable (e.g. a regular file), service on every pass
+        _pollable.set_fd(-1);
+        _pollable.unpollable_fd = fd;
+    }
+    // the device may already have data waiting
+    _pollable.ready = true;
+}
+
+void UARTDriver::_unregister_pollable()
+{
+    Scheduler::from(hal.scheduler)->unregister_uart_pollable(&_pollable);
+    _pollable.set_fd(-1);
+    _pollable.unpollable_fd = -1;
+}
+
+bool UARTDriver::_poll_pending()
+{
+    // exchange so a write queued while we check still wakes the
+    // next pass. ready is only set by the UART thread itself
+    const bool write_wakeup = _write_wakeup.exchange(false);
+    const bool ret = _pollable.get_fd() < 0 || _pollable.ready || write_wakeup;
+    _pollable.ready = false;
+    return ret;
 }
 
 
@@ -374,9 +504,10 @@ bool UARTDriver::_write_pending_bytes(void)
 }
 
 /*
-  push any pending bytes to/from the serial port. This is called at
-  1kHz in the timer thread. Doing it this way reduces the system call
-  overhead in the main task enormously.
+  push any pending bytes to/from the serial port. This is called from
+  the UART thread when the device is readable or writable, when bytes
+  are queued and at least at APM_LINUX_UART_RATE. Doing it this way
+  reduces the system call overhead in the main task enormously.
  */
 void UARTDriver::_timer_tick(void)
 {
@@ -411,6 +542,8 @@ void UARTDriver::_timer_tick(void)
         }
     }
 
+    _update_pollable();
+
     _in_timer = false;
 }
 
@@ -449,3 +582,22 @@ uint32_t UARTDriver::bw_in_bytes_per_second() const
     const uint32_t bitrate = (_connected && _ip != nullptr) ? 10E6 : _baudrate;
     return bitrate/10; // convert bits to bytes minus overhead
 }
+
+#if HAL_UART_STATS_ENABLED
+// request information on uart I/O for @SYS/uarts.txt for this uart
+void UARTDriver::uart_info(ExpandingString &str, StatsTracker &stats, const uint32_t dt_ms)
+{
+    const uint32_t tx_bytes = stats.tx.update(_tx_stats_bytes);
+    const uint32_t rx_bytes = stats.rx.update(_rx_stats_bytes);
+    const uint32_t syscalls = _syscall_tracker.update(_stats_syscalls);
+
+    str.printf("TX=%8u RX=%8u TXBD=%6u RXBD=%6u SYSC=%6u %s (%s)\n",
+                unsigned(tx_bytes),
+                unsigned(rx_bytes),
+                unsigned((tx_bytes * 10000) / dt_ms),
+                unsigned((rx_bytes * 10000) / dt_ms),
+                unsigned((syscalls * 1000) / dt_ms),
+                _connected ? "connected    " : "not connected",
+                device_path != nullptr ? device_path : "console");
+}
+#endif
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <atomic>
+
 #include <AP_HAL/utility/OwnPtr.h>
 #include <AP_HAL/utility/RingBuffer.h>
 
 #include "AP_HAL_Linux.h"
+#include "Poller.h"
 #include "SerialDevice.h"
 #include "Semaphores.h"
 
@@ -27,6 +30,12 @@ public:
     bool _write_pending_bytes(void);
     virtual void _timer_tick(void) override;
 
+    /*
+      return true if the UART thread should service this port on this
+      pass, clearing any pending events
+     */
+    bool _poll_pending();
+
     virtual enum flow_control get_flow_control(void) override
     {
         return _device->get_flow_control();
@@ -58,7 +67,37 @@ public:
 
     virtual uint32_t get_baud_rate() const override { return _baudrate; }
 
+#if HAL_UART_STATS_ENABLED
+    // request information on uart I/O
+    void uart_info(ExpandingString &str, StatsTracker &stats, const uint32_t dt_ms) override;
+
+    // Getters for cumulative tx and rx counts
+    uint32_t get_total_tx_bytes() const override { return _tx_stats_bytes; }
+    uint32_t get_total_rx_bytes() const override { return _rx_stats_bytes; }
+#endif
+
 private:
+    /*
+      wakes the UART thread when the device is readable or
+      writable. The fd belongs to the SerialDevice so it is never
+      closed here
+     */
+    class DevicePollable : public Pollable {
+    public:
+        ~DevicePollable() { _fd = -1; }
+
+        void set_fd(int fd) { _fd = fd; }
+
+        void on_can_read() override { ready = true; }
+        void on_can_write() override { ready = true; }
+        void on_error() override { ready = true; }
+        void on_hang_up() override { ready = true; }
+
+        bool ready = false;
+        // fd that epoll refused, not retried until the device changes
+        int unpollable_fd = -1;
+    };
+
     AP_HAL::OwnPtr<SerialDevice> _device;
     bool _console;
     volatile bool _in_timer;
@@ -78,6 +117,23 @@ private:
     uint64_t _receive_timestamp[2];
     uint8_t _receive_timestamp_idx;
 
+    DevicePollable _pollable;
+    // set when bytes are queued for write, wakes the UART thread once
+    std::atomic<bool> _write_wakeup{false};
+
+    void _update_pollable();
+    void _unregister_pollable();
+    void _wakeup_uart_thread();
+
+    // statistics
+    uint32_t _tx_stats_bytes;
+    uint32_t _rx_stats_bytes;
+    // device read and write calls, for @SYS/uarts.txt
+    uint32_t _stats_syscalls;
+#if HAL_UART_STATS_ENABLED
+    StatsTracker::ByteTracker _syscall_tracker;
+#endif
+
 protected:
     const char *device_path;
     volatile bool _initialised;
@@ -90,6 +146,9 @@ protected:
     virtual int _write_fd(const uint8_t *buf, uint16_t n);
     virtual int _read_fd(uint8_t *buf, uint16_t n);
 
+    // fd the UART thread waits on for this port, -1 to service it on every pass
+    virtual int _poll_fd();
+
     Linux::Semaphore _write_mutex;
 
     bool _discard_input() override;
@@ -99,6 +158,10 @@ protected:
     uint32_t _available() override;
     size_t _write(const uint8_t *buffer, size_t size) override;
     ssize_t _read(uint8_t *buffer, uint16_t count) override WARN_IF_UNUSED;
+    const uint8_t *_read_span(uint32_t &n) override;
+    bool _read_span_advance(uint32_t n) override;
+    uint8_t _write_reserve(ByteBuffer::IoVec vec[2], uint32_t len) override;
+    bool _write_commit(uint32_t len) override;
 };
 
 }
@@ -1,10 +1,14 @@
 #include "UDPDevice.h"
 
+#include <errno.h>
 #include <fcntl.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/ioctl.h>
+#include <sys/socket.h>
 
 #include <AP_HAL/AP_HAL.h>
+#include <AP_Math/AP_Math.h>
 
 UDPDevice::UDPDevice(const char *ip, uint16_t port, bool bcast, bool input):
     _ip(ip),
@@ -35,8 +39,13 @@ ssize_t UDPDevice::write(const uint8_t *buf, uint16_t n)
 
 ssize_t UDPDevice::read(uint8_t *buf, uint16_t n)
 {
+    if (_connected) {
+        return socket_recv_datagrams(socket.get_read_fd(), buf, n);
+    }
+
+    // the first datagram gives the address to connect back to
     ssize_t ret = socket.recv(buf, n, 0);
-    if (!_connected && ret > 0) {
+    if (ret > 0) {
         const char *ip;
         uint16_t port;
         socket.last_recv_address(ip, port);
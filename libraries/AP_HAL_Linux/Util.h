@@ -95,7 +95,34 @@ public:
     // fills data with random values of requested size
     bool get_random_vals(uint8_t* data, size_t size) override;
 
+#if HAL_DEVICE_STATS_ENABLED
+    // request information on I2C and SPI bus utilisation
+    void bus_info(ExpandingString &str) override {
+        AP_HAL::Device::stats_info(str);
+    }
+
+#if HAL_LOGGING_ENABLED
+    // log I2C and SPI bus utilisation
+    void bus_log() override {
+        AP_HAL::Device::stats_log();
+    }
+#endif
+#endif // HAL_DEVICE_STATS_ENABLED
+
+#if HAL_UART_STATS_ENABLED
+    // request information on uart I/O
+    void uart_info(ExpandingString &str) override;
+#endif
+
 private:
+#if HAL_UART_STATS_ENABLED
+    // UART stats tracking helper
+    struct uart_stats {
+        AP_HAL::UARTDriver::StatsTracker serial[AP_HAL::HAL::num_serial];
+        uint32_t last_ms;
+    };
+    uart_stats sys_uart_stats;
+#endif
 #if CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_DISCO
     static ToneAlarm_Disco _toneAlarm;
 #else
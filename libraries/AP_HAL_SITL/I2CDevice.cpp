@@ -40,16 +40,24 @@ public:
         return _ioctl(ioctl_number, data);
     }
     void _timer_tick(); // in lieu of a thread-per-bus
-    AP_HAL::Device::PeriodicHandle register_periodic_callback(uint32_t period_usec, AP_HAL::Device::PeriodicCb cb);
+    AP_HAL::Device::PeriodicHandle register_periodic_callback(uint32_t period_usec, AP_HAL::Device::PeriodicCb cb, AP_HAL::Device *dev);
+    bool queue_transfer(AP_HAL::Device::QueuedTransfer &t, AP_HAL::Device *dev);
 
 private:
     int _ioctl(uint8_t ioctl_number, void *data);
 
+    // transfers waiting for the next timer tick
+    Semaphore queue_sem;
+    AP_HAL::Device::QueuedTransfer *queue_head;
+    AP_HAL::Device::QueuedTransfer *queue_tail;
+    void run_queued_transfers();
+
     struct callback_info {
         struct callback_info *next;
         AP_HAL::Device::PeriodicCb cb;
         uint32_t period_usec;
         uint64_t next_usec;
+        AP_HAL::Device *dev;
     } *callbacks;
 
     static uint8_t i2c_buscount;
@@ -64,7 +72,7 @@ int I2CBus::_ioctl(uint8_t ioctl_number, void *data)
     return sitl->i2c_ioctl(ioctl_number, data);
 }
 
-AP_HAL::Device::PeriodicHandle I2CBus::register_periodic_callback(uint32_t period_usec, AP_HAL::Device::PeriodicCb cb)
+AP_HAL::Device::PeriodicHandle I2CBus::register_periodic_callback(uint32_t period_usec, AP_HAL::Device::PeriodicCb cb, AP_HAL::Device *dev)
 {
     // mostly swiped from ChibiOS:
     I2CBus::callback_info *callback = NEW_NOTHROW I2CBus::callback_info;
@@ -74,6 +82,7 @@ AP_HAL::Device::PeriodicHandle I2CBus::register_periodic_callback(uint32_t perio
     callback->cb = cb;
     callback->period_usec = period_usec;
     callback->next_usec = AP_HAL::micros64() + period_usec;
+    callback->dev = dev;
 
     // add to linked list of callbacks on thread
     callback->next = callbacks;
@@ -87,10 +96,58 @@ void I2CBus::_timer_tick()
     for (struct callback_info *ci = callbacks; ci != nullptr; ci = ci->next) {
         if (ci->next_usec < now) {
             WITH_SEMAPHORE(sem);
+#if HAL_DEVICE_STATS_ENABLED
+            ci->dev->stats_callback(now - ci->next_usec);
+#endif
             ci->cb();
             ci->next_usec += ci->period_usec;
         }
     }
+    run_queued_transfers();
+}
+
+/*
+  add a transfer to the queue for the next timer tick
+*/
+bool I2CBus::queue_transfer(AP_HAL::Device::QueuedTransfer &t, AP_HAL::Device *dev)
+{
+    t.dev = dev;
+    t.next = nullptr;
+
+    WITH_SEMAPHORE(queue_sem);
+    if (queue_tail != nullptr) {
+        queue_tail->next = &t;
+    } else {
+        queue_head = &t;
+    }
+    queue_tail = &t;
+    return true;
+}
+
+/*
+  do all the queued transfers back to back with the bus semaphore
+  taken once, as the ChibiOS bus thread does
+*/
+void I2CBus::run_queued_transfers()
+{
+    AP_HAL::Device::QueuedTransfer *t;
+    {
+        WITH_SEMAPHORE(queue_sem);
+        t = queue_head;
+        queue_head = nullptr;
+        queue_tail = nullptr;
+    }
+    if (t == nullptr) {
+        return;
+    }
+
+    WITH_SEMAPHORE(sem);
+    while (t != nullptr) {
+        // the callback may queue the descriptor again
+        AP_HAL::Device::QueuedTransfer *next = t->next;
+        t->dev->run_queued_transfer(*t);
+        t = next;
+    }
 }
 
 /*
@@ -189,9 +246,13 @@ bool I2CDevice::_transfer(const uint8_t *send, uint32_t send_len,
 
     int r;
     unsigned retries = _retries;
+    const uint64_t start_us = AP_HAL::micros64();
     do {
         r = _bus.ioctl(I2C_RDWR, &i2c_data);
     } while (r == -1 && retries-- > 0);
+#if HAL_DEVICE_STATS_ENABLED
+    stats_transfer(send_len + recv_len, start_us, r != -1);
+#endif
 
     return r != -1;
 }
@@ -209,7 +270,7 @@ AP_HAL::Semaphore *I2CDevice::get_semaphore() {
 
 AP_HAL::Device::PeriodicHandle I2CDevice::register_periodic_callback(uint32_t period_usec, AP_HAL::Device::PeriodicCb cb)
 {
-    return _bus.register_periodic_callback(period_usec, cb);
+    return _bus.register_periodic_callback(period_usec, cb, this);
 }
 
 bool I2CDevice::adjust_periodic_callback(Device::PeriodicHandle h, uint32_t period_usec)
@@ -217,4 +278,9 @@ bool I2CDevice::adjust_periodic_callback(Device::PeriodicHandle h, uint32_t peri
     return false;
 }
 
+bool I2CDevice::queue_transfer(AP_HAL::Device::QueuedTransfer &t)
+{
+    return _bus.queue_transfer(t, this);
+}
+
 #endif //#if CONFIG_HAL_BOARD == HAL_BOARD_SITL
@@ -243,7 +243,11 @@ bool SPIDevice::transfer(const uint8_t *send, uint32_t send_len,
     default:
         abort();
     }
+    const uint64_t start_us = AP_HAL::micros64();
     const int r = bus.ioctl(device_desc.cs_pin, ioctl_number, &msgs);
+#if HAL_DEVICE_STATS_ENABLED
+    stats_transfer(send_len + recv_len, start_us, r != -1);
+#endif
 
     if (r == -1) {
         hal.console->printf("SPIDevice: error transferring data\n");
@@ -2,6 +2,7 @@
 
 #include <AP_Vehicle/AP_Vehicle_Type.h>
 #include <AP_HAL/AP_HAL.h>
+#include <AP_Common/ExpandingString.h>
 #include "AP_HAL_SITL.h"
 
 #include <assert.h>
@@ -137,6 +138,8 @@ void Storage::_mark_dirty(uint16_t loc, uint16_t length)
          line++) {
         _dirty_mask.set(line);
     }
+    _last_dirty_ms = AP_HAL::millis();
+    _write_bytes += length;
 }
 
 void Storage::read_block(void *dst, uint16_t loc, size_t n)
@@ -165,13 +168,32 @@ void Storage::_timer_tick(void)
     if (_initialisedType == StorageBackend::None) {
         return;
     }
+    const uint32_t now_ms = AP_HAL::millis();
     if (_dirty_mask.empty()) {
-        _last_empty_ms = AP_HAL::millis();
+        _last_empty_ms = now_ms;
+#if STORAGE_USE_FLASH
+        // with nothing to write, continue copying storage to the
+        // new flash sector after a sector switch a few blocks at a
+        // time, so that a full sector switch is rarely needed
+        if (_initialisedType == StorageBackend::Flash && _flash.compact_pending()) {
+            IGNORE_RETURN(_flash.compact_step());
+        }
+#endif
+        return;
+    }
+
+#if STORAGE_USE_FLASH
+    // let a burst of changes finish so it can be coalesced, the
+    // oldest dirty line was changed after _last_empty_ms
+    if (_initialisedType == StorageBackend::Flash &&
+        now_ms - _last_dirty_ms < STORAGE_FLUSH_IDLE_MS &&
+        now_ms - _last_empty_ms < STORAGE_FLUSH_MAX_DELAY_MS) {
         return;
     }
+#endif
 
-    // write out the first dirty line. We don't write more
-    // than one to keep the latency of this call to a minimum
+    // write out the first run of dirty lines. We don't write more
+    // than one run to keep the latency of this call to a minimum
     uint16_t i;
     for (i=0; i<STORAGE_NUM_LINES; i++) {
         if (_dirty_mask.get(i)) {
@@ -182,10 +204,19 @@ void Storage::_timer_tick(void)
         // this shouldn't be possible
         return;
     }
+    uint16_t num_lines = 1;
+    while (num_lines < STORAGE_FLUSH_MAX_LINES &&
+           i+num_lines < STORAGE_NUM_LINES &&
+           _dirty_mask.get(i+num_lines)) {
+        num_lines++;
+    }
+    const uint16_t length = STORAGE_LINE_SIZE*num_lines;
 
 #if STORAGE_USE_FRAM
-        if (fram.write(STORAGE_LINE_SIZE*i, &_buffer[STORAGE_LINE_SIZE*i], STORAGE_LINE_SIZE)) {
-            _dirty_mask.clear(i);
+        if (fram.write(STORAGE_LINE_SIZE*i, &_buffer[STORAGE_LINE_SIZE*i], length)) {
+            for (uint16_t n=0; n<num_lines; n++) {
+                _dirty_mask.clear(i+n);
+            }
             return;
         }
 #endif
@@ -197,10 +228,12 @@ void Storage::_timer_tick(void)
             if (lseek(log_fd, offset, SEEK_SET) != offset) {
                 return;
             }
-            if (write(log_fd, &_buffer[offset], STORAGE_LINE_SIZE) != STORAGE_LINE_SIZE) {
+            if (write(log_fd, &_buffer[offset], length) != length) {
                 return;
             }
-            _dirty_mask.clear(i);
+            for (uint16_t n=0; n<num_lines; n++) {
+                _dirty_mask.clear(i+n);
+            }
             return;
         }
     }
@@ -209,7 +242,7 @@ void Storage::_timer_tick(void)
 #if STORAGE_USE_FLASH
     if (hal.get_storage_flash_enabled()) {
         // save to storage backend
-        _flash_write(i);
+        _flash_write(i, num_lines);
         return;
     }
 #endif
@@ -228,13 +261,15 @@ void Storage::_flash_load(void)
 }
 
 /*
-  write one storage line. This also updates _dirty_mask. 
+  write num_lines storage lines starting at line. This also updates _dirty_mask.
 */
-void Storage::_flash_write(uint16_t line)
+void Storage::_flash_write(uint16_t line, uint16_t num_lines)
 {
-    if (_flash.write(line*STORAGE_LINE_SIZE, STORAGE_LINE_SIZE)) {
-        // mark the line clean
-        _dirty_mask.clear(line);
+    if (_flash.write(line*STORAGE_LINE_SIZE, num_lines*STORAGE_LINE_SIZE)) {
+        // mark the lines clean
+        for (uint16_t n=0; n<num_lines; n++) {
+            _dirty_mask.clear(line+n);
+        }
     }
 }
 
@@ -400,3 +435,17 @@ bool Storage::get_storage_ptr(void *&ptr, size_t &size)
     size = sizeof(_buffer);
     return true;
 }
+
+/*
+  report storage write statistics. Write amplification is bytes
+  written to flash per byte changed by callers
+ */
+void Storage::storage_info(ExpandingString &str)
+{
+    str.printf("Written: %u bytes\n", unsigned(_write_bytes));
+#if STORAGE_USE_FLASH
+    if (_initialisedType == StorageBackend::Flash) {
+        _flash.stats_info(str, _write_bytes);
+    }
+#endif
+}
@@ -23,12 +23,28 @@
 #define STORAGE_LINE_SIZE (1<<STORAGE_LINE_SHIFT)
 #define STORAGE_NUM_LINES (HAL_STORAGE_SIZE/STORAGE_LINE_SIZE)
 
+/*
+  contiguous dirty lines are written out together, and flash writes
+  wait for storage to be idle, as on ChibiOS
+ */
+#ifndef STORAGE_FLUSH_MAX_BYTES
+#define STORAGE_FLUSH_MAX_BYTES 64
+#endif
+#ifndef STORAGE_FLUSH_IDLE_MS
+#define STORAGE_FLUSH_IDLE_MS 100
+#endif
+#ifndef STORAGE_FLUSH_MAX_DELAY_MS
+#define STORAGE_FLUSH_MAX_DELAY_MS 500
+#endif
+#define STORAGE_FLUSH_MAX_LINES (STORAGE_FLUSH_MAX_BYTES/STORAGE_LINE_SIZE)
+
 class HALSITL::Storage : public AP_HAL::Storage {
 public:
     void init() override {}
     void read_block(void *dst, uint16_t src, size_t n) override;
     void write_block(uint16_t dst, const void* src, size_t n) override;
     bool get_storage_ptr(void *&ptr, size_t &size) override;
+    void storage_info(ExpandingString &str) override;
 
     void _timer_tick(void) override;
     bool healthy(void) override;
@@ -50,6 +66,8 @@ private:
     Bitmask<STORAGE_NUM_LINES> _dirty_mask;
 
     uint32_t _last_empty_ms;
+    uint32_t _last_dirty_ms;    // last time a line was marked dirty
+    uint32_t _write_bytes;      // bytes changed by write_block(), for write amplification
 
 #if STORAGE_USE_FLASH
     bool _flash_write_data(uint8_t sector, uint32_t offset, const uint8_t *data, uint16_t length);
@@ -68,7 +86,7 @@ private:
             FUNCTOR_BIND_MEMBER(&Storage::_flash_erase_ok, bool)};
 
     void _flash_load(void);
-    void _flash_write(uint16_t line);
+    void _flash_write(uint16_t line, uint16_t num_lines);
 #endif
 
 #if STORAGE_USE_POSIX
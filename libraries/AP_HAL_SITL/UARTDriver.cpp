@@ -34,6 +34,7 @@
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <sys/select.h>
+#include <sys/uio.h>
 #include <termios.h>
 #include <sys/time.h>
 #include <arpa/inet.h>
@@ -233,6 +234,20 @@ ssize_t UARTDriver::_read(uint8_t *buffer, uint16_t count)
     return ret;
 }
 
+const uint8_t *UARTDriver::_read_span(uint32_t &n)
+{
+    return _readbuffer.readptr(n);
+}
+
+bool UARTDriver::_read_span_advance(uint32_t n)
+{
+    if (!_readbuffer.advance(n)) {
+        return false;
+    }
+    _rx_stats_bytes += n;
+    return true;
+}
+
 bool UARTDriver::_discard_input(void)
 {
     _readbuffer.clear();
@@ -263,6 +278,24 @@ void UARTDriver::_flush(void)
     }
 }
 
+/*
+  simulate byte loss at the link layer, returning the number of bytes
+  of a write of size bytes which are lost
+ */
+uint8_t UARTDriver::simulated_byte_loss(size_t size) const
+{
+#if !defined(HAL_BUILD_AP_PERIPH)
+    SITL::SIM *_sitl = AP::sitl();
+
+    if (_sitl && _sitl->uart_byte_loss_pct > 0) {
+        if (fabsf(rand_float()) < _sitl->uart_byte_loss_pct.get() * 0.01 * size) {
+            return 1;
+        }
+    }
+#endif // HAL_BUILD_AP_PERIPH
+    return 0;
+}
+
 size_t UARTDriver::_write(const uint8_t *buffer, size_t size)
 {
     const auto _txspace = txspace();
@@ -273,19 +306,7 @@ size_t UARTDriver::_write(const uint8_t *buffer, size_t size)
         return 0;
     }
 
-        /*
-          simulate byte loss at the link layer
-         */
-        uint8_t lost_byte = 0;
-#if !defined(HAL_BUILD_AP_PERIPH)
-        SITL::SIM *_sitl = AP::sitl();
-
-        if (_sitl && _sitl->uart_byte_loss_pct > 0) {
-            if (fabsf(rand_float()) < _sitl->uart_byte_loss_pct.get() * 0.01 * size) {
-                lost_byte = 1;
-            }
-        }
-#endif // HAL_BUILD_AP_PERIPH
+    const uint8_t lost_byte = simulated_byte_loss(size);
 
     // Include lost byte in tx count, we think we sent it even though it was never added to the write buffer
     _tx_stats_bytes += lost_byte;
@@ -297,6 +318,33 @@ size_t UARTDriver::_write(const uint8_t *buffer, size_t size)
     return ret;
 }
 
+/*
+  reserve space in the write buffer
+ */
+uint8_t UARTDriver::_write_reserve(ByteBuffer::IoVec vec[2], uint32_t len)
+{
+    if (txspace() < len) {
+        return 0;
+    }
+    return _writebuffer.reserve(vec, len);
+}
+
+/*
+  commit reserved space, simulating byte loss the same way as _write()
+  by leaving the last byte out of the buffer
+ */
+bool UARTDriver::_write_commit(uint32_t len)
+{
+    const uint8_t lost_byte = len > 0 ? simulated_byte_loss(len) : 0;
+    _tx_stats_bytes += lost_byte;
+
+    const bool ret = _writebuffer.commit(len - lost_byte);
+    if (_unbuffered_writes) {
+        handle_writing_from_writebuffer_to_device();
+    }
+    return ret;
+}
+
     
 /*
   start a TCP connection for the serial port. If wait_for_connection
@@ -686,6 +734,8 @@ bool UARTDriver::_select_check(int fd)
     FD_ZERO(&fds);
     FD_SET(fd, &fds);
 
+    _stats_syscalls++;
+
     // zero time means immediate return from select()
     tv.tv_sec = 0;
     tv.tv_usec = 0;
@@ -846,10 +896,10 @@ void UARTDriver::handle_writing_from_writebuffer_to_device()
         }
 #endif
         if (n > 0) {
-            // keep as a single UDP packet
-            uint8_t tmpbuf[n];
-            _writebuffer.peekbytes(tmpbuf, n);
-            ssize_t ret = send(_fd, tmpbuf, n, MSG_DONTWAIT);
+            // keep as a single UDP packet, even across the buffer wrap
+            ByteBuffer::IoVec vec[2];
+            const uint8_t n_vec = _writebuffer.peekiovec(vec, n);
+            ssize_t ret = _send_iovec(vec, n_vec);
             if (ret > 0) {
                 _writebuffer.advance(ret);
                 _tx_stats_bytes += ret;
@@ -863,6 +913,7 @@ void UARTDriver::handle_writing_from_writebuffer_to_device()
             if (_sim_serial_device != nullptr) {
                 nwritten = _sim_serial_device->write_to_device((const char*)readptr, navail);
             } else if (!_use_send_recv) {
+                _stats_syscalls++;
                 nwritten = ::write(_fd, readptr, navail);
                 if (nwritten == -1 && errno != EAGAIN && _uart_path) {
                     close(_fd);
@@ -870,7 +921,10 @@ void UARTDriver::handle_writing_from_writebuffer_to_device()
                     _connected = false;
                 }
             } else {
-                nwritten = send(_fd, readptr, navail, MSG_DONTWAIT);
+                // send both parts of a wrapped buffer in one call
+                ByteBuffer::IoVec vec[2];
+                const uint8_t n_vec = _writebuffer.peekiovec(vec, MIN(_writebuffer.available(), max_bytes));
+                nwritten = _send_iovec(vec, n_vec);
             }
             if (nwritten > 0) {
                 _writebuffer.advance(nwritten);
@@ -880,6 +934,24 @@ void UARTDriver::handle_writing_from_writebuffer_to_device()
     }
 }
 
+/*
+  send up to two parts of the write buffer with a single system call
+ */
+ssize_t UARTDriver::_send_iovec(const ByteBuffer::IoVec vec[2], uint8_t n_vec)
+{
+    struct iovec iov[2];
+    for (uint8_t i = 0; i < n_vec; i++) {
+        iov[i].iov_base = vec[i].data;
+        iov[i].iov_len = vec[i].len;
+    }
+    struct msghdr msg {};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = n_vec;
+
+    _stats_syscalls++;
+    return sendmsg(_fd, &msg, MSG_DONTWAIT);
+}
+
 void UARTDriver::handle_reading_from_device_to_readbuffer()
 {
     if (!_connected) {
@@ -913,6 +985,7 @@ void UARTDriver::handle_reading_from_device_to_readbuffer()
         if (_select_check(_mc_fd)) {
             struct sockaddr_in from;
             socklen_t fromlen = sizeof(from);
+            _stats_syscalls++;
             nread = recvfrom(_mc_fd, buf, space, MSG_DONTWAIT, (struct sockaddr *)&from, &fromlen);
             uint16_t port = ntohs(from.sin_port);
             if (_mc_myport == 0) {
@@ -941,15 +1014,21 @@ void UARTDriver::handle_reading_from_device_to_readbuffer()
             return;
         }
         int fd = _console?0:_fd;
+        _stats_syscalls++;
         nread = ::read(fd, buf, space);
         if (nread == -1 && errno != EAGAIN && _uart_path) {
             close(_fd);
             _fd = -1;
             _connected = false;
         }
+    } else if (_is_udp) {
+        // no select() needed, an empty socket returns EAGAIN
+        _stats_syscalls++;
+        nread = socket_recv_datagrams(_fd, (uint8_t *)buf, space);
     } else if (_select_check(_fd)) {
+        _stats_syscalls++;
         nread = recv(_fd, buf, space, MSG_DONTWAIT);
-        if (nread <= 0 && !_is_udp) {
+        if (nread <= 0) {
             // the socket has reached EOF
             close(_fd);
             _fd = -1;
@@ -1042,12 +1121,14 @@ void UARTDriver::uart_info(ExpandingString &str, StatsTracker &stats, const uint
 {
     const uint32_t tx_bytes = stats.tx.update(_tx_stats_bytes);
     const uint32_t rx_bytes = stats.rx.update(_rx_stats_bytes);
+    const uint32_t syscalls = _syscall_tracker.update(_stats_syscalls);
 
-    str.printf("TX=%8u RX=%8u TXBD=%6u RXBD=%6u %s (%s)\n",
+    str.printf("TX=%8u RX=%8u TXBD=%6u RXBD=%6u SYSC=%6u %s (%s)\n",
                 unsigned(tx_bytes),
                 unsigned(rx_bytes),
                 unsigned((tx_bytes * 10000) / dt_ms),
                 unsigned((rx_bytes * 10000) / dt_ms),
+                unsigned((syscalls * 1000) / dt_ms),
                 _connected ? "connected    " : "not connected",
                 _sitlState->_serial_path[_portNumber]);
 }
@@ -103,7 +103,7 @@ private:
     void _udp_start_client(const char *address, uint16_t port);
     void _udp_start_multicast(const char *address, uint16_t port);
     void _check_connection(void);
-    static bool _select_check(int );
+    bool _select_check(int );
     static void _set_nonblocking(int );
     bool set_speed(int speed) const;
 
@@ -143,6 +143,10 @@ protected:
     void _begin(uint32_t b, uint16_t rxS, uint16_t txS) override;
     size_t _write(const uint8_t *buffer, size_t size) override;
     ssize_t _read(uint8_t *buffer, uint16_t count) override;
+    const uint8_t *_read_span(uint32_t &n) override;
+    bool _read_span_advance(uint32_t n) override;
+    uint8_t _write_reserve(ByteBuffer::IoVec vec[2], uint32_t len) override;
+    bool _write_commit(uint32_t len) override;
     uint32_t _available() override;
     void _end() override;
     void _flush() override;
@@ -157,10 +161,17 @@ protected:
 private:
     void handle_writing_from_writebuffer_to_device();
     void handle_reading_from_device_to_readbuffer();
+    ssize_t _send_iovec(const ByteBuffer::IoVec vec[2], uint8_t n_vec);
+    uint8_t simulated_byte_loss(size_t size) const;
 
     // statistics
     uint32_t _tx_stats_bytes;
     uint32_t _rx_stats_bytes;
+    // system calls made on the device, for @SYS/uarts.txt
+    uint32_t _stats_syscalls;
+#if HAL_UART_STATS_ENABLED
+    StatsTracker::ByteTracker _syscall_tracker;
+#endif
 
 };
 
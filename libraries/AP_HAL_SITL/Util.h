@@ -77,6 +77,20 @@ public:
     // fills data with random values of requested size
     bool get_random_vals(uint8_t* data, size_t size) override;
 
+#if HAL_DEVICE_STATS_ENABLED
+    // request information on I2C and SPI bus utilisation
+    void bus_info(ExpandingString &str) override {
+        AP_HAL::Device::stats_info(str);
+    }
+
+#if HAL_LOGGING_ENABLED
+    // log I2C and SPI bus utilisation
+    void bus_log() override {
+        AP_HAL::Device::stats_log();
+    }
+#endif
+#endif // HAL_DEVICE_STATS_ENABLED
+
 private:
     SITL_State *sitlState;
 
@@ -283,6 +283,18 @@ public:
     // Returns newly calculated trim values if calculated
     bool get_new_trim(Vector3f &trim_rad);
 
+#if AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED
+    // start pushing each filtered gyro sample of the primary gyro to
+    // a buffer for a rate loop thread. Once enabled it stays enabled
+    bool enable_rate_loop_buffer(void);
+    bool rate_loop_buffer_enabled(void) const { return rate_loop_buffer != nullptr; }
+
+    // wait up to timeout_us for the next filtered gyro sample. If the
+    // caller has fallen behind the newest sample is returned and
+    // n_skipped is set to the number of older samples discarded
+    bool get_next_rate_loop_gyro_sample(Vector3f &gyro, uint64_t &sample_us, uint8_t &n_skipped, uint32_t timeout_us);
+#endif
+
 #if HAL_INS_ACCELCAL_ENABLED
     // initialise and register accel calibrator
     // called during the startup of accel cal
@@ -497,6 +509,13 @@ private:
 
     // Logging function
     void Write_IMU_instance(const uint64_t time_us, const uint8_t imu_instance) const;
+
+#if AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED
+    // called by backends with each filtered gyro sample
+    void push_rate_loop_gyro(uint8_t instance, const Vector3f &gyro, uint64_t sample_us);
+    class RateLoopBuffer;
+    RateLoopBuffer *rate_loop_buffer;
+#endif
     
     // backend objects
     AP_InertialSensor_Backend *_backends[INS_MAX_BACKENDS];
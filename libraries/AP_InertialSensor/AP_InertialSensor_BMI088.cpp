@@ -402,6 +402,8 @@ void AP_InertialSensor_BMI088::read_fifo_gyro(void)
     const uint8_t max_frames = 8;
     const Vector3i bad_frame{INT16_MIN,INT16_MIN,INT16_MIN};
     Vector3i data[max_frames];
+    Vector3f gyro[max_frames];
+    uint8_t n_good = 0;
 
     if (num_frames & 0x80) {
         // fifo overrun, reset, likely caused by scheduling error
@@ -431,12 +433,9 @@ void AP_InertialSensor_BMI088::read_fifo_gyro(void)
         if (data[i] == bad_frame) {
             continue;
         }
-        Vector3f gyro(data[i].x, data[i].y, data[i].z);
-        gyro *= scale;
-
-        _rotate_and_correct_gyro(gyro_instance, gyro);
-        _notify_new_gyro_raw_sample(gyro_instance, gyro);
+        gyro[n_good++] = Vector3f(data[i].x, data[i].y, data[i].z) * scale;
     }
+    _notify_new_gyro_raw_samples(gyro_instance, gyro, n_good);
 
 check_next:
     AP_HAL::Device::checkreg reg;
@@ -68,16 +68,17 @@ bool AP_InertialSensor_Backend::sensors_converging() const
 
   FIFO sensors produce samples at a fixed rate, but the clock in the
   sensor may vary slightly from the system clock. This slowly adjusts
-  the rate to the observed rate
+  the rate to the observed rate. n_samples is the number of samples
+  that arrived together
 */
-void AP_InertialSensor_Backend::_update_sensor_rate(uint16_t &count, uint32_t &start_us, float &rate_hz) const
+void AP_InertialSensor_Backend::_update_sensor_rate(uint16_t &count, uint32_t &start_us, float &rate_hz, uint8_t n_samples) const
 {
     uint32_t now = AP_HAL::micros();
     if (start_us == 0) {
-        count = 0;
+        count = n_samples - 1;
         start_us = now;
     } else {
-        count++;
+        count += n_samples;
         if (now - start_us > 1000000UL) {
             float observed_rate_hz = count * 1.0e6f / (now - start_us);
 #if 0
@@ -352,6 +353,9 @@ void AP_InertialSensor_Backend::_notify_new_gyro_raw_sample(uint8_t instance,
 
         // apply gyro filters and sample for FFT
         apply_gyro_filters(instance, gyro);
+#if AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED
+        _imu.push_rate_loop_gyro(instance, _imu._gyro_filtered[instance], sample_us);
+#endif
 
         _imu._new_gyro_data[instance] = true;
     }
@@ -360,6 +364,157 @@ void AP_InertialSensor_Backend::_notify_new_gyro_raw_sample(uint8_t instance,
     log_gyro_raw(instance, sample_us, gyro, _imu._gyro_filtered[instance]);
 }
 
+/*
+  return the matrix taking a sample from the sensor frame to the body
+  frame, applying the sensor rotation, a sensor frame scale and the
+  board rotation. The matrix is only rebuilt when one of them changes
+ */
+const Matrix3f &AP_InertialSensor_Backend::sensor_to_body(SensorToBody &cache, uint8_t instance,
+                                                          enum Rotation sensor_rotation, enum Rotation board_rotation,
+                                                          const Vector3f &scale)
+{
+    // custom rotations can be changed at any time so are never cached
+    if (!cache.valid ||
+        cache.instance != instance ||
+        cache.sensor_rotation != sensor_rotation ||
+        cache.board_rotation != board_rotation ||
+        cache.scale != scale ||
+        sensor_rotation >= ROTATION_MAX ||
+        board_rotation >= ROTATION_MAX) {
+        Matrix3f sensor_m, board_m;
+        sensor_m.from_rotation(sensor_rotation);
+        board_m.from_rotation(board_rotation);
+        // multiplying the columns of the board rotation by the scale
+        // scales in the rotated sensor frame
+        for (uint8_t i = 0; i < 3; i++) {
+            board_m[i].x *= scale.x;
+            board_m[i].y *= scale.y;
+            board_m[i].z *= scale.z;
+        }
+        cache.m = board_m * sensor_m;
+        cache.scale = scale;
+        cache.instance = instance;
+        cache.sensor_rotation = sensor_rotation;
+        cache.board_rotation = board_rotation;
+        cache.valid = true;
+    }
+    return cache.m;
+}
+
+/*
+  handle a block of gyro samples read together from a sensor FIFO
+ */
+void AP_InertialSensor_Backend::_notify_new_gyro_raw_samples(uint8_t instance, Vector3f *gyro, uint8_t n_samples)
+{
+    if (n_samples == 0 || has_been_killed(instance)) {
+        return;
+    }
+
+    const enum Rotation sensor_rotation = _imu._gyro_orientation[instance];
+    const enum Rotation board_rotation = _imu._board_orientation;
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+    const float temperature = _imu.get_temperature(instance);
+    const bool tcal_learning = _imu.tcal_learning;
+#else
+    const bool tcal_learning = false;
+#endif
+
+    /*
+      the temperature correction only depends on temperature, which
+      is fixed for the block, so it is folded into a single offset
+     */
+    Vector3f offset;
+    if (!_imu._calibrating_gyro) {
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+        _imu.tcal(instance).correct_gyro(temperature, _imu.caltemp_gyro(instance), offset);
+#endif
+        offset -= _imu._gyro_offset(instance).get();
+    }
+
+    if (tcal_learning) {
+        // learning needs each sample in the sensor frame
+        for (uint8_t i = 0; i < n_samples; i++) {
+            Vector3f &g = gyro[i];
+            g.rotate(sensor_rotation);
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+            _imu.tcal(instance).update_gyro_learning(g, temperature);
+#endif
+            g += offset;
+            g.rotate(board_rotation);
+        }
+    } else {
+        // one fused sensor to body rotation per sample
+        const Matrix3f &m = sensor_to_body(_gyro_to_body, instance, sensor_rotation, board_rotation, Vector3f{1, 1, 1});
+        offset.rotate(board_rotation);
+        for (uint8_t i = 0; i < n_samples; i++) {
+            gyro[i] = m * gyro[i] + offset;
+        }
+    }
+
+    _update_sensor_rate(_imu._sample_gyro_count[instance], _imu._sample_gyro_start_us[instance],
+                        _imu._gyro_raw_sample_rates[instance], n_samples);
+
+    // don't accept below 40Hz
+    if (_imu._gyro_raw_sample_rates[instance] < 40) {
+        return;
+    }
+
+    const float dt = 1.0f / _imu._gyro_raw_sample_rates[instance];
+    const uint32_t sample_period_us = dt * 1.0e6f;
+    const uint64_t last_sample_us = _imu._gyro_last_sample_us[instance];
+    const uint64_t now = AP_HAL::micros64();
+    _imu._gyro_last_sample_us[instance] = now;
+
+    WITH_SEMAPHORE(_sem);
+
+    // zero accumulator if sensor was unhealthy for 0.1s, the first
+    // sample of the block then contributes no delta angle
+    float sample_dt = dt;
+    if (now - last_sample_us > 100000U) {
+        _imu._delta_angle_acc[instance].zero();
+        _imu._delta_angle_acc_dt[instance] = 0;
+        sample_dt = 0;
+    }
+
+    for (uint8_t i = 0; i < n_samples; i++) {
+        const Vector3f &g = gyro[i];
+        // the samples were taken at the sensor rate, ending now
+        const uint64_t sample_us = now - uint64_t(n_samples - 1 - i) * sample_period_us;
+
+#if AP_MODULE_SUPPORTED
+        AP_Module::call_hook_gyro_sample(instance, dt, g);
+#endif
+
+        if (hal.opticalflow) {
+            hal.opticalflow->push_gyro(g.x, g.y, dt);
+        }
+
+        // delta angle and coning correction as in _notify_new_gyro_raw_sample()
+        const Vector3f delta_angle = (g + _imu._last_raw_gyro[instance]) * 0.5f * sample_dt;
+        Vector3f delta_coning = (_imu._delta_angle_acc[instance] +
+                                 _imu._last_delta_angle[instance] * (1.0f / 6.0f));
+        delta_coning = delta_coning % delta_angle;
+        delta_coning *= 0.5f;
+
+        _imu._delta_angle_acc[instance] += delta_angle + delta_coning;
+        _imu._delta_angle_acc_dt[instance] += sample_dt;
+
+        _imu._last_delta_angle[instance] = delta_angle;
+        _imu._last_raw_gyro[instance] = g;
+
+        apply_gyro_filters(instance, g);
+#if AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED
+        _imu.push_rate_loop_gyro(instance, _imu._gyro_filtered[instance], sample_us);
+#endif
+
+        log_gyro_raw(instance, sample_us, g, _imu._gyro_filtered[instance]);
+
+        sample_dt = dt;
+    }
+
+    _imu._new_gyro_data[instance] = true;
+}
+
 /*
   handle a delta-angle sample from the backend. This assumes FIFO
   style sampling and the sample should not be rotated or corrected for
@@ -440,6 +595,9 @@ void AP_InertialSensor_Backend::_notify_new_delta_angle(uint8_t instance, const
 
         // apply gyro filters and sample for FFT
         apply_gyro_filters(instance, gyro);
+#if AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED
+        _imu.push_rate_loop_gyro(instance, _imu._gyro_filtered[instance], sample_us);
+#endif
 
         _imu._new_gyro_data[instance] = true;
     }
@@ -604,6 +762,126 @@ void AP_InertialSensor_Backend::_notify_new_accel_raw_sample(uint8_t instance,
 #endif
 }
 
+/*
+  handle a block of accel samples read together from a sensor FIFO
+ */
+void AP_InertialSensor_Backend::_notify_new_accel_raw_samples(uint8_t instance, Vector3f *accel, uint8_t n_samples)
+{
+    if (n_samples == 0 || has_been_killed(instance)) {
+        return;
+    }
+
+    const enum Rotation sensor_rotation = _imu._accel_orientation[instance];
+    const enum Rotation board_rotation = _imu._board_orientation;
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+    const float temperature = _imu.get_temperature(instance);
+    const bool tcal_learning = _imu.tcal_learning;
+#else
+    const bool tcal_learning = false;
+#endif
+    const bool apply_cal = !_imu._calibrating_accel && (_imu._acal == nullptr
+#if HAL_INS_ACCELCAL_ENABLED
+        || !_imu._acal->running()
+#endif
+    );
+
+    // as for gyros the temperature correction is folded into the offset
+    Vector3f offset;
+    Vector3f scale { 1, 1, 1 };
+    if (apply_cal) {
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+        _imu.tcal(instance).correct_accel(temperature, _imu.caltemp_accel(instance), offset);
+#endif
+        offset -= _imu._accel_offset(instance).get();
+        scale = _imu._accel_scale(instance).get();
+    }
+
+    if (tcal_learning) {
+        // learning needs each sample in the sensor frame
+        for (uint8_t i = 0; i < n_samples; i++) {
+            Vector3f &a = accel[i];
+            a.rotate(sensor_rotation);
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+            _imu.tcal(instance).update_accel_learning(a, temperature);
+#endif
+            a += offset;
+            a.x *= scale.x;
+            a.y *= scale.y;
+            a.z *= scale.z;
+            a.rotate(board_rotation);
+        }
+    } else {
+        // the scale is folded into the fused rotation, and the
+        // scaled offset is rotated to the body frame once
+        const Matrix3f &m = sensor_to_body(_accel_to_body, instance, sensor_rotation, board_rotation, scale);
+        offset.x *= scale.x;
+        offset.y *= scale.y;
+        offset.z *= scale.z;
+        offset.rotate(board_rotation);
+        for (uint8_t i = 0; i < n_samples; i++) {
+            accel[i] = m * accel[i] + offset;
+        }
+    }
+
+    _update_sensor_rate(_imu._sample_accel_count[instance], _imu._sample_accel_start_us[instance],
+                        _imu._accel_raw_sample_rates[instance], n_samples);
+
+    // don't accept below 40Hz
+    if (_imu._accel_raw_sample_rates[instance] < 40) {
+        return;
+    }
+
+    const float dt = 1.0f / _imu._accel_raw_sample_rates[instance];
+    const uint32_t sample_period_us = dt * 1.0e6f;
+    const uint64_t last_sample_us = _imu._accel_last_sample_us[instance];
+    const uint64_t now = AP_HAL::micros64();
+    _imu._accel_last_sample_us[instance] = now;
+#if AP_INERTIALSENSOR_BATCHSAMPLER_ENABLED
+    const bool post_filter_logging = _imu.batchsampler.doing_post_filter_logging();
+#endif
+
+    WITH_SEMAPHORE(_sem);
+
+    // zero accumulator if sensor was unhealthy for 0.1s
+    float sample_dt = dt;
+    if (now - last_sample_us > 100000U) {
+        _imu._delta_velocity_acc[instance].zero();
+        _imu._delta_velocity_acc_dt[instance] = 0;
+        sample_dt = 0;
+    }
+
+    for (uint8_t i = 0; i < n_samples; i++) {
+        const Vector3f &a = accel[i];
+        const uint64_t sample_us = now - uint64_t(n_samples - 1 - i) * sample_period_us;
+
+#if AP_MODULE_SUPPORTED
+        AP_Module::call_hook_accel_sample(instance, dt, a, false);
+#endif
+
+        _imu.calc_vibration_and_clipping(instance, a, dt);
+
+        _imu._delta_velocity_acc[instance] += a * sample_dt;
+        _imu._delta_velocity_acc_dt[instance] += sample_dt;
+
+        _imu._accel_filtered[instance] = _imu._accel_filter[instance].apply(a);
+        if (_imu._accel_filtered[instance].is_nan() || _imu._accel_filtered[instance].is_inf()) {
+            _imu._accel_filter[instance].reset();
+        }
+
+        _imu.set_accel_peak_hold(instance, _imu._accel_filtered[instance]);
+
+#if AP_INERTIALSENSOR_BATCHSAMPLER_ENABLED
+        log_accel_raw(instance, sample_us, post_filter_logging ? _imu._accel_filtered[instance] : a);
+#else
+        log_accel_raw(instance, sample_us, a);
+#endif
+
+        sample_dt = dt;
+    }
+
+    _imu._new_accel_data[instance] = true;
+}
+
 /*
   handle a delta-velocity sample from the backend. This assumes FIFO style sampling and
   the sample should not be rotated or corrected for offsets
@@ -190,6 +190,15 @@ protected:
     // sensors, and should be set to zero for FIFO based sensors
     void _notify_new_accel_raw_sample(uint8_t instance, const Vector3f &accel, uint64_t sample_us=0, bool fsync_set=false) __RAMFUNC__;
 
+    // block versions of _rotate_and_correct_*() followed by
+    // _notify_new_*_raw_sample() for FIFO based sensors. The samples
+    // are scaled but not yet rotated or corrected, they are rotated
+    // and corrected in place. Kill, calibration and rate checks are
+    // made once per block and the backend semaphore is taken once per
+    // block rather than once per sample
+    void _notify_new_gyro_raw_samples(uint8_t instance, Vector3f *gyro, uint8_t n_samples) __RAMFUNC__;
+    void _notify_new_accel_raw_samples(uint8_t instance, Vector3f *accel, uint8_t n_samples) __RAMFUNC__;
+
     // alternative interface using delta-velocities. Rotation and correction is handled inside this function
     void _notify_new_delta_velocity(uint8_t instance, const Vector3f &dvelocity);
     
@@ -226,7 +235,7 @@ protected:
     }
 
     // update the sensor rate for FIFO sensors
-    void _update_sensor_rate(uint16_t &count, uint32_t &start_us, float &rate_hz) const __RAMFUNC__;
+    void _update_sensor_rate(uint16_t &count, uint32_t &start_us, float &rate_hz, uint8_t n_samples=1) const __RAMFUNC__;
 
     // return true if the sensors are still converging and sampling rates could change significantly
     bool sensors_converging() const;
@@ -349,6 +358,22 @@ protected:
 
 private:
 
+    // cached fused rotation used by the block sample functions
+    struct SensorToBody {
+        Matrix3f m;
+        Vector3f scale;
+        uint8_t instance;
+        enum Rotation sensor_rotation;
+        enum Rotation board_rotation;
+        bool valid;
+    };
+    SensorToBody _gyro_to_body;
+    SensorToBody _accel_to_body;
+
+    const Matrix3f &sensor_to_body(SensorToBody &cache, uint8_t instance,
+                                   enum Rotation sensor_rotation, enum Rotation board_rotation,
+                                   const Vector3f &scale) __RAMFUNC__;
+
     bool should_log_imu_raw() const ;
     void log_accel_raw(uint8_t instance, const uint64_t sample_us, const Vector3f &accel) __RAMFUNC__;
     void log_gyro_raw(uint8_t instance, const uint64_t sample_us, const Vector3f &raw_gyro, const Vector3f &filtered_gyro) __RAMFUNC__;
@@ -439,6 +439,17 @@ void AP_InertialSensor_Invensense::start()
         AP_HAL::panic("Invensense: Unable to allocate FIFO buffer");
     }
 
+    // the read flag is only set on SPI
+    _fifo_count_reg = MPUREG_FIFO_COUNTH;
+    if (_dev->bus_type() == AP_HAL::Device::BUS_TYPE_SPI) {
+        _fifo_count_reg |= 0x80;
+    }
+    _fifo_count_xfer.send = &_fifo_count_reg;
+    _fifo_count_xfer.send_len = 1;
+    _fifo_count_xfer.recv = _fifo_buffer;
+    _fifo_count_xfer.recv_len = 2;
+    _fifo_count_xfer.cb = FUNCTOR_BIND_MEMBER(&AP_InertialSensor_Invensense::_read_fifo, void, bool);
+
     // start the timer process to read samples, using the fastest rate avilable
     _dev->register_periodic_callback(1000000UL / _gyro_backend_rate_hz, FUNCTOR_BIND_MEMBER(&AP_InertialSensor_Invensense::_poll_data, void));
 }
@@ -528,7 +539,7 @@ bool AP_InertialSensor_Invensense::_data_ready()
  */
 void AP_InertialSensor_Invensense::_poll_data()
 {
-    _read_fifo();
+    _dev->queue_transfer(_fifo_count_xfer);
 
 #if INVENSENSE_DEBUG_REG_CHANGE
     _check_register_change();
@@ -720,14 +731,18 @@ bool AP_InertialSensor_Invensense::_accumulate_sensor_rate_sampling(uint8_t *sam
     return ret;
 }
 
-void AP_InertialSensor_Invensense::_read_fifo()
+/*
+  called from the bus thread with the semaphore held once the FIFO count
+  has been read into _fifo_buffer
+ */
+void AP_InertialSensor_Invensense::_read_fifo(bool count_ok)
 {
     uint8_t n_samples;
     uint16_t bytes_read;
     uint8_t *rx = _fifo_buffer;
     bool need_reset = false;
 
-    if (!_block_read(MPUREG_FIFO_COUNTH, rx, 2)) {
+    if (!count_ok) {
         goto check_registers;
     }
 
@@ -95,8 +95,9 @@ private:
 
     bool _has_auxiliary_bus();
 
-    /* Read samples from FIFO (FIFO enabled) */
-    void _read_fifo() __RAMFUNC__;
+    /* Read samples from FIFO (FIFO enabled), once the queued read of
+       the FIFO count has completed */
+    void _read_fifo(bool count_ok) __RAMFUNC__;
 
     /* Check if there's data available by either reading DRDY pin or register */
     bool _data_ready() __RAMFUNC__;
@@ -178,6 +179,11 @@ private:
     // buffer for fifo read
     uint8_t *_fifo_buffer;
 
+    // read of the FIFO count into _fifo_buffer, queued on the bus so
+    // it can be batched with the other devices sharing it
+    AP_HAL::Device::QueuedTransfer _fifo_count_xfer;
+    uint8_t _fifo_count_reg;
+
     /*
       accumulators for sensor_rate sampling
       See description in _accumulate_sensor_rate_sampling()
@@ -405,6 +405,12 @@ bool AP_InertialSensor_Invensensev3::accumulate_samples(const FIFOData *data, ui
 #if INV3_ENABLE_FIFO_LOGGING
     const uint64_t tstart = AP_HAL::micros64();
 #endif
+    Vector3f accel[INV3_FIFO_BUFFER_LEN];
+    Vector3f gyro[INV3_FIFO_BUFFER_LEN];
+    uint8_t n_good = 0;
+    bool ret = true;
+
+    n_samples = MIN(n_samples, INV3_FIFO_BUFFER_LEN);
     for (uint8_t i = 0; i < n_samples; i++) {
         const FIFOData &d = data[i];
 
@@ -413,32 +419,28 @@ bool AP_InertialSensor_Invensensev3::accumulate_samples(const FIFOData *data, ui
         // ICM45686 - TMST_FIELD_EN bit 3 : 1
         // ICM42688 - HEADER_TIMESTAMP_FSYNC bit 2-3 : 10
         if ((d.header & 0xFC) != 0x68) { // ACCEL_EN | GYRO_EN | TMST_FIELD_EN
-            // no or bad data
-            return false;
+            // no or bad data, still use the good samples before it
+            ret = false;
+            break;
         }
 
-        Vector3f accel{float(d.accel[0]), float(d.accel[1]), float(d.accel[2])};
-        Vector3f gyro{float(d.gyro[0]), float(d.gyro[1]), float(d.gyro[2])};
-
-        accel *= accel_scale;
-        gyro *= gyro_scale;
+        accel[i] = Vector3f{float(d.accel[0]), float(d.accel[1]), float(d.accel[2])} * accel_scale;
+        gyro[i] = Vector3f{float(d.gyro[0]), float(d.gyro[1]), float(d.gyro[2])} * gyro_scale;
 
 #if INV3_ENABLE_FIFO_LOGGING
-        Write_GYR(gyro_instance, tstart+(i*backend_period_us), gyro, true);
+        Write_GYR(gyro_instance, tstart+(i*backend_period_us), gyro[i], true);
 #endif
 
         const float temp = d.temperature * temp_sensitivity + temp_zero;
-
-        // these four calls are about 40us
-        _rotate_and_correct_accel(accel_instance, accel);
-        _rotate_and_correct_gyro(gyro_instance, gyro);
-
-        _notify_new_accel_raw_sample(accel_instance, accel, 0);
-        _notify_new_gyro_raw_sample(gyro_instance, gyro);
-
         temp_filtered = temp_filter.apply(temp);
+        n_good++;
     }
-    return true;
+
+    // rotate, correct and notify the whole block at once
+    _notify_new_accel_raw_samples(accel_instance, accel, n_good);
+    _notify_new_gyro_raw_samples(gyro_instance, gyro, n_good);
+
+    return ret;
 }
 
 #if HAL_INS_HIGHRES_SAMPLE
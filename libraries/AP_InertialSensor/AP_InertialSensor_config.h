@@ -51,6 +51,11 @@
 #define AP_INERTIALSENSOR_HARMONICNOTCH_ENABLED AP_INERTIALSENSOR_ENABLED
 #endif
 
+// buffer of filtered gyro samples for a vehicle rate loop thread
+#ifndef AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED
+#define AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED (AP_INERTIALSENSOR_ENABLED && HAL_MEM_CLASS >= HAL_MEM_CLASS_300)
+#endif
+
 #ifndef AP_INERTIALSENSOR_ALLOW_NO_SENSORS
 #define AP_INERTIALSENSOR_ALLOW_NO_SENSORS 0
 #endif
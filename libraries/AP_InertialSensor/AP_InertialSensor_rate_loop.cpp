@@ -0,0 +1,112 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  buffer of filtered gyro samples for a vehicle rate loop thread
+ */
+
+#include "AP_InertialSensor_config.h"
+
+#if AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED
+
+#include "AP_InertialSensor.h"
+#include <AP_HAL/AP_HAL.h>
+#include <AP_AHRS/AP_AHRS.h>
+
+// enough for the rate thread to miss a few samples at 8kHz
+#define RATE_LOOP_BUFFER_SIZE 8
+
+/*
+  the rate thread is the only consumer. Any backend thread can push,
+  as the primary gyro can change while backends are running, so the
+  locked ObjectBuffer_TS is used. The semaphore wakes the rate thread
+  on each push
+ */
+class AP_InertialSensor::RateLoopBuffer {
+public:
+    struct Sample {
+        Vector3f gyro;
+        uint64_t sample_us;
+    };
+    ObjectBuffer_TS<Sample> samples{RATE_LOOP_BUFFER_SIZE};
+    HAL_BinarySemaphore sem;
+};
+
+bool AP_InertialSensor::enable_rate_loop_buffer(void)
+{
+    if (rate_loop_buffer != nullptr) {
+        return true;
+    }
+    RateLoopBuffer *buf = NEW_NOTHROW RateLoopBuffer;
+    if (buf == nullptr || buf->samples.get_size() == 0) {
+        delete buf;
+        return false;
+    }
+    rate_loop_buffer = buf;
+    return true;
+}
+
+/*
+  push a filtered gyro sample, called from the backend with its
+  semaphore held
+ */
+void AP_InertialSensor::push_rate_loop_gyro(uint8_t instance, const Vector3f &gyro, uint64_t sample_us)
+{
+    RateLoopBuffer *buf = rate_loop_buffer;
+    if (buf == nullptr) {
+        return;
+    }
+#if AP_AHRS_ENABLED
+    const uint8_t primary = AP::ahrs().get_primary_gyro_index();
+#else
+    const uint8_t primary = _first_usable_gyro;
+#endif
+    if (instance != primary) {
+        return;
+    }
+    // if the rate thread has fallen so far behind that the buffer is
+    // full the oldest sample is dropped, never the newest
+    buf->samples.push_force(RateLoopBuffer::Sample{gyro, sample_us});
+    buf->sem.signal();
+}
+
+bool AP_InertialSensor::get_next_rate_loop_gyro_sample(Vector3f &gyro, uint64_t &sample_us, uint8_t &n_skipped, uint32_t timeout_us)
+{
+    RateLoopBuffer *buf = rate_loop_buffer;
+    if (buf == nullptr) {
+        return false;
+    }
+    while (buf->samples.is_empty()) {
+        if (!buf->sem.wait(timeout_us)) {
+            return false;
+        }
+    }
+    // drain to the newest sample, the rate controllers want the
+    // latest gyro rather than to work through a backlog
+    RateLoopBuffer::Sample s;
+    if (!buf->samples.pop(s)) {
+        return false;
+    }
+    RateLoopBuffer::Sample newer;
+    n_skipped = 0;
+    while (buf->samples.pop(newer)) {
+        s = newer;
+        n_skipped++;
+    }
+    gyro = s.gyro;
+    sample_us = s.sample_us;
+    return true;
+}
+
+#endif // AP_INERTIALSENSOR_RATE_LOOP_BUFFER_ENABLED
@@ -36,6 +36,14 @@
 // timeout calibration after 10 minutes, if no temperature rise
 #define CAL_TIMEOUT_MS (600U*1000U)
 
+/*
+  the cached correction is extrapolated from its slope for changes of
+  up to 0.5C. The error is bounded by the second derivative of the
+  polynomial times 0.125
+ */
+#define TCAL_CACHE_TEMP_STEP 0.5
+#define TCAL_CACHE_UPDATE_MS 1000U
+
 /*
   we use a fixed reference temperature of 35C. This has the advantage
   that we don't need to know the final temperature when doing an
@@ -208,37 +216,65 @@ Vector3f AP_InertialSensor_TCal::polynomial_eval(float tdiff, const AP_Vector3f
     return (c[0] + (c[1] + c[2]*tdiff)*tdiff)*tdiff*INV_SCALE_FACTOR;
 }
 
+/*
+  evaluate the derivative of the polynomial with respect to temperature
+ */
+Vector3f AP_InertialSensor_TCal::polynomial_slope(float tdiff, const AP_Vector3f coeff[3]) const
+{
+    const Vector3f *c = (Vector3f *)&coeff[0];
+    return (c[0] + (c[1]*2 + c[2]*(3*tdiff))*tdiff)*INV_SCALE_FACTOR;
+}
+
 /*
   correct a single sensor for the current temperature
  */
-void AP_InertialSensor_TCal::correct_sensor(float temperature, float cal_temp, const AP_Vector3f coeff[3], Vector3f &v) const
+void AP_InertialSensor_TCal::correct_sensor(float temperature, float cal_temp, const AP_Vector3f coeff[3], CorrectionCache &cache, Vector3f &v) const
 {
     if (enable != Enable::Enabled) {
+        cache.valid = false;
         return;
     }
     temperature = constrain_float(temperature, temp_min, temp_max);
     cal_temp = constrain_float(cal_temp, temp_min, temp_max);
 
+    const float tdelta = temperature - cache.temperature;
+    const uint32_t now_ms = AP_HAL::millis();
+    if (cache.valid &&
+        fabsf(tdelta) <= TCAL_CACHE_TEMP_STEP &&
+        is_equal(cal_temp, cache.cal_temp) &&
+        now_ms - cache.update_ms < TCAL_CACHE_UPDATE_MS) {
+        v += cache.correction + cache.slope * tdelta;
+        return;
+    }
 
     // get the polynomial correction for the difference between the
     // current temperature and the mid temperature
-    v -= polynomial_eval(temperature - TEMP_REFERENCE, coeff);
+    cache.correction = -polynomial_eval(temperature - TEMP_REFERENCE, coeff);
 
     // we need to add the correction for the temperature
     // difference between the TREF, which is the reference used for
     // the calibration process, and the cal_temp, which is the
     // temperature that the offsets and scale factors was setup for
-    v += polynomial_eval(cal_temp - TEMP_REFERENCE, coeff);
+    cache.correction += polynomial_eval(cal_temp - TEMP_REFERENCE, coeff);
+
+    // only the first term depends on the current temperature
+    cache.slope = -polynomial_slope(temperature - TEMP_REFERENCE, coeff);
+    cache.temperature = temperature;
+    cache.cal_temp = cal_temp;
+    cache.update_ms = now_ms;
+    cache.valid = true;
+
+    v += cache.correction;
 }
 
 void AP_InertialSensor_TCal::correct_accel(float temperature, float cal_temp, Vector3f &accel) const
 {
-    correct_sensor(temperature, cal_temp, accel_coeff, accel);
+    correct_sensor(temperature, cal_temp, accel_coeff, accel_cache, accel);
 }
 
 void AP_InertialSensor_TCal::correct_gyro(float temperature, float cal_temp, Vector3f &gyro) const
 {
-    correct_sensor(temperature, cal_temp, gyro_coeff, gyro);
+    correct_sensor(temperature, cal_temp, gyro_coeff, gyro_cache, gyro);
 }
 
 /*
@@ -439,6 +475,8 @@ bool AP_InertialSensor_TCal::Learn::save_calibration(float temperature)
     }
     tcal.temp_min.set_and_save_ifchanged(start_temp);
     tcal.temp_max.set_and_save_ifchanged(temperature);
+    tcal.accel_cache.valid = false;
+    tcal.gyro_cache.valid = false;
     return true;
 }
 
@@ -7,6 +7,7 @@
 
 // AP_InertialSensor_TCal class is public for use by SITL
 class AP_InertialSensor_TCal {
+    friend class AP_InertialSensor_TCal_Test;
 public:
     static const struct AP_Param::GroupInfo var_info[];
     void correct_accel(float temperature, float cal_temp, Vector3f &accel) const;
@@ -73,8 +74,27 @@ private:
     Vector3f gyro_tref;
     Learn *learn;
 
-    void correct_sensor(float temperature, float cal_temp, const AP_Vector3f coeff[3], Vector3f &v) const;
+    /*
+      IMU temperature changes slowly compared to the sample rate, so
+      the correction is cached along with its slope and extrapolated
+      for small temperature changes, with a full evaluation when the
+      temperature moves by more than TCAL_CACHE_TEMP_STEP or at
+      TCAL_CACHE_UPDATE_MS to pick up parameter changes
+     */
+    struct CorrectionCache {
+        Vector3f correction;
+        Vector3f slope;
+        float temperature;
+        float cal_temp;
+        uint32_t update_ms;
+        bool valid;
+    };
+    mutable CorrectionCache accel_cache;
+    mutable CorrectionCache gyro_cache;
+
+    void correct_sensor(float temperature, float cal_temp, const AP_Vector3f coeff[3], CorrectionCache &cache, Vector3f &v) const;
     Vector3f polynomial_eval(float temperature, const AP_Vector3f coeff[3]) const;
+    Vector3f polynomial_slope(float tdiff, const AP_Vector3f coeff[3]) const;
 
     // get instance number
     uint8_t instance(void) const;
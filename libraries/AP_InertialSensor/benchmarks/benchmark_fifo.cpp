@@ -0,0 +1,97 @@
+/*
+  benchmark per-sample against block ingestion of FIFO samples with
+  three IMUs at 8kHz, read in blocks of 8 samples as the Invensensev3
+  driver does
+ */
+#include <AP_gbenchmark.h>
+
+#include <AP_InertialSensor/AP_InertialSensor.h>
+#include <AP_InertialSensor/AP_InertialSensor_Backend.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static const uint8_t num_imus = 3;
+static const uint16_t sample_rate_hz = 8000;
+static const uint8_t block_len = 8;
+
+class AP_InertialSensor_Bench : public AP_InertialSensor_Backend
+{
+public:
+    AP_InertialSensor_Bench(AP_InertialSensor &imu, uint32_t id) :
+        AP_InertialSensor_Backend(imu)
+    {
+        _imu.register_gyro(gyro_instance, sample_rate_hz, id);
+        _imu.register_accel(accel_instance, sample_rate_hz, id);
+    }
+
+    bool update() override { return true; }
+
+    void push_per_sample(const Vector3f *accel, const Vector3f *gyro)
+    {
+        for (uint8_t i = 0; i < block_len; i++) {
+            Vector3f a = accel[i];
+            Vector3f g = gyro[i];
+            _rotate_and_correct_accel(accel_instance, a);
+            _rotate_and_correct_gyro(gyro_instance, g);
+            _notify_new_accel_raw_sample(accel_instance, a);
+            _notify_new_gyro_raw_sample(gyro_instance, g);
+        }
+    }
+
+    void push_block(const Vector3f *accel, const Vector3f *gyro)
+    {
+        Vector3f a[block_len];
+        Vector3f g[block_len];
+        memcpy(a, accel, sizeof(a));
+        memcpy(g, gyro, sizeof(g));
+        _notify_new_accel_raw_samples(accel_instance, a, block_len);
+        _notify_new_gyro_raw_samples(gyro_instance, g, block_len);
+    }
+};
+
+static AP_InertialSensor ins;
+static AP_InertialSensor_Bench *backends[num_imus];
+static Vector3f accel_samples[block_len];
+static Vector3f gyro_samples[block_len];
+
+static void setup_backends()
+{
+    if (backends[0] != nullptr) {
+        return;
+    }
+    for (uint8_t i = 0; i < num_imus; i++) {
+        backends[i] = NEW_NOTHROW AP_InertialSensor_Bench(ins, 0x100 + i);
+    }
+    for (uint8_t i = 0; i < block_len; i++) {
+        accel_samples[i] = Vector3f(0.1f * i, -0.2f, -GRAVITY_MSS);
+        gyro_samples[i] = Vector3f(0.01f, -0.02f * i, 0.03f);
+    }
+}
+
+static void BM_FIFOPerSample(benchmark::State& state)
+{
+    setup_backends();
+    while (state.KeepRunning()) {
+        for (uint8_t i = 0; i < num_imus; i++) {
+            backends[i]->push_per_sample(accel_samples, gyro_samples);
+        }
+        gbenchmark_escape(backends[0]);
+    }
+}
+
+BENCHMARK(BM_FIFOPerSample);
+
+static void BM_FIFOBlock(benchmark::State& state)
+{
+    setup_backends();
+    while (state.KeepRunning()) {
+        for (uint8_t i = 0; i < num_imus; i++) {
+            backends[i]->push_block(accel_samples, gyro_samples);
+        }
+        gbenchmark_escape(backends[0]);
+    }
+}
+
+BENCHMARK(BM_FIFOBlock);
+
+BENCHMARK_MAIN();
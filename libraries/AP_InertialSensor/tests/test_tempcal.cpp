@@ -0,0 +1,109 @@
+#include <AP_gtest.h>
+
+#include <AP_InertialSensor/AP_InertialSensor.h>
+#include <AP_InertialSensor/AP_InertialSensor_tempcal.h>
+
+const AP_HAL::HAL &hal = AP_HAL::get_HAL();
+
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+
+/*
+  check the cached temperature correction against a full polynomial
+  evaluation while the temperature moves up and down across the
+  calibration range
+ */
+class AP_InertialSensor_TCal_Test
+{
+public:
+    AP_InertialSensor_TCal_Test()
+    {
+        tcal.enable.set(AP_InertialSensor_TCal::Enable::Enabled);
+        tcal.temp_min.set(0);
+        tcal.temp_max.set(70);
+        // coefficients are scaled by 1e6, these are larger than
+        // typically learnt to give a pessimistic curvature
+        tcal.accel_coeff[0].set(Vector3f(12500, -8000, 20000));
+        tcal.accel_coeff[1].set(Vector3f(100, -150, 50));
+        tcal.accel_coeff[2].set(Vector3f(5, -4, 3));
+        tcal.gyro_coeff[0].set(Vector3f(300, -200, 150));
+        tcal.gyro_coeff[1].set(Vector3f(5, -3, 2));
+        tcal.gyro_coeff[2].set(Vector3f(0.2, -0.1, 0.15));
+    }
+
+    // correction from a full evaluation in double precision
+    static double exact(float temperature, float cal_temp, const AP_Vector3f coeff[3], uint8_t axis)
+    {
+        double sum = 0;
+        for (int8_t k = 2; k >= 0; k--) {
+            const double c = coeff[k].get()[axis];
+            const double tc = cal_temp - 35.0;
+            const double t = temperature - 35.0;
+            sum += c * (pow(tc, k+1) - pow(t, k+1));
+        }
+        return sum * 1.0e-6;
+    }
+
+    // worst case error of linear extrapolation over the cache step
+    static double bound(const AP_Vector3f coeff[3], uint8_t axis)
+    {
+        const double c1 = coeff[1].get()[axis];
+        const double c2 = coeff[2].get()[axis];
+        // second derivative is largest at the ends of the range
+        const double d2 = MAX(fabs(2*c1 + 6*c2*(0 - 35.0)), fabs(2*c1 + 6*c2*(70 - 35.0))) * 1.0e-6;
+        return 0.5 * d2 * 0.5 * 0.5;
+    }
+
+    void run(bool accel)
+    {
+        const AP_Vector3f *coeff = accel ? tcal.accel_coeff : tcal.gyro_coeff;
+        const float cal_temp = 25;
+        double max_err = 0;
+        // slow ramp up and down with jitter, as a filtered IMU temperature would move
+        for (uint32_t i = 0; i < 20000; i++) {
+            const float ramp = i < 10000 ? i * 0.007f : (20000 - i) * 0.007f;
+            const float temperature = 1 + ramp + 0.05f * sinf(i * 0.3f);
+            Vector3f v;
+            if (accel) {
+                tcal.correct_accel(temperature, cal_temp, v);
+            } else {
+                tcal.correct_gyro(temperature, cal_temp, v);
+            }
+            for (uint8_t axis = 0; axis < 3; axis++) {
+                // the correction is limited to the calibrated range
+                const double err = fabs(v[axis] - exact(constrain_float(temperature, 0, 70), cal_temp, coeff, axis));
+                // allow for float rounding of the correction itself
+                EXPECT_LE(err, bound(coeff, axis) + 2.0e-6);
+                max_err = MAX(max_err, err);
+            }
+        }
+        // the cache must actually be in use for this test to mean anything
+        EXPECT_GT(max_err, 0);
+    }
+
+    AP_InertialSensor_TCal tcal;
+};
+
+TEST(AP_InertialSensor_TCal, cached_accel_correction)
+{
+    AP_InertialSensor_TCal_Test test;
+    test.run(true);
+}
+
+TEST(AP_InertialSensor_TCal, cached_gyro_correction)
+{
+    AP_InertialSensor_TCal_Test test;
+    test.run(false);
+}
+
+TEST(AP_InertialSensor_TCal, disabled)
+{
+    AP_InertialSensor_TCal_Test test;
+    test.tcal.enable.set(AP_InertialSensor_TCal::Enable::Disabled);
+    Vector3f v(1, 2, 3);
+    test.tcal.correct_accel(40, 25, v);
+    EXPECT_EQ(v, Vector3f(1, 2, 3));
+}
+
+#endif // HAL_INS_TEMPERATURE_CAL_ENABLE
+
+AP_GTEST_MAIN()
@@ -190,6 +190,15 @@ const AP_Param::GroupInfo AP_Logger::var_info[] = {
     // @RebootRequired: True
     AP_GROUPINFO("_MAX_FILES", 12, AP_Logger, _params.max_log_files, MAX_LOG_FILES),
 
+    // @Param: _BP_RATEMAX
+    // @DisplayName: Maximum logging rate under backpressure
+    // @Description: This sets the maximum rate that streaming log messages will be logged to a backend once its write buffer is more than half full. The rate is reduced further as the buffer fills, down to a tenth of this value when it is full, so that high rate messages are thinned before the backend has to drop messages. Non-streaming messages are never thinned. A value of zero means that backpressure thinning is disabled. With the default of 10Hz every backend has a rate limiter, so high rate streaming messages are thinned when the buffer is filling even if LOG_FILE_RATEMAX, LOG_MAV_RATEMAX and LOG_BLK_RATEMAX are zero. Set this to zero to keep the behaviour of older firmware, which only dropped messages when the buffer was full.
+    // @Units: Hz
+    // @Range: 0 1000
+    // @Increment: 0.1
+    // @User: Advanced
+    AP_GROUPINFO("_BP_RATEMAX", 13, AP_Logger, _params.bp_ratemax, 10),
+
     AP_GROUPEND
 };
 
@@ -1435,6 +1444,10 @@ void AP_Logger::io_thread(void)
 
         FOR_EACH_BACKEND(io_timer());
 
+#if HAL_LOGGER_DOWNLOAD_PREFETCH_ENABLED
+        log_prefetch_update();
+#endif
+
         if (now - last_stack_us > 100000U) {
             last_stack_us = now;
             hal.util->log_stack_info();
@@ -8,6 +8,7 @@
 #if HAL_LOGGING_ENABLED
 
 #include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/utility/RingBuffer.h>
 #include <AP_Common/AP_Common.h>
 #include <AP_Param/AP_Param.h>
 #include <AP_Mission/AP_Mission.h>
@@ -350,6 +351,7 @@ public:
         AP_Float mav_ratemax;
         AP_Float blk_ratemax;
         AP_Float disarm_ratemax;
+        AP_Float bp_ratemax;
         AP_Int16 max_log_files;
     } _params;
 
@@ -585,6 +587,35 @@ private:
     GCS_MAVLINK *_log_sending_link;
     HAL_Semaphore _log_send_sem;
 
+    // data requests from the sending link received while sending,
+    // served in order as each request completes
+    struct log_data_request {
+        uint16_t id;
+        uint32_t ofs;
+        uint32_t count;
+    } _log_data_requests[4];
+    uint8_t _log_data_num_requests;
+
+#if HAL_LOGGER_DOWNLOAD_PREFETCH_ENABLED
+    // log data read ahead of the download by the IO thread, so the
+    // GCS thread never waits on the backend
+    struct {
+        ByteBuffer *buf;
+        uint16_t log_num;
+        uint32_t page;
+        uint32_t read_ofs; // offset in the log of the next byte to read into buf
+        uint32_t end_ofs;  // offset in the log to stop reading at
+        bool active;
+        bool eof;          // read_ofs reached the end of the log, or a read failed
+        HAL_Semaphore sem;
+    } _log_prefetch;
+
+    void log_prefetch_start(void);
+    void log_prefetch_stop(void);
+    void log_prefetch_update(void);
+    bool log_prefetch_read(uint16_t len, uint8_t *data, int16_t &nbytes);
+#endif
+
     // last time arming failed, for backends
     uint32_t _last_arming_failure_ms;
 
@@ -598,6 +629,7 @@ private:
     void handle_log_request_data(class GCS_MAVLINK &, const mavlink_message_t &msg);
     void handle_log_request_erase(class GCS_MAVLINK &, const mavlink_message_t &msg);
     void handle_log_request_end(class GCS_MAVLINK &, const mavlink_message_t &msg);
+    void start_log_data_request(class GCS_MAVLINK &link, const struct log_data_request &request);
     void end_log_transfer();
     void handle_log_send_listing(); // handle LISTING state
     void handle_log_sending(); // handle SENDING state
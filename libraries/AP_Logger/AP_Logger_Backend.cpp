@@ -98,6 +98,9 @@ void AP_Logger_Backend::periodic_tasks()
 void AP_Logger_Backend::start_new_log_reset_variables()
 {
     _dropped = 0;
+    if (rate_limiter != nullptr) {
+        rate_limiter->reset_thinned();
+    }
     _startup_messagewriter->reset();
     _front.backend_starting_new_log(this);
     _formats_written.clearall();
@@ -455,7 +458,7 @@ bool AP_Logger_Backend::WritePrioritisedBlock(const void *pBuffer, uint16_t size
 
     if (!is_critical && rate_limiter != nullptr) {
         const uint8_t *msgbuf = (const uint8_t *)pBuffer;
-        if (!rate_limiter->should_log(msgbuf[2], writev_streaming)) {
+        if (!rate_limiter->should_log(msgbuf[2], writev_streaming, buffer_fill())) {
             return false;
         }
     }
@@ -688,6 +691,8 @@ void AP_Logger_Backend::Write_AP_Logger_Stats_File(const struct df_stats &_stats
         buf_space_min   : _stats.buf_space_min,
         buf_space_max   : _stats.buf_space_max,
         buf_space_avg   : (_stats.blocks) ? (_stats.buf_space_sigma / _stats.blocks) : 0,
+        thinned         : (rate_limiter != nullptr) ? rate_limiter->num_thinned() : 0,
+        thinned_max_id  : (rate_limiter != nullptr) ? rate_limiter->take_most_thinned() : uint8_t(AP_Logger_RateLimiter::none_thinned),
     };
     WriteBlock(&pkt, sizeof(pkt));
 }
@@ -742,11 +747,26 @@ bool AP_Logger_RateLimiter::should_log_streaming(uint8_t msgid, float rate_hz)
     return true;
 }
 
+/*
+  return the streaming rate limit from backpressure, zero if there is
+  no backpressure limit. Streaming messages are limited to
+  LOG_BP_RATEMAX once the write buffer is half full, falling to a
+  tenth of that when it is full
+ */
+float AP_Logger_RateLimiter::backpressure_rate_hz(float buffer_fill) const
+{
+    const float bp_rate_hz = front._params.bp_ratemax;
+    if (!is_positive(bp_rate_hz) || buffer_fill < 0.5) {
+        return 0;
+    }
+    return bp_rate_hz * linear_interpolate(1.0, 0.1, buffer_fill, 0.5, 1.0);
+}
+
 /*
   return true if the message is not a streaming message or the gap
   from the last message is more than the message rate
  */
-bool AP_Logger_RateLimiter::should_log(uint8_t msgid, bool writev_streaming)
+bool AP_Logger_RateLimiter::should_log(uint8_t msgid, bool writev_streaming, float buffer_fill)
 {
     float rate_hz = rate_limit_hz;
     if (!hal.util->get_soft_armed() &&
@@ -754,6 +774,12 @@ bool AP_Logger_RateLimiter::should_log(uint8_t msgid, bool writev_streaming)
         !is_zero(disarm_rate_limit_hz)) {
         rate_hz = disarm_rate_limit_hz;
     }
+    const float bp_rate_hz = backpressure_rate_hz(buffer_fill);
+    const bool backpressure = is_positive(bp_rate_hz) &&
+        (!is_positive(rate_hz) || bp_rate_hz < rate_hz);
+    if (backpressure) {
+        rate_hz = bp_rate_hz;
+    }
     if (!is_positive(rate_hz) && !front._log_pause) {
         // no rate limiting if not paused and rate is zero(user changed the parameter)
         return true;
@@ -777,7 +803,11 @@ bool AP_Logger_RateLimiter::should_log(uint8_t msgid, bool writev_streaming)
     // same decision again
     const uint16_t sched_ticks = AP::scheduler().ticks();
     if (sched_ticks == last_sched_count[msgid]) {
-        return last_return.get(msgid);
+        const bool ret = last_return.get(msgid);
+        if (!ret && backpressure && !front._log_pause) {
+            count_thinned(msgid);
+        }
+        return ret;
     }
     last_sched_count[msgid] = sched_ticks;
 #endif
@@ -787,7 +817,32 @@ bool AP_Logger_RateLimiter::should_log(uint8_t msgid, bool writev_streaming)
         last_return.set(msgid);
     } else {
         last_return.clear(msgid);
+        if (backpressure && !front._log_pause) {
+            count_thinned(msgid);
+        }
+    }
+    return ret;
+}
+
+void AP_Logger_RateLimiter::count_thinned(uint8_t msgid)
+{
+    thinned++;
+    if (thinned_count[msgid] < UINT8_MAX) {
+        thinned_count[msgid]++;
+    }
+}
+
+uint8_t AP_Logger_RateLimiter::take_most_thinned(void)
+{
+    uint8_t ret = none_thinned;
+    uint8_t max_count = 0;
+    for (uint16_t i=0; i<ARRAY_SIZE(thinned_count); i++) {
+        if (thinned_count[i] > max_count) {
+            max_count = thinned_count[i];
+            ret = i;
+        }
     }
+    memset(thinned_count, 0, sizeof(thinned_count));
     return ret;
 }
 
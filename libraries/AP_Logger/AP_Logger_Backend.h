@@ -13,21 +13,50 @@
 
 class LoggerMessageWriter_DFLogStart;
 
-// class to handle rate limiting of log messages
+/*
+  class to handle rate limiting of log messages. Messages fall into
+  three classes: critical messages bypass the limiter and use the
+  space reserved for them in the backend, non-streaming messages are
+  always logged and streaming messages are limited to the configured
+  rate, and thinned further when the backend write buffer is filling
+ */
 class AP_Logger_RateLimiter
 {
 public:
     AP_Logger_RateLimiter(const class AP_Logger &_front, const AP_Float &_limit_hz, const AP_Float &_disarm_limit_hz);
 
-    // return true if message passes the rate limit test
-    bool should_log(uint8_t msgid, bool writev_streaming);
+    // return true if message passes the rate limit test. buffer_fill
+    // is the fraction of the backend write buffer in use
+    bool should_log(uint8_t msgid, bool writev_streaming, float buffer_fill=0);
     bool should_log_streaming(uint8_t msgid, float rate_hz);
 
+    // number of streaming messages thinned because of backpressure
+    uint32_t num_thinned(void) const { return thinned; }
+    void reset_thinned(void) { thinned = 0; }
+
+    // message ID reported by take_most_thinned() when nothing was
+    // thinned. ID 255 is reserved, so is never a real message
+    static const uint8_t none_thinned = 255;
+
+    // return the message type thinned most since the last call, or
+    // none_thinned if none were thinned
+    uint8_t take_most_thinned(void);
+
 private:
     const AP_Logger &front;
     const AP_Float &rate_limit_hz;
     const AP_Float &disarm_rate_limit_hz;
 
+    float backpressure_rate_hz(float buffer_fill) const;
+    void count_thinned(uint8_t msgid);
+
+    // streaming messages thinned because of backpressure
+    uint32_t thinned;
+
+    // per message type count of thinned messages since the last call
+    // to take_most_thinned(), saturating
+    uint8_t thinned_count[256];
+
     // time in ms we last sent this message
     uint16_t last_send_ms[256];
 
@@ -86,6 +115,10 @@ public:
 
     virtual uint32_t bufferspace_available() = 0;
 
+    // fraction of the write buffer in use, used to thin streaming
+    // messages under backpressure
+    virtual float buffer_fill() const { return 0; }
+
     virtual void PrepForArming();
 
     virtual void start_new_log() { }
@@ -19,6 +19,9 @@ const extern AP_HAL::HAL& hal;
 // this if (and only if!) the low level format changes
 #define DF_LOGGING_FORMAT    0x1901201B
 
+// most pages written per IO timer call when catching up
+#define BLOCK_LOG_MAX_PAGES_PER_TICK 4
+
 AP_Logger_Block::AP_Logger_Block(AP_Logger &front, LoggerMessageWriter_DFLogStart *writer) :
     AP_Logger_Backend(front, writer),
     writebuf(0)
@@ -80,6 +83,17 @@ uint32_t AP_Logger_Block::bufferspace_available()
     return df_NumPages * df_PageSize;
 }
 
+// the flash is a ring buffer so backpressure comes from the write
+// buffer in front of it
+float AP_Logger_Block::buffer_fill() const
+{
+    const uint32_t size = writebuf.get_size();
+    if (size == 0) {
+        return 0;
+    }
+    return 1.0 - float(writebuf.space()) / size;
+}
+
 // *** LOGGER PUBLIC FUNCTIONS ***
 void AP_Logger_Block::StartWrite(uint32_t PageAdr)
 {
@@ -97,24 +111,48 @@ void AP_Logger_Block::FinishWrite(void)
         df_PageAdr = 1;
     }
 
-    // when starting a new sector, erase it
+    // when starting a new block, erase the one after it. This block
+    // was erased when we entered the one before
     if ((df_PageAdr-1) % df_PagePerBlock == 0) {
-        // if we have wrapped over an existing log, force the oldest to be recalculated
-        if (_cached_oldest_log > 0) {
-            uint16_t log_num = StartRead(df_PageAdr);
-            if (log_num != 0xFFFF && log_num >= _cached_oldest_log) {
-                _cached_oldest_log = 0;
-            }
-        }
-        // are we about to erase a sector with our own headers in it?
-        if (df_Write_FilePage > df_NumPages - df_PagePerBlock) {
+        // are we about to erase a block with our own headers in it?
+        if (df_Write_FilePage > df_NumPages - 2 * df_PagePerBlock) {
             chip_full = true;
             return;
         }
-        SectorErase(get_block(df_PageAdr));
+        start_block_erase(next_block_page(df_PageAdr));
     }
 }
 
+// return the first page of the block after the one holding page
+uint32_t AP_Logger_Block::next_block_page(uint32_t page) const
+{
+    if (page > df_NumPages) {
+        page = 1;
+    }
+    const uint32_t next_page = (get_block(page) + 1) * df_PagePerBlock + 1;
+    if (next_page > df_NumPages) {
+        return 1;
+    }
+    return next_page;
+}
+
+// start erasing the block starting at page ahead of the write point
+void AP_Logger_Block::start_block_erase(uint32_t page)
+{
+    // if we are about to wrap over an existing log, force the oldest to be recalculated
+    if (_cached_oldest_log > 0) {
+        uint16_t log_num = StartRead(page);
+        if (log_num != 0xFFFF && log_num >= _cached_oldest_log) {
+            _cached_oldest_log = 0;
+        }
+    }
+    SectorErase(get_block(page));
+    // the erase runs while the write buffer takes new data,
+    // io_timer() waits for it before writing the next page
+    block_erase_pending = true;
+    block_erase_start_ms = AP_HAL::millis();
+}
+
 bool AP_Logger_Block::WritesOK() const
 {
     if (!CardInserted() || erase_started) {
@@ -154,6 +192,9 @@ bool AP_Logger_Block::_WritePrioritisedBlock(const void *pBuffer, uint16_t size,
         // we reserve some amount of space for critical messages:
         if (!is_critical && space < critical_message_reserved_space(writebuf.get_size())) {
             _dropped++;
+            if (block_erase_pending) {
+                block_stats.erase_dropped++;
+            }
             return false;
         }
     }
@@ -161,6 +202,9 @@ bool AP_Logger_Block::_WritePrioritisedBlock(const void *pBuffer, uint16_t size,
     // if no room for entire message - drop it:
     if (space < size) {
         _dropped++;
+        if (block_erase_pending) {
+            block_stats.erase_dropped++;
+        }
         return false;
     }
 
@@ -183,6 +227,33 @@ uint16_t AP_Logger_Block::StartRead(uint32_t PageAdr)
     return ReadHeaders();
 }
 
+// read the first page after the erased blocks ahead of the write
+// point, where page is the first page not yet written, returning the
+// file number found there
+uint16_t AP_Logger_Block::StartReadAfterErased(uint32_t page)
+{
+    // the rest of the block being written and the block after it are
+    // erased. Logs written before blocks were erased ahead of the
+    // write point only have the first
+    const uint32_t next_page = next_block_page(page);
+    const uint16_t file = StartRead(next_page);
+    if (file != 0xFFFF) {
+        return file;
+    }
+    return StartRead(next_block_page(next_page));
+}
+
+// return the first page of the oldest log on a chip that has not
+// wrapped. While the last block is written the first block is erased
+// ahead of the write point, so the oldest log starts in the second
+uint32_t AP_Logger_Block::first_log_page()
+{
+    if (StartRead(1) == 0xFFFF && StartRead(df_PagePerBlock + 1) != 0xFFFF) {
+        return df_PagePerBlock + 1;
+    }
+    return 1;
+}
+
 // read the headers at the current read point returning the file number
 uint16_t AP_Logger_Block::ReadHeaders()
 {
@@ -300,8 +371,9 @@ void AP_Logger_Block::periodic_1Hz()
     if (rate_limiter == nullptr &&
         (_front._params.blk_ratemax > 0 ||
          _front._params.disarm_ratemax > 0 ||
+         _front._params.bp_ratemax > 0 ||
          _front._log_pause)) {
-        // setup rate limiting if log rate max > 0Hz or log pause of streaming entries is requested
+        // setup rate limiting if log rate max > 0Hz, backpressure thinning or log pause of streaming entries is requested
         rate_limiter = NEW_NOTHROW AP_Logger_RateLimiter(_front, _front._params.blk_ratemax, _front._params.disarm_ratemax);
     }
     
@@ -323,6 +395,23 @@ void AP_Logger_Block::periodic_1Hz()
             warning_decimation_counter = 0;
         }
     }
+
+    if (log_write_started) {
+        Write_Block_Stats();
+    }
+}
+
+void AP_Logger_Block::Write_Block_Stats()
+{
+    const struct log_DBS pkt {
+        LOG_PACKET_HEADER_INIT(LOG_DF_BLOCK_STATS),
+        time_us       : AP_HAL::micros64(),
+        dropped       : _dropped,
+        erase_dropped : block_stats.erase_dropped,
+        erases        : block_stats.erases,
+        erase_max_ms  : block_stats.erase_max_ms,
+    };
+    WriteBlock(&pkt, sizeof(pkt));
 }
 
 // EraseAll is asynchronous, but we must not start a new
@@ -377,8 +466,8 @@ void AP_Logger_Block::validate_log_structure()
 {
     WITH_SEMAPHORE(sem);
     bool wrapped = is_wrapped();
-    uint32_t page = 1;
-    uint32_t page_start = 1;
+    uint32_t page = wrapped ? 1 : first_log_page();
+    uint32_t page_start = page;
 
     uint16_t file = StartRead(page);
     uint16_t first_file = file;
@@ -393,9 +482,9 @@ void AP_Logger_Block::validate_log_structure()
         page = end_page + 1;
         file = StartRead(page);
         next_file++;
-        // skip over the rest of an erased block
+        // skip over the erased blocks ahead of the write point
         if (wrapped && file == 0xFFFF) {
-            file = StartRead((get_block(page) + 1) * df_PagePerBlock + 1);
+            file = StartReadAfterErased(page);
         }
         if (wrapped && file < next_file) {
             page_start = page;
@@ -491,7 +580,7 @@ uint16_t AP_Logger_Block::get_num_logs(void)
         return 0;
     }
 
-    uint32_t first = StartRead(1);
+    uint32_t first = StartRead(first_log_page());
     
     if (first == 0xFFFF) {
         return 0;
@@ -501,10 +590,10 @@ uint16_t AP_Logger_Block::get_num_logs(void)
     last = StartRead(lastpage);
 
     if (is_wrapped()) {
-        // if we wrapped then the rest of the block will be filled with 0xFFFF because we always erase
-        // a block before writing to it, in order to find the first page we therefore have to read after the
-        // next block boundary
-        first = StartRead((get_block(lastpage) + 1) * df_PagePerBlock + 1);
+        // if we wrapped then the rest of the block and the one after it will be filled with 0xFFFF
+        // because we erase a block ahead of writing to it, in order to find the first page we
+        // therefore have to read after the erased blocks
+        first = StartReadAfterErased(lastpage + 1);
         // unless we happen to land on the first page of the file that is being overwritten we skip to the next file
         if (df_FilePage > 1) {
             first++;
@@ -580,6 +669,14 @@ void AP_Logger_Block::start_new_log(void)
         StartWrite(last_page + 1);
     }
 
+    // the block after the one we start in is normally erased when the
+    // last log entered our block, but not if the last log ended on a
+    // block boundary
+    const uint32_t erase_page = next_block_page(df_PageAdr);
+    if (StartRead(erase_page) != 0xFFFF) {
+        start_block_erase(erase_page);
+    }
+
     // save UTC time in the first 4 bytes so that we can retrieve it later
     uint64_t utc_usec;
     FileHeader hdr {};
@@ -589,6 +686,7 @@ void AP_Logger_Block::start_new_log(void)
     writebuf.write((uint8_t*)&hdr, sizeof(FileHeader));
 
     start_new_log_reset_variables();
+    memset(&block_stats, 0, sizeof(block_stats));
 
     return;
 }
@@ -613,7 +711,7 @@ void AP_Logger_Block::get_log_boundaries(uint16_t list_entry, uint32_t & start_p
 
     if (num == 1 || log_num == 1) {
         if (!is_wrapped()) {
-            start_page = 1;
+            start_page = first_log_page();
         } else {
             StartRead(end_page);
             start_page = (end_page + df_NumPages - df_FilePage) % df_NumPages + 1;
@@ -665,7 +763,7 @@ uint16_t AP_Logger_Block::find_last_log(void)
 uint32_t AP_Logger_Block::find_last_page(void)
 {
     uint32_t look;
-    uint32_t bottom = 1;
+    uint32_t bottom;
     uint32_t top = df_NumPages;
     uint64_t look_hash;
     uint64_t bottom_hash;
@@ -673,6 +771,7 @@ uint32_t AP_Logger_Block::find_last_page(void)
 
     WITH_SEMAPHORE(sem);
 
+    bottom = first_log_page();
     StartRead(bottom);
     bottom_hash = ((int64_t)GetFileNumber()<<32) | df_FilePage;
 
@@ -728,7 +827,7 @@ uint32_t AP_Logger_Block::find_last_page_of_log(uint16_t log_number)
             top = find_last_page();
         }
     } else {
-        bottom = 1;
+        bottom = first_log_page();
         top = find_last_page();
     }
 
@@ -828,6 +927,8 @@ bool AP_Logger_Block::io_thread_alive() const
   so there is little point in trying to write more than 130 bytes - or 1 page (256 bytes).
   The W25Q128FV datasheet gives tpp as typically 0.7ms yielding an absolute maximum rate of
   365Kb/s or just over a page per cycle.
+  A block erase takes far longer, so while one is in progress we leave
+  data in the write buffer and catch up a few pages per cycle afterwards.
  */
 void AP_Logger_Block::io_timer(void)
 {
@@ -883,6 +984,13 @@ void AP_Logger_Block::io_timer(void)
         return;
     }
 
+    {
+        WITH_SEMAPHORE(sem);
+        if (!block_erase_complete()) {
+            return;
+        }
+    }
+
     // we have been asked to stop logging, flush everything
     if (stop_log_pending) {
         WITH_SEMAPHORE(sem);
@@ -897,12 +1005,38 @@ void AP_Logger_Block::io_timer(void)
             stop_log_pending = false;
         }
 
-    // write at most one page
-    } else if (writebuf.available() >= df_PageSize - sizeof(struct PageHeader)) {
-        WITH_SEMAPHORE(sem);
+    } else {
+        // write a page, or a few to catch up after a block erase
+        for (uint8_t i=0;
+             i<BLOCK_LOG_MAX_PAGES_PER_TICK && writebuf.available() >= df_PageSize - sizeof(struct PageHeader);
+             i++) {
+            WITH_SEMAPHORE(sem);
+
+            write_log_page();
+            if (block_erase_pending || chip_full) {
+                break;
+            }
+        }
+    }
+}
 
-        write_log_page();
+/*
+  check if a block erase started by FinishWrite() has completed,
+  recording how long it took
+ */
+bool AP_Logger_Block::block_erase_complete()
+{
+    if (!block_erase_pending) {
+        return true;
     }
+    if (Busy()) {
+        return false;
+    }
+    const uint32_t erase_ms = AP_HAL::millis() - block_erase_start_ms;
+    block_stats.erases++;
+    block_stats.erase_max_ms = MAX(block_stats.erase_max_ms, MIN(erase_ms, UINT16_MAX));
+    block_erase_pending = false;
+    return true;
 }
 
 // write out a page of log data
@@ -28,6 +28,7 @@ public:
     uint16_t get_num_logs() override;
     void start_new_log(void) override;
     uint32_t bufferspace_available() override;
+    float buffer_fill() const override;
     void stop_logging(void) override;
     void stop_logging_async(void) override;
     bool logging_failed() const override;
@@ -51,6 +52,9 @@ protected:
         return ((current_page - 1) / df_PagePerBlock);
     }
 
+    // get the first page of the block after the one holding page
+    uint32_t next_block_page(uint32_t page) const;
+
     // number of bytes in a page
     uint32_t df_PageSize;
     // number of pages in a (generally 64k) block
@@ -75,6 +79,8 @@ private:
     virtual void Sector4kErase(uint32_t SectorAdr) = 0;
     virtual void StartErase() = 0;
     virtual bool InErase() = 0;
+    // true while the chip is programming or erasing
+    virtual bool Busy() = 0;
     void         flash_test(void);
 
     struct PACKED PageHeader {
@@ -113,6 +119,16 @@ private:
 
     // are we waiting on an erase to finish?
     volatile bool erase_started;
+    // a block erase ahead of the write point is in progress
+    volatile bool block_erase_pending;
+    uint32_t block_erase_start_ms;
+
+    // statistics for the current log
+    struct {
+        uint32_t erase_dropped; // messages dropped while a block erase was in progress
+        uint16_t erases;
+        uint16_t erase_max_ms;
+    } block_stats;
     // were we logging before the erase started?
     volatile bool new_log_pending;
     // have we been asked to stop logging safely?
@@ -142,6 +158,10 @@ private:
     int16_t get_log_data_raw(uint16_t log_num, uint32_t page, uint32_t offset, uint16_t len, uint8_t *data) WARN_IF_UNUSED;
     // read from the page address and return the file number at that location
     uint16_t StartRead(uint32_t PageAdr);
+    // read the first page after the erased blocks ahead of the write point
+    uint16_t StartReadAfterErased(uint32_t page);
+    // first page of the oldest log when the chip has not wrapped
+    uint32_t first_log_page();
     // read the headers at the current read point returning the file number
     uint16_t ReadHeaders();
     uint32_t find_last_page(void);
@@ -162,6 +182,10 @@ private:
     // callback on IO thread
     bool io_thread_alive() const;
     void write_log_page();
+    void start_block_erase(uint32_t page);
+    bool block_erase_complete();
+
+    void Write_Block_Stats();
 };
 
 #endif  // HAL_LOGGING_BLOCK_ENABLED
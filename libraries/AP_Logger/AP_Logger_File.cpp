@@ -171,8 +171,9 @@ void AP_Logger_File::periodic_1Hz()
     if (rate_limiter == nullptr &&
         (_front._params.file_ratemax > 0 ||
          _front._params.disarm_ratemax > 0 ||
+         _front._params.bp_ratemax > 0 ||
          _front._log_pause)) {
-        // setup rate limiting if log rate max > 0Hz or log pause of streaming entries is requested
+        // setup rate limiting if log rate max > 0Hz, backpressure thinning or log pause of streaming entries is requested
         rate_limiter = NEW_NOTHROW AP_Logger_RateLimiter(_front, _front._params.file_ratemax, _front._params.disarm_ratemax);
     }
 }
@@ -190,6 +191,15 @@ uint32_t AP_Logger_File::bufferspace_available()
     return (space > crit) ? space - crit : 0;
 }
 
+float AP_Logger_File::buffer_fill() const
+{
+    const uint32_t size = _writebuf.get_size();
+    if (size == 0) {
+        return 0;
+    }
+    return 1.0 - float(_writebuf.space()) / size;
+}
+
 bool AP_Logger_File::recent_open_error(void) const
 {
     if (_open_error_ms == 0) {
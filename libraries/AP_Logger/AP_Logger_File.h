@@ -39,6 +39,7 @@ public:
     /* Write a block of data at current offset */
     bool _WritePrioritisedBlock(const void *pBuffer, uint16_t size, bool is_critical) override;
     uint32_t bufferspace_available() override;
+    float buffer_fill() const override;
 
     // high level interface
     uint16_t find_last_log() override;
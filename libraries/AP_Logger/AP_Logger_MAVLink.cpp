@@ -64,6 +64,14 @@ uint32_t AP_Logger_MAVLink::bufferspace_available() {
     return (_blockcount_free * 200 + remaining_space_in_current_block());
 }
 
+float AP_Logger_MAVLink::buffer_fill() const
+{
+    if (_blockcount == 0) {
+        return 0;
+    }
+    return 1.0 - float(_blockcount_free) / _blockcount;
+}
+
 uint8_t AP_Logger_MAVLink::remaining_space_in_current_block() const {
     // note that _current_block *could* be NULL ATM.
     return (MAVLINK_MSG_REMOTE_LOG_DATA_BLOCK_FIELD_DATA_LEN - _latest_block_len);
@@ -538,8 +546,9 @@ void AP_Logger_MAVLink::periodic_1Hz()
     if (rate_limiter == nullptr &&
         (_front._params.mav_ratemax > 0 ||
          _front._params.disarm_ratemax > 0 ||
+         _front._params.bp_ratemax > 0 ||
          _front._log_pause)) {
-        // setup rate limiting if log rate max > 0Hz or log pause of streaming entries is requested
+        // setup rate limiting if log rate max > 0Hz, backpressure thinning or log pause of streaming entries is requested
         rate_limiter = NEW_NOTHROW AP_Logger_RateLimiter(_front, _front._params.mav_ratemax, _front._params.disarm_ratemax);
     }
 
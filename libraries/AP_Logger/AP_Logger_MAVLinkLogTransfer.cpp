@@ -108,53 +108,85 @@ void AP_Logger::handle_log_request_data(GCS_MAVLINK &link, const mavlink_message
 {
     WITH_SEMAPHORE(_log_send_sem);
 
+    mavlink_log_request_data_t packet;
+    mavlink_msg_log_request_data_decode(&msg, &packet);
+    const log_data_request request { packet.id, packet.ofs, packet.count };
+
     if (_log_sending_link != nullptr) {
-        // some GCS (e.g. MAVProxy) attempt to stream request_data
-        // messages when they're filling gaps in the downloaded logs.
-        // This channel check avoids complaining to them, at the cost
-        // of silently dropping any repeated attempts to start logging
         if (_log_sending_link->get_chan() != link.get_chan()) {
             link.send_text(MAV_SEVERITY_INFO, "Log download in progress");
+            return;
+        }
+        // some GCS (e.g. MAVProxy) stream request_data messages when
+        // they're filling gaps in the downloaded logs. Queue them
+        // so the gaps are sent back to back, ignoring repeats of a
+        // request we already have
+        if (transfer_activity != TransferActivity::SENDING) {
+            return;
+        }
+        for (uint8_t i=0; i<_log_data_num_requests; i++) {
+            const log_data_request &r = _log_data_requests[i];
+            if (r.id == request.id && r.ofs == request.ofs && r.count == request.count) {
+                return;
+            }
+        }
+        if (_log_data_num_requests < ARRAY_SIZE(_log_data_requests)) {
+            _log_data_requests[_log_data_num_requests++] = request;
         }
         return;
     }
 
-    mavlink_log_request_data_t packet;
-    mavlink_msg_log_request_data_decode(&msg, &packet);
+    start_log_data_request(link, request);
+    if (_log_sending_link != nullptr) {
+        handle_log_send();
+    }
+}
+
+/**
+   start sending the data for a request
+ */
+void AP_Logger::start_log_data_request(GCS_MAVLINK &link, const log_data_request &request)
+{
+#if HAL_LOGGER_DOWNLOAD_PREFETCH_ENABLED
+    // keep the IO thread out of the backend while we switch
+    WITH_SEMAPHORE(_log_prefetch.sem);
+#endif
 
     // consider opening or switching logs:
-    if (transfer_activity != TransferActivity::SENDING || _log_num_data != packet.id) {
+    if (transfer_activity != TransferActivity::SENDING || _log_num_data != request.id) {
 
         uint16_t num_logs = get_num_logs();
-        if (packet.id > num_logs || packet.id < 1) {
+        if (request.id > num_logs || request.id < 1) {
             // request for an invalid log; cancel any current download
             end_log_transfer();
             return;
         }
 
         uint32_t time_utc, size;
-        get_log_info(packet.id, size, time_utc);
-        _log_num_data = packet.id;
+        get_log_info(request.id, size, time_utc);
+        _log_num_data = request.id;
         _log_data_size = size;
 
         uint32_t end;
-        get_log_boundaries(packet.id, _log_data_page, end);
+        get_log_boundaries(request.id, _log_data_page, end);
     }
 
-    _log_data_offset = packet.ofs;
+    _log_data_offset = request.ofs;
     if (_log_data_offset >= _log_data_size) {
         _log_data_remaining = 0;
     } else {
         _log_data_remaining = _log_data_size - _log_data_offset;
     }
-    if (_log_data_remaining > packet.count) {
-        _log_data_remaining = packet.count;
+    if (_log_data_remaining > request.count) {
+        _log_data_remaining = request.count;
     }
 
     transfer_activity = TransferActivity::SENDING;
     _log_sending_link = &link;
 
-    handle_log_send();
+#if HAL_LOGGER_DOWNLOAD_PREFETCH_ENABLED
+    log_prefetch_start();
+#endif
 }
 
 /**
@@ -181,8 +213,12 @@ void AP_Logger::handle_log_request_end(GCS_MAVLINK &link, const mavlink_message_
 
 void AP_Logger::end_log_transfer()
 {
+#if HAL_LOGGER_DOWNLOAD_PREFETCH_ENABLED
+    log_prefetch_stop();
+#endif
     transfer_activity = TransferActivity::IDLE;
     _log_sending_link = nullptr;
+    _log_data_num_requests = 0;
     backends[0]->end_log_transfer();
 }
 
@@ -225,7 +261,11 @@ void AP_Logger::handle_log_sending()
         // when on USB we can send a lot more data
         num_sends = 250;
     } else if (_log_sending_link->have_flow_control()) {
-    #if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+    #if HAL_LOGGER_DOWNLOAD_PREFETCH_ENABLED
+        // data comes from the prefetch buffer so sending is cheap,
+        // fill whatever space the link has (e.g. a TCP network port)
+        num_sends = 250;
+    #elif CONFIG_HAL_BOARD == HAL_BOARD_LINUX
         num_sends = 80;
     #else
         num_sends = 10;
@@ -305,7 +345,14 @@ bool AP_Logger::handle_log_send_data()
         len = MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
     }
 
+#if HAL_LOGGER_DOWNLOAD_PREFETCH_ENABLED
+    if (!log_prefetch_read(len, packet.data, nbytes)) {
+        // waiting for the IO thread to read ahead
+        return false;
+    }
+#else
     nbytes = get_log_data(_log_num_data, _log_data_page, _log_data_offset, len, packet.data);
+#endif
 
     if (nbytes < 0) {
         // report as EOF on error
@@ -328,9 +375,127 @@ bool AP_Logger::handle_log_send_data()
     _log_data_offset += nbytes;
     _log_data_remaining -= nbytes;
     if (nbytes < MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN || _log_data_remaining == 0) {
-        end_log_transfer();
+        if (_log_data_num_requests == 0) {
+            end_log_transfer();
+        } else {
+            // move on to the next queued request
+            const log_data_request request = _log_data_requests[0];
+            _log_data_num_requests--;
+            memmove(&_log_data_requests[0], &_log_data_requests[1], _log_data_num_requests*sizeof(_log_data_requests[0]));
+            start_log_data_request(*_log_sending_link, request);
+        }
     }
     return true;
 }
 
+#if HAL_LOGGER_DOWNLOAD_PREFETCH_ENABLED
+// largest read from the backend in one call, bounding how long the
+// IO thread holds the prefetch semaphore
+#define LOG_PREFETCH_READ_MAX 512U
+
+/*
+  start reading ahead from the current download position
+ */
+void AP_Logger::log_prefetch_start(void)
+{
+    WITH_SEMAPHORE(_log_prefetch.sem);
+
+    if (_log_prefetch.buf == nullptr) {
+        _log_prefetch.buf = NEW_NOTHROW ByteBuffer(HAL_LOGGER_DOWNLOAD_PREFETCH_SIZE);
+        if (_log_prefetch.buf != nullptr && _log_prefetch.buf->get_size() == 0) {
+            delete _log_prefetch.buf;
+            _log_prefetch.buf = nullptr;
+        }
+        if (_log_prefetch.buf == nullptr) {
+            // no memory, the GCS thread reads from the backend itself
+            return;
+        }
+    }
+    _log_prefetch.buf->clear();
+    _log_prefetch.log_num = _log_num_data;
+    _log_prefetch.page = _log_data_page;
+    _log_prefetch.read_ofs = _log_data_offset;
+    _log_prefetch.end_ofs = _log_data_offset + _log_data_remaining;
+    _log_prefetch.eof = false;
+    _log_prefetch.active = true;
+}
+
+/*
+  stop reading ahead and free the buffer. Waits for any read in
+  progress in the IO thread
+ */
+void AP_Logger::log_prefetch_stop(void)
+{
+    WITH_SEMAPHORE(_log_prefetch.sem);
+
+    _log_prefetch.active = false;
+    delete _log_prefetch.buf;
+    _log_prefetch.buf = nullptr;
+}
+
+/*
+  read ahead of the download, called from the IO thread
+ */
+void AP_Logger::log_prefetch_update(void)
+{
+    WITH_SEMAPHORE(_log_prefetch.sem);
+
+    // a few reads per call keeps up with a fast link while giving
+    // the GCS thread regular chances to take the data
+    for (uint8_t i=0; i<4; i++) {
+        if (!_log_prefetch.active || _log_prefetch.eof) {
+            return;
+        }
+        if (_log_prefetch.read_ofs >= _log_prefetch.end_ofs) {
+            _log_prefetch.eof = true;
+            return;
+        }
+        ByteBuffer::IoVec vec[2];
+        const uint32_t len = MIN(_log_prefetch.end_ofs - _log_prefetch.read_ofs, LOG_PREFETCH_READ_MAX);
+        if (_log_prefetch.buf->space() < len ||
+            _log_prefetch.buf->reserve(vec, len) == 0) {
+            // full, wait for the GCS thread to take some
+            return;
+        }
+        // only read into the first part if the space wraps around
+        const int16_t nbytes = get_log_data(_log_prefetch.log_num, _log_prefetch.page, _log_prefetch.read_ofs, vec[0].len, vec[0].data);
+        if (nbytes <= 0) {
+            IGNORE_RETURN(_log_prefetch.buf->commit(0));
+            _log_prefetch.eof = true;
+            return;
+        }
+        IGNORE_RETURN(_log_prefetch.buf->commit(nbytes));
+        _log_prefetch.read_ofs += nbytes;
+        if (uint32_t(nbytes) < vec[0].len) {
+            // short read, end of the log
+            _log_prefetch.eof = true;
+        }
+    }
+}
+
+/*
+  take the next len bytes of the download from the prefetch
+  buffer. Returns false if the IO thread has not read them yet. nbytes
+  is short at the end of the log
+ */
+bool AP_Logger::log_prefetch_read(uint16_t len, uint8_t *data, int16_t &nbytes)
+{
+    if (_log_prefetch.buf == nullptr) {
+        nbytes = get_log_data(_log_num_data, _log_data_page, _log_data_offset, len, data);
+        return true;
+    }
+    if (!_log_prefetch.sem.take_nonblocking()) {
+        // the IO thread is reading
+        return false;
+    }
+    bool ret = false;
+    if (_log_prefetch.buf->available() >= len || _log_prefetch.eof) {
+        nbytes = _log_prefetch.buf->read(data, len);
+        ret = true;
+    }
+    _log_prefetch.sem.give();
+    return ret;
+}
+#endif // HAL_LOGGER_DOWNLOAD_PREFETCH_ENABLED
+
 #endif  // HAL_LOGGING_ENABLED && HAL_GCS_ENABLED
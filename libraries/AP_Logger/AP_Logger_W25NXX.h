@@ -29,9 +29,9 @@ private:
     void              Sector4kErase(uint32_t SectorAdr) override;
     void              StartErase() override;
     bool              InErase() override;
+    bool              Busy() override;
     void              send_command_addr(uint8_t cmd, uint32_t address);
     void              WaitReady();
-    bool              Busy();
     uint8_t           ReadStatusRegBits(uint8_t bits);
     void              WriteStatusReg(uint8_t reg, uint8_t bits);
 
@@ -51,6 +51,18 @@
 #define HAL_LOGGER_FILE_CONTENTS_ENABLED HAL_LOGGING_FILESYSTEM_ENABLED
 #endif
 
+// size of the buffer the IO thread reads log data into ahead of a
+// download over MAVLink
+#ifndef HAL_LOGGER_DOWNLOAD_PREFETCH_SIZE
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_300
+#define HAL_LOGGER_DOWNLOAD_PREFETCH_SIZE 16384
+#else
+#define HAL_LOGGER_DOWNLOAD_PREFETCH_SIZE 0
+#endif
+#endif
+
+#define HAL_LOGGER_DOWNLOAD_PREFETCH_ENABLED HAL_LOGGING_ENABLED && HAL_GCS_ENABLED && (HAL_LOGGER_DOWNLOAD_PREFETCH_SIZE > 0)
+
 // range of IDs to allow for new messages during replay. It is very
 // useful to be able to add new messages during a replay, but we need
 // to avoid colliding with existing messages
@@ -226,6 +226,17 @@ struct PACKED log_DSF {
     uint32_t buf_space_min;
     uint32_t buf_space_max;
     uint32_t buf_space_avg;
+    uint32_t thinned;
+    uint8_t thinned_max_id;
+};
+
+struct PACKED log_DBS {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint32_t dropped;
+    uint32_t erase_dropped;
+    uint16_t erases;
+    uint16_t erase_max_ms;
 };
 
 struct PACKED log_Event {
@@ -623,6 +634,9 @@ struct PACKED log_Scripting {
     uint32_t run_time;
     int32_t total_mem;
     int32_t run_mem;
+    uint32_t instructions;
+    uint32_t alloc_bytes;
+    uint32_t gc_time;
 };
 
 struct PACKED log_MotBatt {
@@ -740,6 +754,16 @@ struct PACKED log_VER {
 // @Field: FMn: Minimum free space in write buffer in last time period
 // @Field: FMx: Maximum free space in write buffer in last time period
 // @Field: FAv: Average free space in write buffer in last time period
+// @Field: Th: Number of streaming messages thinned because the write buffer was filling
+// @Field: ThId: Message type thinned most in last time period, 255 if none were thinned
+
+// @LoggerMessage: DBS
+// @Description: Block (flash chip) logging statistics for the current log
+// @Field: TimeUS: Time since system startup
+// @Field: Dp: Number of times we rejected a write to the backend
+// @Field: DpE: Number of rejected writes while a block erase was in progress
+// @Field: Er: Number of blocks erased
+// @Field: EMx: Longest block erase
 
 // @LoggerMessage: ERR
 // @Description: Specifically coded error messages
@@ -1132,6 +1156,9 @@ struct PACKED log_VER {
 // @Field: Runtime: run time
 // @Field: Total_mem: total memory usage of all scripts
 // @Field: Run_mem: run memory usage
+// @Field: Insn: VM instructions executed
+// @Field: Alloc: bytes allocated from the scripting heap
+// @Field: GCtime: garbage collection time after the run
 
 // @LoggerMessage: VER
 // @Description: Ardupilot version
@@ -1249,7 +1276,9 @@ LOG_STRUCTURE_FROM_HAL \
 LOG_STRUCTURE_FROM_RPM \
 LOG_STRUCTURE_FROM_FENCE \
     { LOG_DF_FILE_STATS, sizeof(log_DSF), \
-      "DSF", "QIHIIII", "TimeUS,Dp,Blk,Bytes,FMn,FMx,FAv", "s--b---", "F--0---" }, \
+      "DSF", "QIHIIIIIB", "TimeUS,Dp,Blk,Bytes,FMn,FMx,FAv,Th,ThId", "s--b-----", "F--0-----" }, \
+    { LOG_DF_BLOCK_STATS, sizeof(log_DBS), \
+      "DBS", "QIIHH", "TimeUS,Dp,DpE,Er,EMx", "s---s", "F---C" }, \
     { LOG_RALLY_MSG, sizeof(log_Rally), \
       "RALY", "QBBLLhB", "TimeUS,Tot,Seq,Lat,Lng,Alt,Flags", "s--DUm-", "F--GGB-" },  \
     { LOG_MAV_MSG, sizeof(log_MAV),   \
@@ -1276,7 +1305,7 @@ LOG_STRUCTURE_FROM_VISUALODOM \
       "FILE",   "NIBZ",       "FileName,Offset,Length,Data", "----", "----" }, \
 LOG_STRUCTURE_FROM_AIS \
     { LOG_SCRIPTING_MSG, sizeof(log_Scripting), \
-      "SCR",   "QNIii", "TimeUS,Name,Runtime,Total_mem,Run_mem", "s#sbb", "F-F--", true }, \
+      "SCR",   "QNIiiIII", "TimeUS,Name,Runtime,Total_mem,Run_mem,Insn,Alloc,GCtime", "s#sbb-bs", "F-F----F", true }, \
     { LOG_VER_MSG, sizeof(log_VER), \
       "VER",   "QBHBBBBIZHBB", "TimeUS,BT,BST,Maj,Min,Pat,FWT,GH,FWS,APJ,BU,FV", "s-----------", "F-----------", false }, \
     { LOG_MOTBATT_MSG, sizeof(log_MotBatt), \
@@ -1368,6 +1397,7 @@ enum LogMessages : uint8_t {
     LOG_RCOUT3_MSG,
     LOG_IDS_FROM_FENCE,
     LOG_IDS_FROM_HAL,
+    LOG_DF_BLOCK_STATS,
 
     _LOG_LAST_MSG_
 };
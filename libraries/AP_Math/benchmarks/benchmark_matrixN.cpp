@@ -0,0 +1,115 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/matrixN.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+typedef MatrixN<float,4> Matrix4f;
+typedef VectorN<float,4> Vector4f;
+
+static void fill(Matrix4f &m, float seed)
+{
+    for (uint8_t i = 0; i < 4; i++) {
+        for (uint8_t j = 0; j < 4; j++) {
+            m[i][j] = sinf(seed + i * 4 + j);
+        }
+    }
+}
+
+/*
+  the covariance correction in the soaring EKF, P -= K * P12', with
+  the temporary matrix it used before sub_outer()
+ */
+static void BM_MatrixNSubOuterTemp(benchmark::State& state)
+{
+    Matrix4f P;
+    fill(P, 1);
+    Vector4f K, P12;
+    for (uint8_t i = 0; i < 4; i++) {
+        K[i] = 1e-3f * i;
+        P12[i] = 1e-3f * (4 - i);
+    }
+
+    while (state.KeepRunning()) {
+        Matrix4f tempM;
+        tempM.mult(K, P12);
+        P -= tempM;
+        gbenchmark_escape(&P);
+    }
+}
+
+BENCHMARK(BM_MatrixNSubOuterTemp);
+
+static void BM_MatrixNSubOuter(benchmark::State& state)
+{
+    Matrix4f P;
+    fill(P, 1);
+    Vector4f K, P12;
+    for (uint8_t i = 0; i < 4; i++) {
+        K[i] = 1e-3f * i;
+        P12[i] = 1e-3f * (4 - i);
+    }
+
+    while (state.KeepRunning()) {
+        P.sub_outer(K, P12);
+        gbenchmark_escape(&P);
+    }
+}
+
+BENCHMARK(BM_MatrixNSubOuter);
+
+/*
+  covariance prediction P = F * P * F' + Q built from the element wise
+  loops MatrixN had before mult() and transform()
+ */
+static void BM_MatrixNTransformNaive(benchmark::State& state)
+{
+    Matrix4f F, P0, Q;
+    fill(F, 2);
+    fill(P0, 3);
+    fill(Q, 4);
+
+    while (state.KeepRunning()) {
+        // start from the same P each time so it doesn't diverge
+        Matrix4f P = P0;
+        Matrix4f FP, FPFt;
+        for (uint8_t i = 0; i < 4; i++) {
+            for (uint8_t j = 0; j < 4; j++) {
+                for (uint8_t k = 0; k < 4; k++) {
+                    FP[i][j] += F[i][k] * P[k][j];
+                }
+            }
+        }
+        for (uint8_t i = 0; i < 4; i++) {
+            for (uint8_t j = 0; j < 4; j++) {
+                for (uint8_t k = 0; k < 4; k++) {
+                    FPFt[i][j] += FP[i][k] * F[j][k];
+                }
+            }
+        }
+        FPFt += Q;
+        gbenchmark_escape(&FPFt);
+    }
+}
+
+BENCHMARK(BM_MatrixNTransformNaive);
+
+static void BM_MatrixNTransform(benchmark::State& state)
+{
+    Matrix4f F, P0, Q;
+    fill(F, 2);
+    fill(P0, 3);
+    fill(Q, 4);
+
+    while (state.KeepRunning()) {
+        // start from the same P each time so it doesn't diverge
+        Matrix4f P = P0;
+        P.transform(F, Q);
+        gbenchmark_escape(&P);
+    }
+}
+
+BENCHMARK(BM_MatrixNTransform);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,89 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  each benchmark takes the rotation as its argument and is run for
+  every standard rotation
+ */
+static void all_rotations(benchmark::internal::Benchmark *b)
+{
+    for (uint8_t r = ROTATION_NONE; r < ROTATION_MAX; r++) {
+        b->Arg(r);
+    }
+}
+
+static void BM_VectorRotate(benchmark::State& state)
+{
+    const enum Rotation rotation = (enum Rotation)state.range_x();
+    Vector3f v(1.0f, 2.0f, 3.0f);
+
+    while (state.KeepRunning()) {
+        v.rotate(rotation);
+        gbenchmark_escape(&v);
+    }
+}
+
+BENCHMARK(BM_VectorRotate)->Apply(all_rotations);
+
+static void BM_VectorRotateInverse(benchmark::State& state)
+{
+    const enum Rotation rotation = (enum Rotation)state.range_x();
+    Vector3f v(1.0f, 2.0f, 3.0f);
+
+    while (state.KeepRunning()) {
+        v.rotate_inverse(rotation);
+        gbenchmark_escape(&v);
+    }
+}
+
+BENCHMARK(BM_VectorRotateInverse)->Apply(all_rotations);
+
+static void BM_MatrixFromRotation(benchmark::State& state)
+{
+    const enum Rotation rotation = (enum Rotation)state.range_x();
+    Matrix3f m;
+
+    while (state.KeepRunning()) {
+        m.from_rotation(rotation);
+        gbenchmark_escape(&m);
+    }
+}
+
+BENCHMARK(BM_MatrixFromRotation)->Apply(all_rotations);
+
+// sensor orientation followed by board orientation, as done for each IMU sample
+static void BM_SensorToBodyTwoRotations(benchmark::State& state)
+{
+    const enum Rotation rotation = (enum Rotation)state.range_x();
+    Vector3f v(1.0f, 2.0f, 3.0f);
+
+    while (state.KeepRunning()) {
+        v.rotate(rotation);
+        v.rotate(ROTATION_YAW_90);
+        gbenchmark_escape(&v);
+    }
+}
+
+BENCHMARK(BM_SensorToBodyTwoRotations)->Apply(all_rotations);
+
+static void BM_SensorToBodyFused(benchmark::State& state)
+{
+    const enum Rotation rotation = (enum Rotation)state.range_x();
+    Matrix3f sensor_m, board_m;
+    sensor_m.from_rotation(rotation);
+    board_m.from_rotation(ROTATION_YAW_90);
+    const Matrix3f m = board_m * sensor_m;
+    Vector3f v(1.0f, 2.0f, 3.0f);
+
+    while (state.KeepRunning()) {
+        v = m * v;
+        gbenchmark_escape(&v);
+    }
+}
+
+BENCHMARK(BM_SensorToBodyFused)->Apply(all_rotations);
+
+BENCHMARK_MAIN();
@@ -59,9 +59,203 @@ void Matrix3<T>::to_euler(T *roll, T *pitch, T *yaw) const
     }
 }
 
+/*
+  rotation matrices for the standard rotations, matching the results
+  of Vector3::rotate(). Indexed by enum Rotation
+ */
+static const ftype rotation_matrices[][3][3] = {
+    // ROTATION_NONE
+    { { 1, 0, 0 },
+      { 0, 1, 0 },
+      { 0, 0, 1 } },
+    // ROTATION_YAW_45
+    { { HALF_SQRT_2, -HALF_SQRT_2, 0 },
+      { HALF_SQRT_2, HALF_SQRT_2, 0 },
+      { 0, 0, 1 } },
+    // ROTATION_YAW_90
+    { { 0, -1, 0 },
+      { 1, 0, 0 },
+      { 0, 0, 1 } },
+    // ROTATION_YAW_135
+    { { -HALF_SQRT_2, -HALF_SQRT_2, 0 },
+      { HALF_SQRT_2, -HALF_SQRT_2, 0 },
+      { 0, 0, 1 } },
+    // ROTATION_YAW_180
+    { { -1, 0, 0 },
+      { 0, -1, 0 },
+      { 0, 0, 1 } },
+    // ROTATION_YAW_225
+    { { -HALF_SQRT_2, HALF_SQRT_2, 0 },
+      { -HALF_SQRT_2, -HALF_SQRT_2, 0 },
+      { 0, 0, 1 } },
+    // ROTATION_YAW_270
+    { { 0, 1, 0 },
+      { -1, 0, 0 },
+      { 0, 0, 1 } },
+    // ROTATION_YAW_315
+    { { HALF_SQRT_2, HALF_SQRT_2, 0 },
+      { -HALF_SQRT_2, HALF_SQRT_2, 0 },
+      { 0, 0, 1 } },
+    // ROTATION_ROLL_180
+    { { 1, 0, 0 },
+      { 0, -1, 0 },
+      { 0, 0, -1 } },
+    // ROTATION_ROLL_180_YAW_45
+    { { HALF_SQRT_2, HALF_SQRT_2, 0 },
+      { HALF_SQRT_2, -HALF_SQRT_2, 0 },
+      { 0, 0, -1 } },
+    // ROTATION_ROLL_180_YAW_90
+    { { 0, 1, 0 },
+      { 1, 0, 0 },
+      { 0, 0, -1 } },
+    // ROTATION_ROLL_180_YAW_135
+    { { -HALF_SQRT_2, HALF_SQRT_2, 0 },
+      { HALF_SQRT_2, HALF_SQRT_2, 0 },
+      { 0, 0, -1 } },
+    // ROTATION_PITCH_180
+    { { -1, 0, 0 },
+      { 0, 1, 0 },
+      { 0, 0, -1 } },
+    // ROTATION_ROLL_180_YAW_225
+    { { -HALF_SQRT_2, -HALF_SQRT_2, 0 },
+      { -HALF_SQRT_2, HALF_SQRT_2, 0 },
+      { 0, 0, -1 } },
+    // ROTATION_ROLL_180_YAW_270
+    { { 0, -1, 0 },
+      { -1, 0, 0 },
+      { 0, 0, -1 } },
+    // ROTATION_ROLL_180_YAW_315
+    { { HALF_SQRT_2, -HALF_SQRT_2, 0 },
+      { -HALF_SQRT_2, -HALF_SQRT_2, 0 },
+      { 0, 0, -1 } },
+    // ROTATION_ROLL_90
+    { { 1, 0, 0 },
+      { 0, 0, -1 },
+      { 0, 1, 0 } },
+    // ROTATION_ROLL_90_YAW_45
+    { { HALF_SQRT_2, 0, HALF_SQRT_2 },
+      { HALF_SQRT_2, 0, -HALF_SQRT_2 },
+      { 0, 1, 0 } },
+    // ROTATION_ROLL_90_YAW_90
+    { { 0, 0, 1 },
+      { 1, 0, 0 },
+      { 0, 1, 0 } },
+    // ROTATION_ROLL_90_YAW_135
+    { { -HALF_SQRT_2, 0, HALF_SQRT_2 },
+      { HALF_SQRT_2, 0, HALF_SQRT_2 },
+      { 0, 1, 0 } },
+    // ROTATION_ROLL_270
+    { { 1, 0, 0 },
+      { 0, 0, 1 },
+      { 0, -1, 0 } },
+    // ROTATION_ROLL_270_YAW_45
+    { { HALF_SQRT_2, 0, -HALF_SQRT_2 },
+      { HALF_SQRT_2, 0, HALF_SQRT_2 },
+      { 0, -1, 0 } },
+    // ROTATION_ROLL_270_YAW_90
+    { { 0, 0, -1 },
+      { 1, 0, 0 },
+      { 0, -1, 0 } },
+    // ROTATION_ROLL_270_YAW_135
+    { { -HALF_SQRT_2, 0, -HALF_SQRT_2 },
+      { HALF_SQRT_2, 0, -HALF_SQRT_2 },
+      { 0, -1, 0 } },
+    // ROTATION_PITCH_90
+    { { 0, 0, 1 },
+      { 0, 1, 0 },
+      { -1, 0, 0 } },
+    // ROTATION_PITCH_270
+    { { 0, 0, -1 },
+      { 0, 1, 0 },
+      { 1, 0, 0 } },
+    // ROTATION_PITCH_180_YAW_90
+    { { 0, -1, 0 },
+      { -1, 0, 0 },
+      { 0, 0, -1 } },
+    // ROTATION_PITCH_180_YAW_270
+    { { 0, 1, 0 },
+      { 1, 0, 0 },
+      { 0, 0, -1 } },
+    // ROTATION_ROLL_90_PITCH_90
+    { { 0, 1, 0 },
+      { 0, 0, -1 },
+      { -1, 0, 0 } },
+    // ROTATION_ROLL_180_PITCH_90
+    { { 0, 0, -1 },
+      { 0, -1, 0 },
+      { -1, 0, 0 } },
+    // ROTATION_ROLL_270_PITCH_90
+    { { 0, -1, 0 },
+      { 0, 0, 1 },
+      { -1, 0, 0 } },
+    // ROTATION_ROLL_90_PITCH_180
+    { { -1, 0, 0 },
+      { 0, 0, -1 },
+      { 0, -1, 0 } },
+    // ROTATION_ROLL_270_PITCH_180
+    { { -1, 0, 0 },
+      { 0, 0, 1 },
+      { 0, 1, 0 } },
+    // ROTATION_ROLL_90_PITCH_270
+    { { 0, -1, 0 },
+      { 0, 0, -1 },
+      { 1, 0, 0 } },
+    // ROTATION_ROLL_180_PITCH_270
+    { { 0, 0, 1 },
+      { 0, -1, 0 },
+      { 1, 0, 0 } },
+    // ROTATION_ROLL_270_PITCH_270
+    { { 0, 1, 0 },
+      { 0, 0, 1 },
+      { 1, 0, 0 } },
+    // ROTATION_ROLL_90_PITCH_180_YAW_90
+    { { 0, 0, 1 },
+      { -1, 0, 0 },
+      { 0, -1, 0 } },
+    // ROTATION_ROLL_90_YAW_270
+    { { 0, 0, -1 },
+      { -1, 0, 0 },
+      { 0, 1, 0 } },
+    // ROTATION_ROLL_90_PITCH_68_YAW_293
+    { { 0.14303897231223747, 0.36877648650320383, -0.91844638134308709 },
+      { -0.3321327777966474, -0.85628942146641884, -0.39554550256296522 },
+      { -0.93232380121551217, 0.36162457008209242, 0 } },
+    // ROTATION_PITCH_315
+    { { HALF_SQRT_2, 0, -HALF_SQRT_2 },
+      { 0, 1, 0 },
+      { HALF_SQRT_2, 0, HALF_SQRT_2 } },
+    // ROTATION_ROLL_90_PITCH_315
+    { { HALF_SQRT_2, -HALF_SQRT_2, 0 },
+      { 0, 0, -1 },
+      { HALF_SQRT_2, HALF_SQRT_2, 0 } },
+    // ROTATION_PITCH_7
+    { { 0.99254615164132198, 0, 0.12186934340514749 },
+      { 0, 1, 0 },
+      { -0.12186934340514749, 0, 0.99254615164132198 } },
+    // ROTATION_ROLL_45
+    { { 1, 0, 0 },
+      { 0, HALF_SQRT_2, -HALF_SQRT_2 },
+      { 0, HALF_SQRT_2, HALF_SQRT_2 } },
+    // ROTATION_ROLL_315
+    { { 1, 0, 0 },
+      { 0, HALF_SQRT_2, HALF_SQRT_2 },
+      { 0, -HALF_SQRT_2, HALF_SQRT_2 } },
+};
+static_assert(ARRAY_SIZE(rotation_matrices) == ROTATION_MAX, "rotation_matrices must have an entry for each rotation");
+
 template <typename T>
 void Matrix3<T>::from_rotation(enum Rotation rotation)
 {
+    if (rotation < ROTATION_MAX) {
+        const ftype (&m)[3][3] = rotation_matrices[rotation];
+        a = Vector3<T>(m[0][0], m[0][1], m[0][2]);
+        b = Vector3<T>(m[1][0], m[1][1], m[1][2]);
+        c = Vector3<T>(m[2][0], m[2][1], m[2][2]);
+        return;
+    }
+
+    // custom rotations can change at runtime, so build the matrix
+    // from the rotated unit vectors
     (*this).a = {1,0,0};
     (*this).b = {0,1,0};
     (*this).c = {0,0,1};
@@ -18,6 +18,59 @@ void MatrixN<T,N>::mult(const VectorN<T,N> &A, const VectorN<T,N> &B)
     }
 }
 
+// multiply two matrices to give a matrix, in-place. A or B may be
+// this matrix
+template <typename T, uint8_t N>
+void MatrixN<T,N>::mult(const MatrixN<T,N> &A, const MatrixN<T,N> &B)
+{
+    // accumulate a row at a time so the inner loop runs along
+    // contiguous rows of B and the result. The result goes in a
+    // temporary as later rows still read A and B
+    T res[N][N] {};
+    for (uint8_t i = 0; i < N; i++) {
+        for (uint8_t k = 0; k < N; k++) {
+            const T a = A.v[i][k];
+            for (uint8_t j = 0; j < N; j++) {
+                res[i][j] += a * B.v[k][j];
+            }
+        }
+    }
+    memcpy(v, res, sizeof(v));
+}
+
+// subtract the product of two vectors, in-place
+template <typename T, uint8_t N>
+void MatrixN<T,N>::sub_outer(const VectorN<T,N> &A, const VectorN<T,N> &B)
+{
+    for (uint8_t i = 0; i < N; i++) {
+        const T a = A[i];
+        for (uint8_t j = 0; j < N; j++) {
+            v[i][j] -= a * B[j];
+        }
+    }
+}
+
+// P = F * P * F' + Q, in-place
+template <typename T, uint8_t N>
+void MatrixN<T,N>::transform(const MatrixN<T,N> &F, const MatrixN<T,N> &Q)
+{
+    // FP = F * P
+    MatrixN<T,N> FP;
+    FP.mult(F, *this);
+
+    // P = FP * F' + Q, the upper triangle is a dot product of rows
+    for (uint8_t i = 0; i < N; i++) {
+        for (uint8_t j = i; j < N; j++) {
+            T sum = Q.v[i][j];
+            for (uint8_t k = 0; k < N; k++) {
+                sum += FP.v[i][k] * F.v[j][k];
+            }
+            v[i][j] = sum;
+            v[j][i] = sum;
+        }
+    }
+}
+
 // subtract B from the matrix
 template <typename T, uint8_t N>
 MatrixN<T,N> &MatrixN<T,N>::operator -=(const MatrixN<T,N> &B)
@@ -55,6 +108,9 @@ void MatrixN<T,N>::force_symmetry(void)
 }
 
 template void MatrixN<float,4>::mult(const VectorN<float,4> &A, const VectorN<float,4> &B);
+template void MatrixN<float,4>::mult(const MatrixN<float,4> &A, const MatrixN<float,4> &B);
+template void MatrixN<float,4>::sub_outer(const VectorN<float,4> &A, const VectorN<float,4> &B);
+template void MatrixN<float,4>::transform(const MatrixN<float,4> &F, const MatrixN<float,4> &Q);
 template MatrixN<float,4> &MatrixN<float,4>::operator -=(const MatrixN<float,4> &B);
 template MatrixN<float,4> &MatrixN<float,4>::operator +=(const MatrixN<float,4> &B);
 template void MatrixN<float,4>::force_symmetry(void);
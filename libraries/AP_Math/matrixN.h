@@ -31,9 +31,31 @@ public:
         }
     }
 
+    // row access
+    inline T *operator[](uint8_t i) {
+        return v[i];
+    }
+
+    inline const T *operator[](uint8_t i) const {
+        return v[i];
+    }
+
     // multiply two vectors to give a matrix, in-place
     void mult(const VectorN<T,N> &A, const VectorN<T,N> &B);
 
+    // multiply two matrices to give a matrix, in-place
+    // C = A * B, where A or B may be C
+    void mult(const MatrixN<T,N> &A, const MatrixN<T,N> &B);
+
+    // subtract the product of two vectors without a temporary matrix
+    // C -= A * B'
+    void sub_outer(const VectorN<T,N> &A, const VectorN<T,N> &B);
+
+    // covariance prediction, in-place and only computing the upper
+    // triangle as the result is symmetric
+    // P = F * P * F' + Q
+    void transform(const MatrixN<T,N> &F, const MatrixN<T,N> &Q);
+
     // subtract B from the matrix
     MatrixN<T,N> &operator -=(const MatrixN<T,N> &B);
 
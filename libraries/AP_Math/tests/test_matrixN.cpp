@@ -0,0 +1,147 @@
+#include <AP_gtest.h>
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/matrixN.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static const uint8_t N = 4;
+typedef MatrixN<float,N> MatrixNf;
+typedef VectorN<float,N> VectorNf;
+
+static void fill(MatrixNf &m, float seed)
+{
+    for (uint8_t i = 0; i < N; i++) {
+        for (uint8_t j = 0; j < N; j++) {
+            m[i][j] = sinf(seed + i * N + j);
+        }
+    }
+}
+
+// naive reference, C = A * B
+static void reference_mult(MatrixNf &C, const MatrixNf &A, const MatrixNf &B)
+{
+    for (uint8_t i = 0; i < N; i++) {
+        for (uint8_t j = 0; j < N; j++) {
+            C[i][j] = 0;
+            for (uint8_t k = 0; k < N; k++) {
+                C[i][j] += A[i][k] * B[k][j];
+            }
+        }
+    }
+}
+
+static void expect_matrix_near(const MatrixNf &a, const MatrixNf &b, float tol)
+{
+    for (uint8_t i = 0; i < N; i++) {
+        for (uint8_t j = 0; j < N; j++) {
+            EXPECT_NEAR(a[i][j], b[i][j], tol);
+        }
+    }
+}
+
+TEST(MatrixNTest, MultMatrix)
+{
+    MatrixNf A, B, C, expected;
+    fill(A, 1);
+    fill(B, 2);
+    C.mult(A, B);
+    reference_mult(expected, A, B);
+    expect_matrix_near(C, expected, 1e-6);
+}
+
+TEST(MatrixNTest, MultAliased)
+{
+    MatrixNf A, B, expected;
+    fill(A, 1);
+    fill(B, 2);
+
+    // C = C * B
+    reference_mult(expected, A, B);
+    MatrixNf C = A;
+    C.mult(C, B);
+    expect_matrix_near(C, expected, 1e-6);
+
+    // C = A * C
+    C = B;
+    C.mult(A, C);
+    expect_matrix_near(C, expected, 1e-6);
+
+    // C = C * C
+    reference_mult(expected, A, A);
+    C = A;
+    C.mult(C, C);
+    expect_matrix_near(C, expected, 1e-6);
+}
+
+TEST(MatrixNTest, SubOuter)
+{
+    MatrixNf P, expected;
+    fill(P, 3);
+    expected = P;
+    VectorNf a, b;
+    for (uint8_t i = 0; i < N; i++) {
+        a[i] = i + 1;
+        b[i] = 0.5f - i;
+    }
+
+    P.sub_outer(a, b);
+
+    // must match the temporary matrix it replaces, allowing for
+    // targets that contract the multiply and subtract
+    MatrixNf outer;
+    outer.mult(a, b);
+    expected -= outer;
+    expect_matrix_near(P, expected, 1e-5);
+}
+
+TEST(MatrixNTest, Transform)
+{
+    MatrixNf F, P, Q;
+    fill(F, 4);
+    const float p_diag[N] { 1, 2, 3, 4 };
+    const float q_diag[N] { 0.1f, 0.2f, 0.3f, 0.4f };
+    P = MatrixNf(p_diag);
+    Q = MatrixNf(q_diag);
+
+    // F * P * F' + Q the long way
+    MatrixNf FP, Ft, expected;
+    for (uint8_t i = 0; i < N; i++) {
+        for (uint8_t j = 0; j < N; j++) {
+            Ft[i][j] = F[j][i];
+        }
+    }
+    reference_mult(FP, F, P);
+    reference_mult(expected, FP, Ft);
+    expected += Q;
+
+    P.transform(F, Q);
+    expect_matrix_near(P, expected, 1e-5);
+
+    // and the result is symmetric
+    for (uint8_t i = 0; i < N; i++) {
+        for (uint8_t j = 0; j < N; j++) {
+            EXPECT_FLOAT_EQ(P[i][j], P[j][i]);
+        }
+    }
+}
+
+TEST(MatrixNTest, MultVector)
+{
+    MatrixNf A;
+    fill(A, 5);
+    VectorNf x, y;
+    for (uint8_t i = 0; i < N; i++) {
+        x[i] = i - 1.5f;
+    }
+    y.mult(A, x);
+    for (uint8_t i = 0; i < N; i++) {
+        float expected = 0;
+        for (uint8_t k = 0; k < N; k++) {
+            expected += A[i][k] * x[k];
+        }
+        EXPECT_FLOAT_EQ(y[i], expected);
+    }
+}
+
+AP_GTEST_MAIN()
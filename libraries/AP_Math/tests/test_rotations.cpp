@@ -138,6 +138,28 @@ TEST(RotationsTest, TestRotateMatrix)
     }
 }
 
+TEST(RotationsTest, TestFusedRotation)
+{
+    // a sensor rotation followed by a board rotation is the product of their matrices
+    for (enum Rotation s = ROTATION_NONE;
+         s < ROTATION_MAX;
+         s = (enum Rotation)((uint8_t)s+1)) {
+        for (enum Rotation b = ROTATION_NONE;
+             b < ROTATION_MAX;
+             b = (enum Rotation)((uint8_t)b+1)) {
+            Vector3f vec(1,2,3);
+            Vector3f vec2 = vec;
+            vec.rotate(s);
+            vec.rotate(b);
+            Matrix3f ms, mb;
+            ms.from_rotation(s);
+            mb.from_rotation(b);
+            vec2 = (mb * ms) * vec2;
+            EXPECT_LE((vec - vec2).length(), 1e-5);
+        }
+    }
+}
+
 #if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
 TEST(RotationsTest, TestFailedGetLinux)
 {
@@ -276,19 +276,8 @@ void Vector3<T>::rotate(enum Rotation rotation)
 template <typename T>
 void Vector3<T>::rotate_inverse(enum Rotation rotation)
 {
-    Vector3<T> x_vec(1.0f,0.0f,0.0f);
-    Vector3<T> y_vec(0.0f,1.0f,0.0f);
-    Vector3<T> z_vec(0.0f,0.0f,1.0f);
-
-    x_vec.rotate(rotation);
-    y_vec.rotate(rotation);
-    z_vec.rotate(rotation);
-
-    Matrix3<T> M(
-        x_vec.x, y_vec.x, z_vec.x,
-        x_vec.y, y_vec.y, z_vec.y,
-        x_vec.z, y_vec.z, z_vec.z
-    );
+    Matrix3<T> M;
+    M.from_rotation(rotation);
 
     (*this) = M.mul_transpose(*this);
 }
@@ -164,10 +164,13 @@ public:
     // C = A * B
     void mult(const MatrixN<T,N> &A, const VectorN<T,N> &B) {
         for (uint8_t i = 0; i < N; i++) {
-            _v[i] = 0;
+            // accumulate locally, the compiler can't prove B doesn't
+            // alias this so would otherwise store _v[i] every step
+            T sum = 0;
             for (uint8_t k = 0; k < N; k++) {
-                _v[i] += A.v[i][k] * B[k];
+                sum += A.v[i][k] * B[k];
             }
+            _v[i] = sum;
         }
     }
 
@@ -67,6 +67,8 @@ void MultiHeap::destroy(void)
     if (!available()) {
         return;
     }
+    // pooled blocks still count as in use by the heaps
+    flush_pool();
     for (uint8_t i=0; i<num_heaps; i++) {
         if (heaps[i].hp != nullptr) {
             heap_destroy(heaps[i].hp);
@@ -94,15 +96,27 @@ void *MultiHeap::allocate(uint32_t size)
     if (!available() || size == 0) {
         return nullptr;
     }
-    for (uint8_t i=0; i<num_heaps; i++) {
-        if (heaps[i].hp == nullptr) {
-            break;
-        }
-        void *newptr = heap_allocate(heaps[i].hp, size);
-        if (newptr != nullptr) {
+    const int8_t cls = pool_class(size);
+    if (cls >= 0) {
+        // small blocks are always allocated at the size of their
+        // class so they can be recycled for any size in the class
+        PoolBlock *b = pool[cls];
+        if (b != nullptr) {
+            pool[cls] = b->next;
+            pool_count[cls]--;
             last_failed = false;
-            return newptr;
+            return b;
         }
+        size = (cls + 1) * MULTIHEAP_POOL_GRANULARITY;
+    }
+    void *newptr = allocate_from_heaps(size);
+    if (newptr == nullptr && flush_pool()) {
+        // blocks held in the pool may have been fragmenting the heaps
+        newptr = allocate_from_heaps(size);
+    }
+    if (newptr != nullptr) {
+        last_failed = false;
+        return newptr;
     }
     if (!allow_expansion || !last_failed) {
         /*
@@ -159,6 +173,23 @@ void *MultiHeap::allocate(uint32_t size)
     return nullptr;
 }
 
+/*
+  allocate from the existing heaps without expansion
+ */
+void *MultiHeap::allocate_from_heaps(uint32_t size)
+{
+    for (uint8_t i=0; i<num_heaps; i++) {
+        if (heaps[i].hp == nullptr) {
+            break;
+        }
+        void *newptr = heap_allocate(heaps[i].hp, size);
+        if (newptr != nullptr) {
+            return newptr;
+        }
+    }
+    return nullptr;
+}
+
 /*
   free memory from a heap
  */
@@ -177,9 +208,22 @@ void MultiHeap::deallocate(void *ptr)
 void *MultiHeap::change_size(void *ptr, uint32_t old_size, uint32_t new_size)
 {
     if (new_size == 0) {
+        const int8_t cls = pool_class(old_size);
+        if (ptr != nullptr && cls >= 0 && pool_count[cls] < MULTIHEAP_POOL_MAX_BLOCKS) {
+            // keep the block for re-use
+            PoolBlock *b = (PoolBlock *)ptr;
+            b->next = pool[cls];
+            pool[cls] = b;
+            pool_count[cls]++;
+            return nullptr;
+        }
         deallocate(ptr);
         return nullptr;
     }
+    if (ptr != nullptr && pool_class(old_size) >= 0 && pool_class(old_size) == pool_class(new_size)) {
+        // block was allocated at the size of its class, so it already fits
+        return ptr;
+    }
     /*
       we don't want to require the underlying allocation system to
       support realloc() and we also want to be able to handle the case
@@ -199,8 +243,27 @@ void *MultiHeap::change_size(void *ptr, uint32_t old_size, uint32_t new_size)
         return nullptr;
     }
     memcpy(newp, ptr, MIN(old_size, new_size));
-    deallocate(ptr);
+    change_size(ptr, old_size, 0);
     return newp;
 }
 
+/*
+  return all pooled blocks to the underlying heaps, returns true if
+  any blocks were freed
+ */
+bool MultiHeap::flush_pool(void)
+{
+    bool freed = false;
+    for (uint8_t i=0; i<MULTIHEAP_POOL_NUM_SIZES; i++) {
+        while (pool[i] != nullptr) {
+            PoolBlock *b = pool[i];
+            pool[i] = b->next;
+            heap_free(b);
+            freed = true;
+        }
+        pool_count[i] = 0;
+    }
+    return freed;
+}
+
 #endif // ENABLE_HEAP
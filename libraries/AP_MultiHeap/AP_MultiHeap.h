@@ -14,6 +14,24 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+/*
+  small allocations are rounded up to a multiple of the pool
+  granularity and recycled through per-size free lists rather than
+  being returned to the underlying heap. This makes the many small
+  userdata objects created by scripting bindings cheap to allocate
+  and free. It does not change how much garbage scripts create, so
+  the Lua garbage collector does the same amount of work
+ */
+#ifndef MULTIHEAP_POOL_GRANULARITY
+#define MULTIHEAP_POOL_GRANULARITY 8
+#endif
+#ifndef MULTIHEAP_POOL_NUM_SIZES
+#define MULTIHEAP_POOL_NUM_SIZES 8
+#endif
+#ifndef MULTIHEAP_POOL_MAX_BLOCKS
+#define MULTIHEAP_POOL_MAX_BLOCKS 32
+#endif
+
 class MultiHeap {
 public:
     /*
@@ -32,9 +50,14 @@ public:
     // change allocated size of a pointer - this operates in a similar
     // fashion to realloc, but requires an (accurate!) old_size value
     // when ptr is not NULL. This is guaranteed by the lua scripting
-    // allocation API
+    // allocation API. Small blocks freed through this call are kept
+    // for re-use by later allocations of the same size
     void *change_size(void *ptr, uint32_t old_size, uint32_t new_size);
 
+    // return all pooled blocks to the underlying heaps, returns true
+    // if any blocks were freed
+    bool flush_pool(void);
+
     /*
       get the size that we have expanded to. Used by error reporting in scripting
      */
@@ -59,6 +82,26 @@ private:
     // re-use memory when possible
     bool last_failed;
 
+    // free lists of small blocks, indexed by size class. The link to
+    // the next free block is stored in the block itself
+    struct PoolBlock {
+        PoolBlock *next;
+    };
+    static_assert(MULTIHEAP_POOL_GRANULARITY >= sizeof(PoolBlock), "pool granularity too small");
+    PoolBlock *pool[MULTIHEAP_POOL_NUM_SIZES];
+    uint8_t pool_count[MULTIHEAP_POOL_NUM_SIZES];
+
+    // return the pool size class for an allocation size, or -1 if not pooled
+    static int8_t pool_class(uint32_t size) {
+        if (size == 0 || size > MULTIHEAP_POOL_GRANULARITY * MULTIHEAP_POOL_NUM_SIZES) {
+            return -1;
+        }
+        return (size - 1) / MULTIHEAP_POOL_GRANULARITY;
+    }
+
+    // allocate from the existing heaps without expansion
+    void *allocate_from_heaps(uint32_t size);
+
 
     /*
       low level allocation functions
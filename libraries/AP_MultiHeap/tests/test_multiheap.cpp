@@ -54,4 +54,61 @@ TEST(MultiHeap, Tests)
     delete[] allocs;
 }
 
+TEST(MultiHeap, Pool)
+{
+    static MultiHeap h;
+
+    EXPECT_TRUE(h.create(20000, 1, false, 0));
+
+    // a freed small block is handed back for the next allocation of the same class
+    void *a = h.allocate(10);
+    EXPECT_TRUE(a != nullptr);
+    memset(a, 0x55, 10);
+    EXPECT_EQ(h.change_size(a, 10, 0), nullptr);
+    void *b = h.allocate(16);
+    EXPECT_EQ(a, b);
+
+    // shrinking or growing within the size class keeps the block in place
+    EXPECT_EQ(h.change_size(b, 16, 12), b);
+    EXPECT_EQ(h.change_size(b, 12, 16), b);
+
+    // growing out of the size class moves the data
+    memset(b, 0xAA, 16);
+    void *c = h.change_size(b, 16, 100);
+    EXPECT_TRUE(c != nullptr);
+    EXPECT_NE(b, c);
+    for (uint8_t i=0; i<16; i++) {
+        EXPECT_EQ(((uint8_t *)c)[i], 0xAA);
+    }
+
+    // a different size class does not reuse the block
+    void *d = h.allocate(40);
+    EXPECT_NE(d, b);
+    h.change_size(d, 40, 0);
+    h.change_size(c, 100, 0);
+
+    // fill the heap with small blocks, free them all and check that
+    // a large allocation succeeds once the pool has been flushed
+    const uint32_t max_allocs = 2000;
+    auto *ptrs = new void*[max_allocs];
+    uint32_t n = 0;
+    while (n < max_allocs) {
+        ptrs[n] = h.allocate(24);
+        if (ptrs[n] == nullptr) {
+            break;
+        }
+        n++;
+    }
+    EXPECT_GT(n, 0U);
+    for (uint32_t i=0; i<n; i++) {
+        h.change_size(ptrs[i], 24, 0);
+    }
+    void *big = h.allocate(10000);
+    EXPECT_TRUE(big != nullptr);
+    h.deallocate(big);
+
+    h.destroy();
+    delete[] ptrs;
+}
+
 AP_GTEST_MAIN()
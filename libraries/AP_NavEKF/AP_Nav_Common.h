@@ -104,4 +104,7 @@ struct ekf_timing {
     float delVelDT_min;
 };
 
+// number of yaw hypotheses in EKFGSF_yaw, at least 5 for logging
+#ifndef N_MODELS_EKFGSF
 #define N_MODELS_EKFGSF 5U
+#endif
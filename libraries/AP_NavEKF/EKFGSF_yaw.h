@@ -41,6 +41,10 @@ public:
     // return false if not available
     bool getVelInnovLength(ftype &velInnovLength) const;
 
+    // get the weighting applied to each model, the weights sum to one
+    // return false if yaw estimation is inactive
+    bool getWeights(ftype weights[N_MODELS_EKFGSF]) const;
+
     // log EKFGSF data on behalf of an EKF caller.  id0 and id1 are the
     // IDs of the messages to log, e.g. LOG_NKY0_MSG, LOG_NKY1_MSG
     void Log_Write(uint64_t time_us, LogMessages id0, LogMessages id1, uint8_t core_index);
@@ -101,29 +105,31 @@ private:
     void alignYaw();
 
     // The Following declarations are used by bank of EKF's that estimate yaw angle starting from a different yaw hypothesis for each filter.
+    // The bank is stored as a structure of arrays indexed by model so each step of predict() and correct()
+    // runs over all models in one loop, which the compiler can vectorise.
 
     struct EKF_struct {
-        ftype X[3];     // Vel North (m/s),  Vel East (m/s), yaw (rad)
-        ftype P[3][3];  // covariance matrix
-        ftype S[2][2];  // N,E velocity innovation variance (m/s)^2
-        ftype innov[2]; // Velocity N,E innovation (m/s)
+        ftype X[3][N_MODELS_EKFGSF];     // Vel North (m/s),  Vel East (m/s), yaw (rad)
+        ftype P[3][3][N_MODELS_EKFGSF];  // covariance matrix
+        ftype S[2][2][N_MODELS_EKFGSF];  // N,E velocity innovation variance (m/s)^2
+        ftype innov[2][N_MODELS_EKFGSF]; // Velocity N,E innovation (m/s)
     };
-    EKF_struct EKF[N_MODELS_EKFGSF];
+    EKF_struct EKF;
     bool vel_fuse_running;  // true when the bank of EKF's has started fusing GPS velocity data
     bool run_ekf_gsf;       // true when operating condition is suitable for to run the GSF and EKF models and fuse velocity data
 
     // Resets states and covariances for the EKF's and GSF including GSF weights, but not the AHRS complementary filters
     void resetEKFGSF();
 
-    // Runs the state and covariance prediction for the selected EKF
-    void predict(const uint8_t mdl_idx);
+    // Runs the state and covariance prediction for all EKF's
+    void predict();
 
-    // Runs the state and covariance update for the selected EKF using the GPS NE velocity measurement
-    // Returns false if the sttae and covariance correction failed
-    bool correct(const uint8_t mdl_idx, const Vector2F &vel, const ftype velObsVar);
+    // Runs the state and covariance update for all EKF's using the GPS NE velocity measurement
+    // Returns false if the state and covariance correction failed for any model
+    bool correct(const Vector2F &vel, const ftype velObsVar);
 
-    // Forces symmetry on the covariance matrix for the selected EKF
-    void forceSymmetry(const uint8_t mdl_idx);
+    // Forces symmetry on the covariance matrix for all EKF's
+    void forceSymmetry();
 
     // The following declarations are used  by the Gaussian Sum Filter that combines the state estimates from the bank of
     // EKF's to form a single state estimate.
@@ -135,9 +141,9 @@ private:
     };
     GSF_struct GSF;
 
-    // Returns the probability for a selected model assuming a Gaussian error distribution
+    // Calculates the probability for each model assuming a Gaussian error distribution
     // Used by the Guassian Sum Filter to calculate the weightings when combining the outputs from the bank of EKF's
-    ftype gaussianDensity(const uint8_t mdl_idx) const;
+    void gaussianDensity(ftype density[N_MODELS_EKFGSF]) const;
 
     // number of models whose weights underflowed due to excessive
     // innovation variances:
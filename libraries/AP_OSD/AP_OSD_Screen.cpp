@@ -1685,14 +1685,14 @@ void AP_OSD_Screen::draw_speed(uint8_t x, uint8_t y, float angle_rad, float magn
 
 void AP_OSD_Screen::draw_gspeed(uint8_t x, uint8_t y)
 {
-    AP_AHRS &ahrs = AP::ahrs();
-    WITH_SEMAPHORE(ahrs.get_semaphore());
-    Vector2f v = ahrs.groundspeed_vector();
+    AP_AHRS::Snapshot ahrs;
+    AP::ahrs().get_snapshot(ahrs);
+    const Vector2f &v = ahrs.ground_speed_vec;
     backend->write(x, y, false, "%c", SYMBOL(SYM_GSPD));
     float angle = 0;
     const float length = v.length();
     if (length > 1.0f) {
-        angle = atan2f(v.y, v.x) - ahrs.get_yaw();
+        angle = atan2f(v.y, v.x) - ahrs.yaw;
     }
     draw_speed(x + 1, y, angle, length);
 }
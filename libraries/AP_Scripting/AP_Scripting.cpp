@@ -162,6 +162,16 @@ const AP_Param::GroupInfo AP_Scripting::var_info[] = {
     // @User: Advanced
     AP_GROUPINFO("THD_PRIORITY", 14, AP_Scripting, _thd_priority, uint8_t(ThreadPriority::NORMAL)),
 
+#if AP_SCRIPTING_MAX_VMS > 1
+    // @Param: VM_NUM
+    // @DisplayName: Scripting virtual machine count
+    // @Description: Number of scripting virtual machines to run. Each runs on its own thread with its own heap of SCR_HEAP_SIZE so that scripts on one cannot delay scripts on another. The first runs scripts from the scripts directory and ROMFS, each additional machine runs scripts from the vm1, vm2 and vm3 subdirectories of the scripts directory.
+    // @Range: 1 4
+    // @RebootRequired: True
+    // @User: Advanced
+    AP_GROUPINFO("VM_NUM", 19, AP_Scripting, _num_vms, 1),
+#endif
+
 #if AP_SCRIPTING_SERIALDEVICE_ENABLED
     // @Param: SDEV_EN
     // @DisplayName: Scripting serial device enable
@@ -230,7 +240,7 @@ void AP_Scripting::init(void) {
     }
 #endif
 
-    AP_HAL::Scheduler::priority_base priority = AP_HAL::Scheduler::PRIORITY_SCRIPTING;
+    _hal_priority = AP_HAL::Scheduler::PRIORITY_SCRIPTING;
     static const struct {
         ThreadPriority scr_priority;
         AP_HAL::Scheduler::priority_base hal_priority;
@@ -247,12 +257,12 @@ void AP_Scripting::init(void) {
     };
     for (const auto &p : priority_map) {
         if (p.scr_priority == _thd_priority) {
-            priority = p.hal_priority;
+            _hal_priority = p.hal_priority;
         }
     }
 
     if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&AP_Scripting::thread, void),
-                                      "Scripting", SCRIPTING_STACK_SIZE, priority, 0)) {
+                                      "Scripting", SCRIPTING_STACK_SIZE, _hal_priority, 0)) {
         GCS_SEND_TEXT(MAV_SEVERITY_ERROR, "Scripting: %s", "failed to start");
         _thread_failed = true;
     }
@@ -291,6 +301,19 @@ MAV_RESULT AP_Scripting::handle_command_int_packet(const mavlink_command_int_t &
 }
 #endif
 
+// per-script runtime statistics for @SYS/scripts.txt
+void AP_Scripting::scripts_info(ExpandingString &str)
+{
+    lua_scripts::stats_header(str);
+
+    WITH_SEMAPHORE(_lua_sem);
+    for (auto *lua : _lua) {
+        if (lua != nullptr) {
+            lua->stats_info(str);
+        }
+    }
+}
+
 /*
   avoid optimisation of the thread function. This avoids nasty traps
   where setjmp/longjmp does not properly handle save/restore of
@@ -300,6 +323,66 @@ MAV_RESULT AP_Scripting::handle_command_int_packet(const mavlink_command_int_t &
 #pragma GCC push_options
 #pragma GCC optimize ("O0")
 
+void AP_Scripting::run_vm(uint8_t vm) {
+    lua_scripts *lua = NEW_NOTHROW lua_scripts(vm, _script_vm_exec_count, _script_heap_size, _debug_options);
+    if (lua == nullptr || !lua->heap_allocated()) {
+        GCS_SEND_TEXT(MAV_SEVERITY_CRITICAL, "Scripting: %s", "Unable to allocate memory");
+        _init_failed = true;
+    } else {
+        {
+            WITH_SEMAPHORE(_lua_sem);
+            _lua[vm] = lua;
+        }
+
+        // run won't return while scripting is still active
+        lua->run();
+
+        // only reachable if the lua backend has died for any reason
+        GCS_SEND_TEXT(MAV_SEVERITY_CRITICAL, "Scripting: %s", "stopped");
+    }
+    {
+        WITH_SEMAPHORE(_lua_sem);
+        _lua[vm] = nullptr;
+    }
+    delete lua;
+}
+
+/*
+  run a VM until scripting is stopped. A VM that dies on its own, for
+  example when its heap can't be allocated or its scripts fail to load,
+  is restarted by itself while the other VMs keep running
+ */
+void AP_Scripting::supervise_vm(uint8_t vm) {
+    while (true) {
+        run_vm(vm);
+        if (!should_run()) {
+            // stopped, restarted or disabled, handled for all VMs by thread()
+            return;
+        }
+        GCS_SEND_TEXT(MAV_SEVERITY_CRITICAL, "Scripting: VM%u %s", unsigned(vm), "restarting");
+
+        // don't retry a VM that can't start faster than every 5 seconds
+        for (uint16_t i=0; i<500 && should_run(); i++) {
+            hal.scheduler->delay(10);
+        }
+    }
+}
+
+#if AP_SCRIPTING_MAX_VMS > 1
+void AP_Scripting::vm_thread(void) {
+    uint8_t vm;
+    {
+        WITH_SEMAPHORE(_lua_sem);
+        vm = _next_vm++;
+    }
+
+    supervise_vm(vm);
+
+    WITH_SEMAPHORE(_lua_sem);
+    _vm_threads_running--;
+}
+#endif
+
 void AP_Scripting::thread(void) {
     while (true) {
         // reset flags
@@ -307,24 +390,49 @@ void AP_Scripting::thread(void) {
         _restart = false;
         _init_failed = false;
 
-        lua_scripts *lua = NEW_NOTHROW lua_scripts(_script_vm_exec_count, _script_heap_size, _debug_options);
-        if (lua == nullptr || !lua->heap_allocated()) {
-            GCS_SEND_TEXT(MAV_SEVERITY_CRITICAL, "Scripting: %s", "Unable to allocate memory");
-            _init_failed = true;
-        } else {
 #if AP_SCRIPTING_SERIALDEVICE_ENABLED
-            // clear data in serial buffers that the script wasn't ready to
-            // receive
-            _serialdevice.clear();
+        // clear data in serial buffers that the script wasn't ready to
+        // receive
+        _serialdevice.clear();
+#endif
+
+#if AP_SCRIPTING_MAX_VMS > 1
+        // start the additional VMs, VM 0 runs on this thread
+        const uint8_t num_vms = constrain_int16(_num_vms, 1, AP_SCRIPTING_MAX_VMS);
+        {
+            WITH_SEMAPHORE(_lua_sem);
+            _next_vm = 1;
+            _vm_threads_running = num_vms - 1;
+        }
+        for (uint8_t i=1; i<num_vms; i++) {
+            if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&AP_Scripting::vm_thread, void),
+                                              "Scripting", SCRIPTING_STACK_SIZE, _hal_priority, 0)) {
+                GCS_SEND_TEXT(MAV_SEVERITY_ERROR, "Scripting: VM%u %s", unsigned(i), "failed to start");
+                WITH_SEMAPHORE(_lua_sem);
+                _vm_threads_running--;
+            }
+        }
 #endif
-            // run won't return while scripting is still active
-            lua->run();
 
-            // only reachable if the lua backend has died for any reason
-            GCS_SEND_TEXT(MAV_SEVERITY_CRITICAL, "Scripting: %s", "stopped");
+        supervise_vm(0);
+
+#if AP_SCRIPTING_MAX_VMS > 1
+        // scripting has been stopped, restarted or disabled. Make sure
+        // the other VMs stop and wait for them to finish before
+        // releasing the resources they share
+        _stop = true;
+        while (true) {
+            {
+                WITH_SEMAPHORE(_lua_sem);
+                if (_vm_threads_running == 0) {
+                    break;
+                }
+            }
+            hal.scheduler->delay(10);
         }
-        delete lua;
-        lua = nullptr;
+#endif
+
+        lua_scripts::clear_last_error_message();
 
         // clear allocated i2c devices
         for (uint8_t i=0; i<SCRIPTING_MAX_NUM_I2C_DEVICE; i++) {
@@ -474,20 +582,22 @@ void AP_Scripting::restart_all()
 
 #if HAL_GCS_ENABLED
 void AP_Scripting::handle_message(const mavlink_message_t &msg, const mavlink_channel_t chan) {
-    if (mavlink_data.rx_buffer == nullptr) {
-        return;
-    }
-
-    struct mavlink_msg data {msg, chan, AP_HAL::millis()};
+    const struct mavlink_msg data {msg, chan, AP_HAL::millis()};
 
-    WITH_SEMAPHORE(mavlink_data.sem);
-    for (uint16_t i = 0; i < mavlink_data.accept_msg_ids_size; i++) {
-        if (mavlink_data.accept_msg_ids[i] == UINT32_MAX) {
-            return;
+    // each VM that has registered for the message gets a copy
+    for (auto &vm_data : mavlink_data) {
+        if (vm_data.rx_buffer == nullptr) {
+            continue;
         }
-        if (mavlink_data.accept_msg_ids[i] == msg.msgid) {
-            mavlink_data.rx_buffer->push(data);
-            return;
+        WITH_SEMAPHORE(vm_data.sem);
+        for (uint16_t i = 0; i < vm_data.accept_msg_ids_size; i++) {
+            if (vm_data.accept_msg_ids[i] == UINT32_MAX) {
+                break;
+            }
+            if (vm_data.accept_msg_ids[i] == msg.msgid) {
+                vm_data.rx_buffer->push(data);
+                break;
+            }
         }
     }
 }
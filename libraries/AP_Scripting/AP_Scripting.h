@@ -45,6 +45,9 @@ class SocketAPM;
 #include "AP_Scripting_SerialDevice.h"
 #endif
 
+class lua_scripts;
+class ExpandingString;
+
 class AP_Scripting
 {
 public:
@@ -85,6 +88,9 @@ public:
     
     void restart_all(void);
 
+    // per-script runtime statistics for @SYS/scripts.txt
+    void scripts_info(ExpandingString &str);
+
    // User parameters for inputs into scripts 
    AP_Float _user[6];
 
@@ -94,6 +100,10 @@ public:
     };
     uint16_t get_disabled_dir() { return uint16_t(_dir_disable.get());}
 
+    // protects the i2c, PWMSource, CAN and socket storage below, which is
+    // shared by all VMs, and the reads of mission_data
+    HAL_Semaphore resource_sem;
+
     // the number of and storage for i2c devices
     uint8_t num_i2c_devices;
     AP_HAL::OwnPtr<AP_HAL::I2CDevice> *_i2c_dev[SCRIPTING_MAX_NUM_I2C_DEVICE];
@@ -120,8 +130,6 @@ public:
     // PWMSource storage
     uint8_t num_pwm_source;
     AP_HAL::PWMSource *_pwm_source[SCRIPTING_MAX_NUM_PWM_SOURCE];
-    int get_current_env_ref() { return current_env_ref; }
-    void set_current_env_ref(int ref) { current_env_ref = ref; }
 
 #if AP_NETWORKING_ENABLED
     // SocketAPM storage
@@ -134,12 +142,14 @@ public:
         uint32_t timestamp_ms;
     };
 
+    // MAVLink receive state, one per VM so that scripts on one VM
+    // cannot consume or clear the registrations of another
     struct mavlink {
         ObjectBuffer<struct mavlink_msg> *rx_buffer;
         uint32_t *accept_msg_ids;
         uint16_t accept_msg_ids_size;
         HAL_Semaphore sem;
-    } mavlink_data;
+    } mavlink_data[AP_SCRIPTING_MAX_VMS];
 
     struct command_block_list {
         uint16_t id;
@@ -166,6 +176,16 @@ private:
 
     void thread(void); // main script execution thread
 
+#if AP_SCRIPTING_MAX_VMS > 1
+    void vm_thread(void); // execution thread for additional VMs
+#endif
+
+    // create a VM and run its scripts, returns when the VM stops
+    void run_vm(uint8_t vm);
+
+    // run a VM, restarting it if it dies, until scripting is stopped
+    void supervise_vm(uint8_t vm);
+
     // Check if DEBUG_OPTS bit has been set to save current checksum values to params
     void save_checksum();
 
@@ -194,6 +214,9 @@ private:
     AP_Int32 _required_running_checksum;
 
     AP_Enum<ThreadPriority> _thd_priority;
+#if AP_SCRIPTING_MAX_VMS > 1
+    AP_Int8 _num_vms;
+#endif
 
     bool option_is_set(DebugOption option) const {
         return (uint8_t(_debug_options.get()) & uint8_t(option)) != 0;
@@ -208,8 +231,21 @@ private:
     bool _restart; // true if scripts should be restarted
     bool _stop; // true if scripts should be stopped
 
+    // HAL priority of the scripting threads
+    AP_HAL::Scheduler::priority_base _hal_priority;
+
+    // currently running lua states, protected by _lua_sem for access from other threads
+    lua_scripts *_lua[AP_SCRIPTING_MAX_VMS];
+    HAL_Semaphore _lua_sem;
+
+#if AP_SCRIPTING_MAX_VMS > 1
+    // index of the next VM to be started by vm_thread and the number of
+    // additional VM threads still running, protected by _lua_sem
+    uint8_t _next_vm;
+    uint8_t _vm_threads_running;
+#endif
+
     static AP_Scripting *_singleton;
-    int current_env_ref;
 };
 
 namespace AP {
@@ -15,6 +15,20 @@
     #endif
 #endif
 
+// allow loading of precompiled .luac files, must be built with LUA_SUPPORT_LOAD_BINARY
+#ifndef AP_SCRIPTING_BYTECODE_ENABLED
+#define AP_SCRIPTING_BYTECODE_ENABLED 0
+#endif
+
+// maximum number of scripting VMs, each runs on its own thread with its own heap
+#ifndef AP_SCRIPTING_MAX_VMS
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX || CONFIG_HAL_BOARD == HAL_BOARD_SITL
+#define AP_SCRIPTING_MAX_VMS 4
+#else
+#define AP_SCRIPTING_MAX_VMS 1
+#endif
+#endif
+
 #ifndef AP_SCRIPTING_SERIALDEVICE_ENABLED
 #define AP_SCRIPTING_SERIALDEVICE_ENABLED AP_SERIALMANAGER_REGISTER_ENABLED && (BOARD_FLASH_SIZE>1024)
 #endif
@@ -389,8 +389,9 @@ function Cylinder_Status_ud:ignition_timing_deg(value) end
 efi = {}
 
 -- desc
+---@param result? EFI_State_ud -- written to and returned in place of a new EFI_State_ud
 ---@return EFI_State_ud
-function efi:get_state() end
+function efi:get_state(result) end
 
 -- get last update time in milliseconds
 ---@return uint32_t_ud
@@ -834,8 +835,9 @@ local Vector2f_ud = {}
 function Vector2f() end
 
 -- Copy this Vector2f returning a new userdata object
+---@param result? Vector2f_ud -- written to and returned in place of a new Vector2f_ud
 ---@return Vector2f_ud -- a copy of this Vector2f
-function Vector2f_ud:copy() end
+function Vector2f_ud:copy(result) end
 
 -- get y component
 ---@return number
@@ -894,8 +896,9 @@ local Vector3f_ud = {}
 function Vector3f() end
 
 -- Copy this Vector3f returning a new userdata object
+---@param result? Vector3f_ud -- written to and returned in place of a new Vector3f_ud
 ---@return Vector3f_ud -- a copy of this Vector3f
-function Vector3f_ud:copy() end
+function Vector3f_ud:copy(result) end
 
 -- get z component
 ---@return number
@@ -923,13 +926,15 @@ function Vector3f_ud:x(value) end
 
 -- Return a new Vector3 based on this one with scaled length and the same changing direction
 ---@param scale_factor number
+---@param result? Vector3f_ud -- written to and returned in place of a new Vector3f_ud
 ---@return Vector3f_ud -- scaled copy of this vector
-function Vector3f_ud:scale(scale_factor) end
+function Vector3f_ud:scale(scale_factor, result) end
 
 -- Cross product of two Vector3fs
 ---@param vector Vector3f_ud
+---@param result? Vector3f_ud -- written to and returned in place of a new Vector3f_ud
 ---@return Vector3f_ud -- result
-function Vector3f_ud:cross(vector) end
+function Vector3f_ud:cross(vector, result) end
 
 -- Dot product of two Vector3fs
 ---@param vector Vector3f_ud
@@ -965,8 +970,9 @@ function Vector3f_ud:angle(v2) end
 function Vector3f_ud:rotate_xy(param1) end
 
 -- return the x and y components of this vector as a Vector2f
+---@param result? Vector2f_ud -- written to and returned in place of a new Vector2f_ud
 ---@return Vector2f_ud
-function Vector3f_ud:xy() end
+function Vector3f_ud:xy(result) end
 
 -- desc
 ---@class (exact) Quaternion_ud
@@ -1013,8 +1019,9 @@ function Quaternion_ud:q1(value) end
 function Quaternion_ud:earth_to_body(vec) end
 
 -- Returns inverse of quaternion
+---@param result? Quaternion_ud -- written to and returned in place of a new Quaternion_ud
 ---@return Quaternion_ud
-function Quaternion_ud:inverse() end
+function Quaternion_ud:inverse(result) end
 
 -- Integrates angular velocity over small time delta
 ---@param angular_velocity Vector3f_ud
@@ -1066,8 +1073,9 @@ local Location_ud = {}
 function Location() end
 
 -- Copy this location returning a new userdata object
+---@param result? Location_ud -- written to and returned in place of a new Location_ud
 ---@return Location_ud -- a copy of this location
-function Location_ud:copy() end
+function Location_ud:copy(result) end
 
 -- get loiter xtrack
 ---@return boolean -- Get if the location is used for a loiter location this flags if the aircraft should track from the center point, or from the exit location of the loiter.
@@ -1144,13 +1152,15 @@ function Location_ud:change_alt_frame(desired_frame) end
 
 -- Given a Location this calculates the north and east distance between the two locations in meters.
 ---@param loc Location_ud -- location to compare with
+---@param result? Vector2f_ud -- written to and returned in place of a new Vector2f_ud
 ---@return Vector2f_ud -- North east distance vector in meters
-function Location_ud:get_distance_NE(loc) end
+function Location_ud:get_distance_NE(loc, result) end
 
 -- Given a Location this calculates the north, east and down distance between the two locations in meters.
 ---@param loc Location_ud -- location to compare with
+---@param result? Vector3f_ud -- written to and returned in place of a new Vector3f_ud
 ---@return Vector3f_ud -- North east down distance vector in meters
-function Location_ud:get_distance_NED(loc) end
+function Location_ud:get_distance_NED(loc, result) end
 
 -- Given a Location this calculates the relative bearing to the location in radians
 ---@param loc Location_ud -- location to compare with
@@ -1159,8 +1169,9 @@ function Location_ud:get_bearing(loc) end
 
 -- Returns the offset from the EKF origin to this location.
 -- Returns nil if the EKF origin wasn’t available at the time this was called.
+---@param result? Vector3f_ud -- written to and returned in place of a new Vector3f_ud
 ---@return Vector3f_ud|nil -- Vector between origin and location north east up in meters
-function Location_ud:get_vector_from_origin_NEU() end
+function Location_ud:get_vector_from_origin_NEU(result) end
 
 -- Translates this Location by the specified  distance given a bearing.
 ---@param bearing_deg number -- bearing in degrees
@@ -1197,8 +1208,9 @@ function AP_EFI_Backend_ud:handle_scripting(state) end
 local ScriptingCANBuffer_ud = {}
 
 -- desc
+---@param result? CANFrame_ud -- written to and returned in place of a new CANFrame_ud
 ---@return CANFrame_ud|nil
-function ScriptingCANBuffer_ud:read_frame() end
+function ScriptingCANBuffer_ud:read_frame(result) end
 
 -- Add a filter to the CAN buffer, mask is bitwise ANDed with the frame id and compared to value if not match frame is not buffered
 -- By default no filters are added and all frames are buffered, write is not affected by filters
@@ -1436,8 +1448,9 @@ function AP_Camera__camera_state_t_ud:take_pic_incr() end
 
 -- desc
 ---@param instance integer
+---@param result? AP_Camera__camera_state_t_ud -- written to and returned in place of a new AP_Camera__camera_state_t_ud
 ---@return AP_Camera__camera_state_t_ud|nil
-function camera:get_state(instance) end
+function camera:get_state(instance, result) end
 
 -- Change a camera setting to a given value
 ---@param instance integer
@@ -1711,8 +1724,9 @@ function mount:set_attitude_euler(instance, roll_deg, pitch_deg, yaw_deg) end
 
 -- desc
 ---@param instance integer
+---@param result? Location_ud -- written to and returned in place of a new Location_ud
 ---@return Location_ud|nil
-function mount:get_location_target(instance) end
+function mount:get_location_target(instance, result) end
 
 -- desc
 ---@param instance integer
@@ -1927,13 +1941,15 @@ function ins:calibrating() end
 
 -- Get the value of a specific gyroscope
 ---@param instance integer -- the 0-based index of the gyroscope instance to return.
+---@param result? Vector3f_ud -- written to and returned in place of a new Vector3f_ud
 ---@return Vector3f_ud
-function ins:get_gyro(instance) end
+function ins:get_gyro(instance, result) end
 
 -- Get the value of a specific accelerometer
 ---@param instance integer -- the 0-based index of the accelerometer instance to return.
+---@param result? Vector3f_ud -- written to and returned in place of a new Vector3f_ud
 ---@return Vector3f_ud
-function ins:get_accel(instance) end
+function ins:get_accel(instance, result) end
 
 -- desc
 Motors_dynamic = {}
@@ -2197,8 +2213,9 @@ function mission:set_item(index, item) end
 
 -- get any WP items in any order in a mavlink-ish kinda way.
 ---@param index integer
+---@param result? mavlink_mission_item_int_t_ud -- written to and returned in place of a new mavlink_mission_item_int_t_ud
 ---@return mavlink_mission_item_int_t_ud|nil
-function mission:get_item(index) end
+function mission:get_item(index, result) end
 
 -- num_commands - returns total number of commands in the mission
 --                 this number includes offset 0, the home location
@@ -2733,8 +2750,9 @@ function vehicle:set_target_pos_NED(target_pos, use_yaw, yaw_deg, use_yaw_rate,
 function vehicle:update_target_location(current_target, new_target) end
 
 -- Get the current target location if available in current mode
+---@param result? Location_ud -- written to and returned in place of a new Location_ud
 ---@return Location_ud|nil -- target location
-function vehicle:get_target_location() end
+function vehicle:get_target_location(result) end
 
 -- Set the target veicle location in a guided mode
 ---@param target_loc Location_ud -- target location
@@ -2843,12 +2861,14 @@ function vehicle:set_crosstrack_start(new_start_location) end
 onvif = {}
 
 -- desc
+---@param result? Vector2f_ud -- written to and returned in place of a new Vector2f_ud
 ---@return Vector2f_ud
-function onvif:get_pan_tilt_limit_max() end
+function onvif:get_pan_tilt_limit_max(result) end
 
 -- desc
+---@param result? Vector2f_ud -- written to and returned in place of a new Vector2f_ud
 ---@return Vector2f_ud
-function onvif:get_pan_tilt_limit_min() end
+function onvif:get_pan_tilt_limit_min(result) end
 
 -- desc
 ---@param pan number
@@ -3111,8 +3131,9 @@ function AP_RangeFinder_Backend_ud:distance() end
 function AP_RangeFinder_Backend_ud:signal_quality() end
 
 -- State of most recent range finder measurment
+---@param result? RangeFinder_State_ud -- written to and returned in place of a new RangeFinder_State_ud
 ---@return RangeFinder_State_ud
-function AP_RangeFinder_Backend_ud:get_state() end
+function AP_RangeFinder_Backend_ud:get_state(result) end
 
 
 -- desc
@@ -3125,8 +3146,9 @@ function rangefinder:get_backend(rangefinder_instance) end
 
 -- desc
 ---@param orientation integer
+---@param result? Vector3f_ud -- written to and returned in place of a new Vector3f_ud
 ---@return Vector3f_ud
-function rangefinder:get_pos_offset_orient(orientation) end
+function rangefinder:get_pos_offset_orient(orientation, result) end
 
 -- desc
 ---@param orientation integer
@@ -3279,8 +3301,9 @@ gps.NO_GPS = enum_integer
 
 -- get unix time
 ---@param instance integer -- instance number
+---@param result? uint64_t_ud -- written to and returned in place of a new uint64_t_ud
 ---@return uint64_t_ud -- unix time microseconds
-function gps:time_epoch_usec(instance) end
+function gps:time_epoch_usec(instance, result) end
 
 -- get yaw from GPS in degrees
 ---@param instance integer -- instance number
@@ -3295,8 +3318,9 @@ function gps:first_unconfigured_gps() end
 
 -- Returns a Vector3f that contains the offsets of the GPS in meters in the body frame.
 ---@param instance integer -- instance number
+---@param result? Vector3f_ud -- written to and returned in place of a new Vector3f_ud
 ---@return Vector3f_ud -- anteena offset vector forward, right, down in meters
-function gps:get_antenna_offset(instance) end
+function gps:get_antenna_offset(instance, result) end
 
 -- Returns true if the GPS instance can report the vertical velocity.
 ---@param instance integer -- instance number
@@ -3351,8 +3375,9 @@ function gps:ground_speed(instance) end
 -- Returns a Vector3f that contains the velocity as observed by the GPS.
 -- You must check the status to know if the velocity is still current.
 ---@param instance integer -- instance number
+---@param result? Vector3f_ud -- written to and returned in place of a new Vector3f_ud
 ---@return Vector3f_ud -- 3D velocity in m/s, in NED format
-function gps:velocity(instance) end
+function gps:velocity(instance, result) end
 
 -- desc
 ---@param instance integer -- instance number
@@ -3371,8 +3396,9 @@ function gps:speed_accuracy(instance) end
 
 -- eturns a Location userdata for the last GPS position. You must check the status to know if the location is still current, if it is NO_GPS, or NO_FIX then it will be returning old data.
 ---@param instance integer -- instance number
+---@param result? Location_ud -- written to and returned in place of a new Location_ud
 ---@return Location_ud --gps location
-function gps:location(instance) end
+function gps:location(instance, result) end
 
 -- Returns the GPS fix status. Compare this to one of the GPS fix types.
 -- Posible status are provided as values on the gps object. eg: gps.GPS_OK_FIX_3D
@@ -3584,8 +3610,9 @@ ahrs = {}
 function ahrs:handle_external_position_estimate(location, accuracy, timestamp_ms) end
 
 -- desc
+---@param result? Quaternion_ud -- written to and returned in place of a new Quaternion_ud
 ---@return Quaternion_ud|nil
-function ahrs:get_quaternion() end
+function ahrs:get_quaternion(result) end
 
 -- desc
 ---@return integer
@@ -3601,8 +3628,9 @@ function ahrs:initialised() end
 function ahrs:set_origin(loc) end
 
 -- desc
+---@param result? Location_ud -- written to and returned in place of a new Location_ud
 ---@return Location_ud|nil
-function ahrs:get_origin() end
+function ahrs:get_origin(result) end
 
 -- desc
 ---@param loc Location_ud
@@ -3623,12 +3651,13 @@ function ahrs:get_vel_innovations_and_variances_for_source(source) end
 function ahrs:set_posvelyaw_source_set(source_set_idx) end
 
 -- desc
+---@param result? Vector3f_ud -- written to and returned in place of a new Vector3f_ud
 ---@return number|nil
 ---@return number|nil
 ---@return number|nil
 ---@return Vector3f_ud|nil
 ---@return number|nil
-function ahrs:get_variances() end
+function ahrs:get_variances(result) end
 
 -- desc
 ---@return number
@@ -3636,17 +3665,20 @@ function ahrs:get_EAS2TAS() end
 
 -- desc
 ---@param vector Vector3f_ud
+---@param result? Vector3f_ud -- written to and returned in place of a new Vector3f_ud
 ---@return Vector3f_ud
-function ahrs:body_to_earth(vector) end
+function ahrs:body_to_earth(vector, result) end
 
 -- desc
 ---@param vector Vector3f_ud
+---@param result? Vector3f_ud -- written to and returned in place of a new Vector3f_ud
 ---@return Vector3f_ud
-function ahrs:earth_to_body(vector) end
+function ahrs:earth_to_body(vector, result) end
 
 -- desc
+---@param result? Vector3f_ud -- written to and returned in place of a new Vector3f_ud
 ---@return Vector3f_ud
-function ahrs:get_vibration() end
+function ahrs:get_vibration(result) end
 
 -- Return the estimated airspeed of the vehicle if available
 ---@return number|nil -- airspeed in meters / second if available
@@ -3665,24 +3697,29 @@ function ahrs:home_is_set() end
 function ahrs:get_relative_position_D_home() end
 
 -- desc
+---@param result? Vector3f_ud -- written to and returned in place of a new Vector3f_ud
 ---@return Vector3f_ud|nil
-function ahrs:get_relative_position_NED_origin() end
+function ahrs:get_relative_position_NED_origin(result) end
 
 -- desc
+---@param result? Vector3f_ud -- written to and returned in place of a new Vector3f_ud
 ---@return Vector3f_ud|nil
-function ahrs:get_relative_position_NED_home() end
+function ahrs:get_relative_position_NED_home(result) end
 
 -- Returns nil, or a Vector3f containing the current NED vehicle velocity in meters/second in north, east, and down components.
+---@param result? Vector3f_ud -- written to and returned in place of a new Vector3f_ud
 ---@return Vector3f_ud|nil -- North, east, down velcoity in meters / second if available
-function ahrs:get_velocity_NED() end
+function ahrs:get_velocity_NED(result) end
 
 -- Get current groundspeed vector in meter / second
+---@param result? Vector2f_ud -- written to and returned in place of a new Vector2f_ud
 ---@return Vector2f_ud -- ground speed vector, North East, meters / second
-function ahrs:groundspeed_vector() end
+function ahrs:groundspeed_vector(result) end
 
 -- Returns a Vector3f containing the current wind estimate for the vehicle.
+---@param result? Vector3f_ud -- written to and returned in place of a new Vector3f_ud
 ---@return Vector3f_ud -- wind estiamte North, East, Down meters / second
-function ahrs:wind_estimate() end
+function ahrs:wind_estimate(result) end
 
 -- Determine how aligned heading_deg is with the wind. Return result
 -- is 1.0 when perfectly aligned heading into wind, -1 when perfectly
@@ -3701,25 +3738,30 @@ function ahrs:head_wind() end
 function ahrs:get_hagl() end
 
 -- desc
+---@param result? Vector3f_ud -- written to and returned in place of a new Vector3f_ud
 ---@return Vector3f_ud
-function ahrs:get_accel() end
+function ahrs:get_accel(result) end
 
 -- Returns a Vector3f containing the current smoothed and filtered gyro rates (in radians/second)
+---@param result? Vector3f_ud -- written to and returned in place of a new Vector3f_ud
 ---@return Vector3f_ud -- roll, pitch, yaw gyro rates in radians / second
-function ahrs:get_gyro() end
+function ahrs:get_gyro(result) end
 
 -- Returns a Location that contains the vehicles current home waypoint.
+---@param result? Location_ud -- written to and returned in place of a new Location_ud
 ---@return Location_ud -- home location
-function ahrs:get_home() end
+function ahrs:get_home(result) end
 
 -- Returns nil or Location userdata that contains the vehicles current position.
 -- Note: This will only return a Location if the system considers the current estimate to be reasonable.
+---@param result? Location_ud -- written to and returned in place of a new Location_ud
 ---@return Location_ud|nil -- current location if available
-function ahrs:get_location() end
+function ahrs:get_location(result) end
 
 -- same as `get_location` will be removed
+---@param result? Location_ud -- written to and returned in place of a new Location_ud
 ---@return Location_ud|nil
-function ahrs:get_position() end
+function ahrs:get_position(result) end
 
 -- Returns the current vehicle euler yaw angle in radians.
 ---@return number -- yaw angle in radians.
@@ -3781,12 +3823,14 @@ function AR_PosControl:get_srate() end
 precland = {}
 
 -- get Location of target or nil if target not acquired
+---@param result? Location_ud -- written to and returned in place of a new Location_ud
 ---@return Location_ud|nil
-function precland:get_target_location() end
+function precland:get_target_location(result) end
 
 -- get NE velocity of target or nil if not available
+---@param result? Vector2f_ud -- written to and returned in place of a new Vector2f_ud
 ---@return Vector2f_ud|nil
-function precland:get_target_velocity() end
+function precland:get_target_velocity(result) end
 
 -- get the time of the last valid target
 ---@return uint32_t_ud
@@ -3831,6 +3875,10 @@ scripting = {}
 -- desc
 function scripting:restart_all() end
 
+-- Get the number of bytes allocated by this script's virtual machine so far, wraps
+---@return uint32_t_ud
+function scripting:alloc_bytes() end
+
 -- desc
 ---@param directoryname string
 ---@return table|nil -- table of filenames
@@ -3951,8 +3999,9 @@ fs = {}
 
 -- desc
 ---@param param1 string
+---@param result? stat_t_ud -- written to and returned in place of a new stat_t_ud
 ---@return stat_t_ud|nil
-function fs:stat(param1) end
+function fs:stat(param1, result) end
 
 -- Format the SD card. This is a async operation, use get_format_status to get the status of the format
 ---@return boolean
@@ -0,0 +1,87 @@
+--[[
+ benchmark the allocations saved by passing a result userdata to bindings
+
+ Bindings that return a single userdata value take an optional extra
+ argument of that type. The result is written to it and returned rather
+ than allocating a new userdata, so a script calling them every update
+ creates no garbage for the collector.
+
+ Each update runs one of the tests below CALLS_PER_RUN times, both
+ allocating a new result and reusing one. The bytes allocated and time
+ taken per call for each are reported to the GCS.
+--]]
+---@diagnostic disable: need-check-nil
+
+local CALLS_PER_RUN = 200
+local RUNS_PER_REPORT = 10
+
+local vec = Vector3f()
+local vec2 = Vector2f()
+local loc = Location()
+
+local tests = {
+   { name = "get_gyro",
+     new = function() return ahrs:get_gyro() end,
+     reused = function() return ahrs:get_gyro(vec) end },
+   { name = "get_velocity_NED",
+     new = function() return ahrs:get_velocity_NED() end,
+     reused = function() return ahrs:get_velocity_NED(vec) end },
+   { name = "get_location",
+     new = function() return ahrs:get_location() end,
+     reused = function() return ahrs:get_location(loc) end },
+   { name = "Vector3f copy",
+     new = function() return vec:copy() end,
+     reused = function() return vec:copy(vec) end },
+   { name = "Vector3f xy",
+     new = function() return vec:xy() end,
+     reused = function() return vec:xy(vec2) end },
+}
+
+local function empty() end
+
+-- return the time in us and bytes allocated for CALLS_PER_RUN calls of fn
+local function measure(fn)
+   local start_alloc = scripting:alloc_bytes()
+   local start_us = micros()
+   for _ = 1, CALLS_PER_RUN do
+      fn()
+   end
+   local us = (micros() - start_us):tofloat()
+   local bytes = (scripting:alloc_bytes() - start_alloc):tofloat()
+   return us, bytes
+end
+
+local test_idx = 1
+local run_count = 0
+local totals = { new_us = 0, new_bytes = 0, reused_us = 0, reused_bytes = 0 }
+
+function update()
+   local test = tests[test_idx]
+
+   -- remove the cost of the loop and the measurement itself
+   local base_us, base_bytes = measure(empty)
+
+   local us, bytes = measure(test.new)
+   totals.new_us = totals.new_us + us - base_us
+   totals.new_bytes = totals.new_bytes + bytes - base_bytes
+
+   us, bytes = measure(test.reused)
+   totals.reused_us = totals.reused_us + us - base_us
+   totals.reused_bytes = totals.reused_bytes + bytes - base_bytes
+
+   run_count = run_count + 1
+   if run_count >= RUNS_PER_REPORT then
+      local calls = run_count * CALLS_PER_RUN
+      gcs:send_text(6, string.format("%s: new %.1f B %.2f us, reused %.1f B %.2f us per call",
+                                     test.name,
+                                     totals.new_bytes / calls, totals.new_us / calls,
+                                     totals.reused_bytes / calls, totals.reused_us / calls))
+      run_count = 0
+      totals = { new_us = 0, new_bytes = 0, reused_us = 0, reused_bytes = 0 }
+      test_idx = (test_idx % #tests) + 1
+   end
+
+   return update, 100
+end
+
+return update()
@@ -1831,7 +1831,42 @@ void emit_singleton_fields() {
 }
 
 // emit refences functions for a call, return the number of arduments added
-int emit_references(const struct argument *arg, const char * tab) {
+// methods returning a single userdata value accept an optional extra
+// argument of that type that the value is written to, rather than
+// allocating a new userdata for it
+const struct type * userdata_result_type(const struct method *method) {
+  const struct type *result = NULL;
+  int count = 0;
+  if (method->return_type.type == TYPE_USERDATA) {
+    result = &method->return_type;
+    count++;
+  }
+  const struct argument *arg = method->arguments;
+  while (arg != NULL) {
+    if ((arg->type.flags & (TYPE_FLAGS_NULLABLE | TYPE_FLAGS_REFERNCE)) && (arg->type.type == TYPE_USERDATA)) {
+      result = &arg->type;
+      count++;
+    }
+    arg = arg->next;
+  }
+  return (count == 1) ? result : NULL;
+}
+
+// push a userdata value, writing it to the result argument if one was passed
+void emit_userdata_push(const struct type *t, const char *value, int reuse_result, int result_arg, const char * tab) {
+  if (!reuse_result) {
+    fprintf(source, "%s*new_%s(L) = %s;\n", tab, t->data.ud.sanatized_name, value);
+    return;
+  }
+  fprintf(source, "%sif (result != nullptr) {\n", tab);
+  fprintf(source, "%s    *result = %s;\n", tab, value);
+  fprintf(source, "%s    lua_pushvalue(L, %d);\n", tab, result_arg);
+  fprintf(source, "%s} else {\n", tab);
+  fprintf(source, "%s    *new_%s(L) = %s;\n", tab, t->data.ud.sanatized_name, value);
+  fprintf(source, "%s}\n", tab);
+}
+
+int emit_references(const struct argument *arg, const struct type *result_type, int result_arg, const char * tab) {
   int arg_index = NULLABLE_ARG_COUNT_BASE + 2;
   int return_count = 0;
   // count arguments to return so we know if we need to check the stack
@@ -1869,9 +1904,12 @@ int emit_references(const struct argument *arg, const char * tab) {
         case TYPE_STRING:
           fprintf(source, "%slua_pushstring(L, data_%d);\n", tab, arg_index);
           break;
-        case TYPE_USERDATA:
-          fprintf(source, "%s*new_%s(L) = data_%d;\n", tab, arg->type.data.ud.sanatized_name, arg_index);
+        case TYPE_USERDATA: {
+          char value[20];
+          snprintf(value, sizeof(value), "data_%d", arg_index);
+          emit_userdata_push(&arg->type, value, &arg->type == result_type, result_arg, tab);
           break;
+        }
         case TYPE_NONE:
           error(ERROR_INTERNAL, "Attempted to emit a nullable or reference  argument of type none");
           break;
@@ -1917,7 +1955,14 @@ void emit_userdata_method(const struct userdata *data, const struct method *meth
     }
     arg = arg->next;
   }
-  fprintf(source, "    binding_argcheck(L, %d);\n", arg_count);
+  const struct type *result_type = userdata_result_type(method);
+  const int result_arg = arg_count + 1;
+  if (result_type != NULL) {
+    fprintf(source, "    %s * result = binding_argcheck_result(L, %d) ? check_%s(L, %d) : nullptr;\n",
+            result_type->data.ud.name, arg_count, result_type->data.ud.sanatized_name, result_arg);
+  } else {
+    fprintf(source, "    binding_argcheck(L, %d);\n", arg_count);
+  }
 
   switch (data->ud_type) {
     case UD_USERDATA:
@@ -2107,7 +2152,7 @@ void emit_userdata_method(const struct userdata *data, const struct method *meth
   if (method->flags & TYPE_FLAGS_REFERNCE) {
     arg = method->arguments;
     // number of arguments to return
-    return_count += emit_references(arg,"    ");
+    return_count += emit_references(arg, result_type, result_arg, "    ");
   }
 
   switch (method->return_type.type) {
@@ -2116,7 +2161,7 @@ void emit_userdata_method(const struct userdata *data, const struct method *meth
         fprintf(source, "    if (data) {\n");
         // we need to emit out nullable arguments, iterate the args again, creating and copying objects, while keeping a new count
         arg = method->arguments;
-        return_count = emit_references(arg,"        ");
+        return_count = emit_references(arg, result_type, result_arg, "        ");
         fprintf(source, "        return %d;\n", return_count);
         fprintf(source, "    }\n");
         fprintf(source, "    return 0;\n");
@@ -2142,7 +2187,7 @@ void emit_userdata_method(const struct userdata *data, const struct method *meth
       fprintf(source, "    lua_pushstring(L, data);\n");
       break;
     case TYPE_USERDATA:
-      fprintf(source, "    *new_%s(L) = data;\n", method->return_type.data.ud.sanatized_name);
+      emit_userdata_push(&method->return_type, "data", &method->return_type == result_type, result_arg, "    ");
       break;
     case TYPE_AP_OBJECT:
       fprintf(source, "    if (data == NULL) {\n");
@@ -2626,6 +2671,15 @@ void emit_argcheck_helper(void) {
   fprintf(source, "    return 0;\n");
   fprintf(source, "}\n\n");
 
+  // methods returning userdata accept one more argument to write the result to
+  fprintf(source, "bool binding_argcheck_result(lua_State *L, int expected_arg_count) {\n");
+  fprintf(source, "    if (lua_gettop(L) == expected_arg_count + 1) {\n");
+  fprintf(source, "        return true;\n");
+  fprintf(source, "    }\n");
+  fprintf(source, "    binding_argcheck(L, expected_arg_count);\n");
+  fprintf(source, "    return false;\n");
+  fprintf(source, "}\n\n");
+
   fprintf(source, "int field_argerror(lua_State *L) {\n");
   fprintf(source, "    return binding_argcheck(L, -1); // force too many args error\n");
   fprintf(source, "}\n\n");
@@ -2810,6 +2864,12 @@ void emit_docs_method(const char *name, const char *method_name, struct method *
     arg = arg->next;
   }
 
+  // optional argument the userdata result is written to
+  const struct type *result_type = userdata_result_type(method);
+  if (result_type != NULL) {
+    emit_docs_type(*result_type, "---@param result?", "\n");
+  }
+
   // return type
   if ((method->flags & TYPE_FLAGS_NULLABLE) == 0) {
     emit_docs_return_type(method->return_type, FALSE);
@@ -2832,6 +2892,9 @@ void emit_docs_method(const char *name, const char *method_name, struct method *
       fprintf(docs, ", ");
     }
   }
+  if (result_type != NULL) {
+    fprintf(docs, "%sresult", (count > 1) ? ", " : "");
+  }
   fprintf(docs, ") end\n\n");
 }
 
@@ -3197,6 +3260,7 @@ int main(int argc, char **argv) {
   fprintf(header, "void load_generated_bindings(lua_State *L);\n");
   fprintf(header, "void load_generated_sandbox(lua_State *L);\n");
   fprintf(header, "int binding_argcheck(lua_State *L, int expected_arg_count);\n");
+  fprintf(header, "bool binding_argcheck_result(lua_State *L, int expected_arg_count);\n");
   fprintf(header, "int field_argerror(lua_State *L);\n");
   fprintf(header, "bool userdata_zero_arg_check(lua_State *L);\n");
   fprintf(header, "lua_Integer get_integer(lua_State *L, int arg_num, lua_Integer min_val, lua_Integer max_val);\n");
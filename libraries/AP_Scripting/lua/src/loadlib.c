@@ -502,7 +502,12 @@ static int searcher_Lua (lua_State *L) {
   const char *name = luaL_checkstring(L, 1);
   filename = findfile(L, name, "path", LUA_LSUBSEP);
   if (filename == NULL) return 1;  /* module not found in this path */
+#if defined(ARDUPILOT_BUILD)
+  // modules may only be loaded from source
+  return checkload(L, (luaL_loadfilex(L, filename, "t") == LUA_OK), filename);
+#else
   return checkload(L, (luaL_loadfile(L, filename) == LUA_OK), filename);
+#endif
 }
 
 
@@ -622,7 +627,7 @@ static void findloader (lua_State *L, const char *name) {
 static int ll_require (lua_State *L) {
   const char *name = luaL_checkstring(L, 1);
   lua_settop(L, 1);
-  lua_rawgeti(L, LUA_REGISTRYINDEX, lua_get_current_env_ref()); /* get the environment of the current script */
+  lua_rawgeti(L, LUA_REGISTRYINDEX, lua_get_current_env_ref(L)); /* get the environment of the current script */
   lua_getfield(L, 2, LUA_LOADED_TABLE); /* get _LOADED */
   lua_getfield(L, 3, name);  /* LOADED[name] */
   if (lua_toboolean(L, -1))  /* is it there? */
@@ -12,6 +12,7 @@
 #include <AP_Filesystem/AP_Filesystem.h>
 
 #include "lua_bindings.h"
+#include "lua_scripts.h"
 
 #include "lua_boxed_numerics.h"
 #include <AP_Scripting/lua_generated_bindings.h>
@@ -60,26 +61,28 @@ int lua_mavlink_init(lua_State *L) {
     // get number of msgs to accept
     const uint32_t num_msgs = get_uint32(L, 2+arg_offset, 0, 25);
 
-    struct AP_Scripting::mavlink &data = AP::scripting()->mavlink_data;
+    struct AP_Scripting::mavlink &data = AP::scripting()->mavlink_data[lua_scripts::get_vm(L)];
     bool failed = false;
     {
         WITH_SEMAPHORE(data.sem);
-        if (data.rx_buffer == nullptr) {
-            data.rx_buffer = NEW_NOTHROW ObjectBuffer<struct AP_Scripting::mavlink_msg>(queue_size);
-        }
-        if (data.accept_msg_ids == nullptr) {
-            data.accept_msg_ids = NEW_NOTHROW uint32_t[num_msgs];
-        }
-        if ((data.rx_buffer == nullptr) || (data.accept_msg_ids == nullptr)) {
+        // the first script on the VM to initialise sizes the buffers,
+        // later scripts share them and keep existing registrations
+        if (data.rx_buffer == nullptr || data.accept_msg_ids == nullptr) {
             delete data.rx_buffer;
             delete[] data.accept_msg_ids;
-            data.rx_buffer = nullptr;
-            data.accept_msg_ids = nullptr;
-            data.accept_msg_ids_size = 0;
-            failed = true;
-        } else {
-            data.accept_msg_ids_size = num_msgs;
-            memset(data.accept_msg_ids, UINT32_MAX, sizeof(int) * num_msgs);
+            data.rx_buffer = NEW_NOTHROW ObjectBuffer<struct AP_Scripting::mavlink_msg>(queue_size);
+            data.accept_msg_ids = NEW_NOTHROW uint32_t[num_msgs];
+            if ((data.rx_buffer == nullptr) || (data.accept_msg_ids == nullptr)) {
+                delete data.rx_buffer;
+                delete[] data.accept_msg_ids;
+                data.rx_buffer = nullptr;
+                data.accept_msg_ids = nullptr;
+                data.accept_msg_ids_size = 0;
+                failed = true;
+            } else {
+                data.accept_msg_ids_size = num_msgs;
+                memset(data.accept_msg_ids, UINT32_MAX, sizeof(uint32_t) * num_msgs);
+            }
         }
     } // release semaphore here as luaL_error will NOT do that!
 
@@ -98,13 +101,23 @@ int lua_mavlink_receive_chan(lua_State *L) {
     binding_argcheck(L, arg_offset);
 
     struct AP_Scripting::mavlink_msg msg;
-    ObjectBuffer<struct AP_Scripting::mavlink_msg> *rx_buffer = AP::scripting()->mavlink_data.rx_buffer;
+    struct AP_Scripting::mavlink &data = AP::scripting()->mavlink_data[lua_scripts::get_vm(L)];
+    bool have_msg;
+    {
+        // handle_message() uses the buffer from the GCS thread
+        WITH_SEMAPHORE(data.sem);
+        if (data.rx_buffer == nullptr) {
+            have_msg = false;
+        } else {
+            have_msg = data.rx_buffer->pop(msg);
+        }
+    } // release semaphore here as luaL_error will NOT do that!
 
-    if (rx_buffer == nullptr) {
+    if (data.rx_buffer == nullptr) {
         return luaL_error(L, "RX not initialized");
     }
 
-    if (rx_buffer->pop(msg)) {
+    if (have_msg) {
         lua_pushlstring(L, (char *)&msg.msg, sizeof(msg.msg));
         lua_pushinteger(L, msg.chan);
         *new_uint32_t(L) = msg.timestamp_ms;
@@ -124,33 +137,44 @@ int lua_mavlink_register_rx_msgid(lua_State *L) {
 
     const uint32_t msgid = get_uint32(L, 1+arg_offset, 0, (1 << 24) - 1);
 
-    struct AP_Scripting::mavlink &data = AP::scripting()->mavlink_data;
+    struct AP_Scripting::mavlink &data = AP::scripting()->mavlink_data[lua_scripts::get_vm(L)];
 
-    // check that we aren't currently watching this ID
-    for (uint8_t i = 0; i < data.accept_msg_ids_size; i++) {
-        if (data.accept_msg_ids[i] == msgid) {
-            lua_pushboolean(L, false);
-            return 1;
+    // registrations are checked by handle_message() on the GCS thread
+    bool registered = false;
+    bool full = false;
+    {
+        WITH_SEMAPHORE(data.sem);
+
+        // check that we aren't currently watching this ID
+        bool watching = false;
+        for (uint8_t i = 0; i < data.accept_msg_ids_size; i++) {
+            if (data.accept_msg_ids[i] == msgid) {
+                watching = true;
+                break;
+            }
         }
-    }
 
-    int i = 0;
-    for (i = 0; i < data.accept_msg_ids_size; i++) {
-        if (data.accept_msg_ids[i] == UINT32_MAX) {
-            break;
+        if (!watching) {
+            int i = 0;
+            for (i = 0; i < data.accept_msg_ids_size; i++) {
+                if (data.accept_msg_ids[i] == UINT32_MAX) {
+                    break;
+                }
+            }
+            if (i >= data.accept_msg_ids_size) {
+                full = true;
+            } else {
+                data.accept_msg_ids[i] = msgid;
+                registered = true;
+            }
         }
-    }
+    } // release semaphore here as luaL_error will NOT do that!
 
-    if (i >= data.accept_msg_ids_size) {
+    if (full) {
         return luaL_error(L, "no registrations free");
     }
 
-    {
-        WITH_SEMAPHORE(data.sem);
-        data.accept_msg_ids[i] = msgid;
-    }
-
-    lua_pushboolean(L, true);
+    lua_pushboolean(L, registered);
     return 1;
 }
 
@@ -231,7 +255,8 @@ int lua_mavlink_block_command(lua_State *L) {
 int lua_mission_receive(lua_State *L) {
     binding_argcheck(L, 0);
 
-    ObjectBuffer<struct AP_Scripting::scripting_mission_cmd> *input = AP::scripting()->mission_data;
+    auto *scripting = AP::scripting();
+    ObjectBuffer<struct AP_Scripting::scripting_mission_cmd> *input = scripting->mission_data;
 
     if (input == nullptr) {
         // no mission items ever received
@@ -239,8 +264,15 @@ int lua_mission_receive(lua_State *L) {
     }
 
     struct AP_Scripting::scripting_mission_cmd cmd;
+    bool have_cmd;
+    {
+        // the buffer has a single consumer, but scripts on any VM may
+        // read from it
+        WITH_SEMAPHORE(scripting->resource_sem);
+        have_cmd = input->pop(cmd);
+    }
 
-    if (!input->pop(cmd)) {
+    if (!have_cmd) {
         // no new item
         return 0;
     }
@@ -595,24 +627,32 @@ int lua_get_i2c_device(lua_State *L) {
     auto *scripting = AP::scripting();
 
     static_assert(SCRIPTING_MAX_NUM_I2C_DEVICE >= 0, "There cannot be a negative number of I2C devices");
-    if (scripting->num_i2c_devices >= SCRIPTING_MAX_NUM_I2C_DEVICE) {
-        return luaL_argerror(L, 1, "no i2c devices available");
-    }
-
-    scripting->_i2c_dev[scripting->num_i2c_devices] = NEW_NOTHROW AP_HAL::OwnPtr<AP_HAL::I2CDevice>;
-    if (scripting->_i2c_dev[scripting->num_i2c_devices] == nullptr) {
-        return luaL_argerror(L, 1, "i2c device nullptr");
-    }
-
-    *scripting->_i2c_dev[scripting->num_i2c_devices] = std::move(hal.i2c_mgr->get_device(bus, address, bus_clock, use_smbus));
+    AP_HAL::I2CDevice *dev = nullptr;
+    const char *error = nullptr;
+    {
+        WITH_SEMAPHORE(scripting->resource_sem);
+        const uint8_t idx = scripting->num_i2c_devices;
+        if (idx >= SCRIPTING_MAX_NUM_I2C_DEVICE) {
+            error = "no i2c devices available";
+        } else {
+            scripting->_i2c_dev[idx] = NEW_NOTHROW AP_HAL::OwnPtr<AP_HAL::I2CDevice>;
+            if (scripting->_i2c_dev[idx] != nullptr) {
+                *scripting->_i2c_dev[idx] = std::move(hal.i2c_mgr->get_device(bus, address, bus_clock, use_smbus));
+            }
+            if (scripting->_i2c_dev[idx] == nullptr || scripting->_i2c_dev[idx]->get() == nullptr) {
+                error = "i2c device nullptr";
+            } else {
+                dev = scripting->_i2c_dev[idx]->get();
+                scripting->num_i2c_devices++;
+            }
+        }
+    } // release semaphore here as luaL_error will NOT do that!
 
-    if (scripting->_i2c_dev[scripting->num_i2c_devices] == nullptr || scripting->_i2c_dev[scripting->num_i2c_devices]->get() == nullptr) {
-        return luaL_argerror(L, 1, "i2c device nullptr");
+    if (error != nullptr) {
+        return luaL_argerror(L, 1, error);
     }
 
-    *new_AP_HAL__I2CDevice(L) = scripting->_i2c_dev[scripting->num_i2c_devices]->get();
-
-    scripting->num_i2c_devices++;
+    *new_AP_HAL__I2CDevice(L) = dev;
 
     return 1;
 }
@@ -699,11 +739,15 @@ int lua_get_CAN_device(lua_State *L) {
 
     auto *scripting = AP::scripting();
 
-    if (scripting->_CAN_dev == nullptr) {
-        scripting->_CAN_dev = NEW_NOTHROW ScriptingCANSensor(AP_CAN::Protocol::Scripting);
+    {
+        WITH_SEMAPHORE(scripting->resource_sem);
         if (scripting->_CAN_dev == nullptr) {
-            return luaL_argerror(L, 1, "CAN device nullptr");
+            scripting->_CAN_dev = NEW_NOTHROW ScriptingCANSensor(AP_CAN::Protocol::Scripting);
         }
+    } // release semaphore here as luaL_error will NOT do that!
+
+    if (scripting->_CAN_dev == nullptr) {
+        return luaL_argerror(L, 1, "CAN device nullptr");
     }
 
     if (!scripting->_CAN_dev->initialized()) {
@@ -729,11 +773,15 @@ int lua_get_CAN_device2(lua_State *L) {
 
     auto *scripting = AP::scripting();
 
-    if (scripting->_CAN_dev2 == nullptr) {
-        scripting->_CAN_dev2 = NEW_NOTHROW ScriptingCANSensor(AP_CAN::Protocol::Scripting2);
+    {
+        WITH_SEMAPHORE(scripting->resource_sem);
         if (scripting->_CAN_dev2 == nullptr) {
-            return luaL_argerror(L, 1, "CAN device nullptr");
+            scripting->_CAN_dev2 = NEW_NOTHROW ScriptingCANSensor(AP_CAN::Protocol::Scripting2);
         }
+    } // release semaphore here as luaL_error will NOT do that!
+
+    if (scripting->_CAN_dev2 == nullptr) {
+        return luaL_argerror(L, 1, "CAN device nullptr");
     }
 
     if (!scripting->_CAN_dev2->initialized()) {
@@ -785,6 +833,12 @@ int lua_serial_find_simulated_device(lua_State *L) {
     const int8_t protocol = (int8_t)get_uint32(L, 1 + arg_offset, 0, 127);
     uint32_t instance = get_uint16_t(L, 2 + arg_offset);
 
+    if (lua_scripts::get_vm(L) != 0) {
+        // the device ports have a single reader and writer, so they
+        // are only available to scripts on the first VM
+        return luaL_error(L, "serial devices only available on VM 0");
+    }
+
     auto *scripting = AP::scripting();
     AP_Scripting_SerialDevice::Port *device_stream = nullptr;
 
@@ -899,24 +953,41 @@ int SRV_Channels_get_safety_state(lua_State *L) {
     return 1;
 }
 
+int lua_scripting_alloc_bytes(lua_State *L) {
+    binding_argcheck(L, 1);
+    *new_uint32_t(L) = lua_scripts::get_alloc_bytes(L);
+    return 1;
+}
+
 int lua_get_PWMSource(lua_State *L) {
     binding_argcheck(L, 0);
 
     auto *scripting = AP::scripting();
 
     static_assert(SCRIPTING_MAX_NUM_PWM_SOURCE >= 0, "There cannot be a negative number of PWMSources");
-    if (scripting->num_pwm_source >= SCRIPTING_MAX_NUM_PWM_SOURCE) {
-        return luaL_argerror(L, 1, "no PWMSources available");
-    }
+    AP_HAL::PWMSource *source = nullptr;
+    const char *error = nullptr;
+    {
+        WITH_SEMAPHORE(scripting->resource_sem);
+        const uint8_t idx = scripting->num_pwm_source;
+        if (idx >= SCRIPTING_MAX_NUM_PWM_SOURCE) {
+            error = "no PWMSources available";
+        } else {
+            scripting->_pwm_source[idx] = NEW_NOTHROW AP_HAL::PWMSource;
+            if (scripting->_pwm_source[idx] == nullptr) {
+                error = "PWMSources device nullptr";
+            } else {
+                source = scripting->_pwm_source[idx];
+                scripting->num_pwm_source++;
+            }
+        }
+    } // release semaphore here as luaL_error will NOT do that!
 
-    scripting->_pwm_source[scripting->num_pwm_source] = NEW_NOTHROW AP_HAL::PWMSource;
-    if (scripting->_pwm_source[scripting->num_pwm_source] == nullptr) {
-        return luaL_argerror(L, 1, "PWMSources device nullptr");
+    if (error != nullptr) {
+        return luaL_argerror(L, 1, error);
     }
 
-    *new_AP_HAL__PWMSource(L) = scripting->_pwm_source[scripting->num_pwm_source];
-
-    scripting->num_pwm_source++;
+    *new_AP_HAL__PWMSource(L) = source;
 
     return 1;
 }
@@ -934,12 +1005,21 @@ int lua_get_SocketAPM(lua_State *L) {
     if (sock == nullptr) {
         return luaL_argerror(L, 1, "SocketAPM device nullptr");
     }
-    for (uint8_t i=0; i<SCRIPTING_MAX_NUM_NET_SOCKET; i++) {
-        if (scripting->_net_sockets[i] == nullptr) {
-            scripting->_net_sockets[i] = sock;
-            *new_SocketAPM(L) = scripting->_net_sockets[i];
-            return 1;
+    bool stored = false;
+    {
+        WITH_SEMAPHORE(scripting->resource_sem);
+        for (uint8_t i=0; i<SCRIPTING_MAX_NUM_NET_SOCKET; i++) {
+            if (scripting->_net_sockets[i] == nullptr) {
+                scripting->_net_sockets[i] = sock;
+                stored = true;
+                break;
+            }
         }
+    } // release semaphore here as luaL_error will NOT do that!
+
+    if (stored) {
+        *new_SocketAPM(L) = sock;
+        return 1;
     }
 
     return luaL_argerror(L, 1, "no sockets available");
@@ -956,6 +1036,7 @@ int SocketAPM_close(lua_State *L) {
     auto *scripting = AP::scripting();
 
     // clear allocated socket
+    WITH_SEMAPHORE(scripting->resource_sem);
     for (uint8_t i=0; i<SCRIPTING_MAX_NUM_NET_SOCKET; i++) {
         if (scripting->_net_sockets[i] == ud) {
             ud->close();
@@ -1042,19 +1123,25 @@ int SocketAPM_accept(lua_State *L) {
     auto *scripting = AP::scripting();
 
     // find an empty slot
-    for (uint8_t i=0; i<SCRIPTING_MAX_NUM_NET_SOCKET; i++) {
-        if (scripting->_net_sockets[i] == nullptr) {
-            scripting->_net_sockets[i] = ud->accept(0);
+    SocketAPM *sock = nullptr;
+    {
+        WITH_SEMAPHORE(scripting->resource_sem);
+        for (uint8_t i=0; i<SCRIPTING_MAX_NUM_NET_SOCKET; i++) {
             if (scripting->_net_sockets[i] == nullptr) {
-                return 0;
+                sock = ud->accept(0);
+                scripting->_net_sockets[i] = sock;
+                break;
             }
-            *new_SocketAPM(L) = scripting->_net_sockets[i];
-            return 1;
         }
+    } // release semaphore here as luaL_error will NOT do that!
+
+    if (sock == nullptr) {
+        // no connection or out of socket slots, return nil, caller can retry
+        return 0;
     }
 
-    // out of socket slots, return nil, caller can retry
-    return 0;
+    *new_SocketAPM(L) = sock;
+    return 1;
 }
 
 /*
@@ -1085,10 +1172,9 @@ int SocketAPM_string_to_ipv4_addr(lua_State *L) {
 #endif // AP_NETWORKING_ENABLED
 
 
-int lua_get_current_env_ref()
+int lua_get_current_env_ref(lua_State *L)
 {
-    auto *scripting = AP::scripting();
-    return scripting->get_current_env_ref();
+    return lua_scripts::get_current_env_ref(L);
 }
 
 // This is used when loading modules with require, lua must only look in enabled directory's
@@ -21,16 +21,23 @@
 #include <AP_HAL/AP_HAL.h>
 #include "AP_Scripting.h"
 #include <AP_Logger/AP_Logger.h>
+#include <AP_Common/ExpandingString.h>
 
 #include <AP_Scripting/lua_generated_bindings.h>
 
+extern "C" {
+#include "lua/src/lstate.h"
+}
+
+#if AP_SCRIPTING_BYTECODE_ENABLED && !LUA_SUPPORT_LOAD_BINARY
+#error "AP_SCRIPTING_BYTECODE_ENABLED requires LUA_SUPPORT_LOAD_BINARY"
+#endif
+
 #define DISABLE_INTERRUPTS_FOR_SCRIPT_RUN 0
 
 extern const AP_HAL::HAL& hal;
 #define ENABLE_DEBUG_MODULE 0
 
-bool lua_scripts::overtime;
-jmp_buf lua_scripts::panic_jmp;
 char *lua_scripts::error_msg_buf;
 HAL_Semaphore lua_scripts::error_msg_buf_sem;
 uint8_t lua_scripts::print_error_count;
@@ -40,6 +47,9 @@ uint32_t lua_scripts::loaded_checksum;
 uint32_t lua_scripts::running_checksum;
 HAL_Semaphore lua_scripts::crc_sem;
 
+// upper bounds of the run time histogram bins, the last bin catches everything longer
+static const uint32_t run_time_bins_us[] = { 100, 250, 500, 1000, 2500, 5000, 10000 };
+
 // return string error message for error object at top of stack
 static const char *get_error_object_message(lua_State *L) {
     const char *m = lua_tostring(L, -1);
@@ -49,8 +59,9 @@ static const char *get_error_object_message(lua_State *L) {
     return m;
 }
 
-lua_scripts::lua_scripts(const AP_Int32 &vm_steps, const AP_Int32 &heap_size, AP_Int8 &debug_options)
-    : _vm_steps(vm_steps),
+lua_scripts::lua_scripts(uint8_t vm, const AP_Int32 &vm_steps, const AP_Int32 &heap_size, AP_Int8 &debug_options)
+    : _vm(vm),
+      _vm_steps(vm_steps),
       _debug_options(debug_options)
 {
     const bool allow_heap_expansion = !option_is_set(AP_Scripting::DebugOption::DISABLE_HEAP_EXPANSION);
@@ -61,8 +72,26 @@ lua_scripts::~lua_scripts() {
     _heap.destroy();
 }
 
+lua_scripts *lua_scripts::from_state(lua_State *L) {
+    void *ud;
+    lua_getallocf(L, &ud);
+    return (lua_scripts *)ud;
+}
+
+int lua_scripts::get_current_env_ref(lua_State *L) {
+    return from_state(L)->current_env_ref;
+}
+
+uint8_t lua_scripts::get_vm(lua_State *L) {
+    return from_state(L)->_vm;
+}
+
+uint32_t lua_scripts::get_alloc_bytes(lua_State *L) {
+    return from_state(L)->alloc_bytes_total;
+}
+
 void lua_scripts::hook(lua_State *L, lua_Debug *ar) {
-    lua_scripts::overtime = true;
+    from_state(L)->overtime = true;
 
     // we need to aggressively bail out as we are over time
     // so we will aggressively trap errors until we clear out
@@ -82,15 +111,26 @@ void lua_scripts::print_error(MAV_SEVERITY severity) {
     error_msg_buf_sem.give();
 }
 
+/*
+  re-print the latest error message every 10 seconds, at most
+  max_prints times. The count and time are shared by all VMs
+ */
+void lua_scripts::reprint_error(uint8_t max_prints) {
+    WITH_SEMAPHORE(error_msg_buf_sem);
+    if ((print_error_count < max_prints) && (AP_HAL::millis() - last_print_ms > 10000)) {
+        // note that we do not clear the buffer after we have finished printing, this allows it to be used for a pre-arm check
+        print_error(MAV_SEVERITY_DEBUG);
+        print_error_count++;
+    }
+}
+
 void lua_scripts::set_and_print_new_error_message(MAV_SEVERITY severity, const char *fmt, ...) {
     error_msg_buf_sem.take_blocking();
 
     // reset buffer and print count
     print_error_count = 0;
-    if (error_msg_buf) {
-        _heap.deallocate(error_msg_buf);
-        error_msg_buf = nullptr;
-    }
+    delete[] error_msg_buf;
+    error_msg_buf = nullptr;
 
     // generate va_list and create a copy
     va_list arg_list, arg_list_copy;
@@ -110,8 +150,8 @@ void lua_scripts::set_and_print_new_error_message(MAV_SEVERITY severity, const c
         return;
     }
 
-    // allocate buffer on scripting heap
-    error_msg_buf = (char *)_heap.allocate(len+1);
+    // allocate buffer outside of the scripting heaps as this may be called from any VM
+    error_msg_buf = NEW_NOTHROW char[len+1];
     if (!error_msg_buf) {
         // allocation failed
         va_end(arg_list);
@@ -130,20 +170,30 @@ void lua_scripts::set_and_print_new_error_message(MAV_SEVERITY severity, const c
     print_error(severity);
 }
 
+// clear the last error message, called once all VMs have stopped
+void lua_scripts::clear_last_error_message() {
+    WITH_SEMAPHORE(error_msg_buf_sem);
+    delete[] error_msg_buf;
+    error_msg_buf = nullptr;
+}
+
 int lua_scripts::atpanic(lua_State *L) {
     set_and_print_new_error_message(MAV_SEVERITY_CRITICAL, "Panic: %s", get_error_object_message(L));
-    longjmp(panic_jmp, 1);
+    longjmp(from_state(L)->panic_jmp, 1);
     return 0;
 }
 
 // helper for print and log of runtime stats
-void lua_scripts::update_stats(const char *name, uint32_t run_time, int total_mem, int run_mem)
+void lua_scripts::update_stats(const char *name, uint32_t run_time, int total_mem, int run_mem, uint32_t instructions, uint32_t alloc_bytes, uint32_t gc_time)
 {
     if (option_is_set(AP_Scripting::DebugOption::RUNTIME_MSG)) {
-        GCS_SEND_TEXT(MAV_SEVERITY_DEBUG, "Lua: Time: %u Mem: %d + %d",
+        GCS_SEND_TEXT(MAV_SEVERITY_DEBUG, "Lua: Time: %u Mem: %d + %d Insn: %u Alloc: %u GC: %u",
                                             (unsigned int)run_time,
                                             (int)total_mem,
-                                            (int)run_mem);
+                                            (int)run_mem,
+                                            (unsigned int)instructions,
+                                            (unsigned int)alloc_bytes,
+                                            (unsigned int)gc_time);
     }
 #if HAL_LOGGING_ENABLED
     if (option_is_set(AP_Scripting::DebugOption::LOG_RUNTIME)) {
@@ -153,7 +203,10 @@ void lua_scripts::update_stats(const char *name, uint32_t run_time, int total_me
             name         : {},
             run_time     : run_time,
             total_mem    : total_mem,
-            run_mem      : run_mem
+            run_mem      : run_mem,
+            instructions : instructions,
+            alloc_bytes  : alloc_bytes,
+            gc_time      : gc_time
         };
         const char * name_short = strrchr(name, '/');
         if ((strlen(name) > sizeof(pkt.name)) && (name_short != nullptr)) {
@@ -166,8 +219,89 @@ void lua_scripts::update_stats(const char *name, uint32_t run_time, int total_me
 #endif // HAL_LOGGING_ENABLED
 }
 
+#if AP_SCRIPTING_BYTECODE_ENABLED
+/*
+  header prepended to precompiled scripts by Tools/scripts/build_lua_bytecode.py
+ */
+struct PACKED bytecode_header {
+    char magic[4];      // BYTECODE_MAGIC
+    uint8_t version;    // BYTECODE_VERSION
+    uint8_t reserved[3];
+    uint32_t length;    // length of the bytecode following the header
+    uint32_t crc;       // crc32 of the bytecode
+};
+static const char BYTECODE_MAGIC[] = "APLB";
+static const uint8_t BYTECODE_VERSION = 1;
+
+// reader state for passing bytecode from a file to lua_load
+struct bytecode_reader {
+    int fd;
+    uint32_t remaining;
+    char buf[128];
+};
+
+static const char *read_bytecode(lua_State *L, void *ud, size_t *size) {
+    (void)L;
+    bytecode_reader *r = (bytecode_reader *)ud;
+    const int32_t n = (r->remaining > 0) ? AP::FS().read(r->fd, r->buf, MIN(r->remaining, sizeof(r->buf))) : 0;
+    if (n <= 0) {
+        *size = 0;
+        return nullptr;
+    }
+    r->remaining -= n;
+    *size = n;
+    return r->buf;
+}
+
+// load a precompiled script after checking its header and checksum,
+// returns a lua load status with an error message or the loaded function on the stack
+int lua_scripts::load_bytecode(lua_State *L, const char *filename) {
+    bytecode_reader reader {};
+    reader.fd = AP::FS().open(filename, O_RDONLY);
+    if (reader.fd < 0) {
+        lua_pushfstring(L, "cannot open %s", filename);
+        return LUA_ERRFILE;
+    }
+
+    // the whole file is checked before any of it is given to the
+    // undumper, which trusts the bytecode it is given
+    bytecode_header header;
+    bool valid = (AP::FS().read(reader.fd, &header, sizeof(header)) == sizeof(header)) &&
+                 (memcmp(header.magic, BYTECODE_MAGIC, sizeof(header.magic)) == 0) &&
+                 (header.version == BYTECODE_VERSION);
+    if (valid) {
+        uint32_t crc = 0;
+        uint32_t length = 0;
+        int32_t n;
+        while ((n = AP::FS().read(reader.fd, reader.buf, sizeof(reader.buf))) > 0) {
+            crc = crc_crc32(crc, (const uint8_t *)reader.buf, n);
+            length += n;
+        }
+        valid = (n == 0) && (length == header.length) && (crc == header.crc);
+    }
+    if (!valid || AP::FS().lseek(reader.fd, sizeof(header), SEEK_SET) != (int32_t)sizeof(header)) {
+        AP::FS().close(reader.fd);
+        lua_pushfstring(L, "%s: corrupt bytecode", filename);
+        return LUA_ERRFILE;
+    }
+
+    reader.remaining = header.length;
+    lua_pushfstring(L, "@%s", filename);
+    const int status = lua_load(L, read_bytecode, &reader, lua_tostring(L, -1), "b");
+    lua_remove(L, -2); // remove the chunk name
+    AP::FS().close(reader.fd);
+    return status;
+}
+#endif // AP_SCRIPTING_BYTECODE_ENABLED
+
 lua_scripts::script_info *lua_scripts::load_script(lua_State *L, char *filename) {
-    if (int error = luaL_loadfile(L, filename)) {
+#if AP_SCRIPTING_BYTECODE_ENABLED
+    const size_t name_len = strlen(filename);
+    const bool is_bytecode = (name_len > 5) && (strcmp(&filename[name_len-5], ".luac") == 0);
+    if (int error = (is_bytecode ? load_bytecode(L, filename) : luaL_loadfilex(L, filename, "t"))) {
+#else
+    if (int error = luaL_loadfilex(L, filename, "t")) {
+#endif
         switch (error) {
             case LUA_ERRSYNTAX:
                 set_and_print_new_error_message(MAV_SEVERITY_CRITICAL, "Error: %s", get_error_object_message(L));
@@ -190,6 +324,7 @@ lua_scripts::script_info *lua_scripts::load_script(lua_State *L, char *filename)
 
     const int loadMem = lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
     const uint32_t loadStart = AP_HAL::micros();
+    const uint32_t loadAlloc = alloc_bytes_total;
 
     script_info *new_script = (script_info *)_heap.allocate(sizeof(script_info));
     if (new_script == nullptr) {
@@ -207,9 +342,10 @@ lua_scripts::script_info *lua_scripts::load_script(lua_State *L, char *filename)
     const uint32_t loadEnd = AP_HAL::micros();
     const int endMem = lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
 
-    update_stats(filename, loadEnd-loadStart, endMem, loadMem);
+    update_stats(filename, loadEnd-loadStart, endMem, loadMem, 0, alloc_bytes_total - loadAlloc, 0);
 
     new_script->name = filename;
+    new_script->stats = {};
     new_script->env_ref = luaL_ref(L, LUA_REGISTRYINDEX); // store reference to script's environment
     new_script->run_ref = luaL_ref(L, LUA_REGISTRYINDEX); // store reference to function to run
     new_script->next_run_ms = AP_HAL::millis64() - 1; // force the script to be stale
@@ -275,7 +411,7 @@ void lua_scripts::load_all_scripts_in_dir(lua_State *L, const char *dirname) {
         return;
     }
 
-    // load anything that ends in .lua
+    // load anything that ends in .lua, or .luac if precompiled scripts are supported
     for (struct dirent *de=AP::FS().readdir(d); de; de=AP::FS().readdir(d)) {
         uint8_t length = strlen(de->d_name);
         if (length < 5) {
@@ -283,19 +419,42 @@ void lua_scripts::load_all_scripts_in_dir(lua_State *L, const char *dirname) {
             continue;
         }
 
-        if ((de->d_name[0] == '.') || strncmp(&de->d_name[length-4], ".lua", 4)) {
-            // starts with . (hidden file) or doesn't end in .lua
+        const bool is_source = strncmp(&de->d_name[length-4], ".lua", 4) == 0;
+#if AP_SCRIPTING_BYTECODE_ENABLED
+        const bool is_bytecode = (length > 5) && strncmp(&de->d_name[length-5], ".luac", 5) == 0;
+#else
+        const bool is_bytecode = false;
+#endif
+        if ((de->d_name[0] == '.') || !(is_source || is_bytecode)) {
+            // starts with . (hidden file) or isn't a script
             continue;
         }
 
         // FIXME: because chunk name fetching is not working we are allocating and storing an extra string we shouldn't need to
-        size_t size = strlen(dirname) + strlen(de->d_name) + 2;
+        // one extra byte is allocated so the name of the precompiled version of a source file can be checked
+        size_t size = strlen(dirname) + strlen(de->d_name) + 3;
         char * filename = (char *) _heap.allocate(size);
         if (filename == nullptr) {
             continue;
         }
         snprintf(filename, size, "%s/%s", dirname, de->d_name);
 
+#if AP_SCRIPTING_BYTECODE_ENABLED
+        if (is_source) {
+            // prefer the precompiled version of the script if there is one
+            const size_t name_len = strlen(filename);
+            filename[name_len] = 'c';
+            filename[name_len+1] = '\0';
+            struct stat st;
+            const bool have_bytecode = AP::FS().stat(filename, &st) == 0;
+            filename[name_len] = '\0';
+            if (have_bytecode) {
+                _heap.deallocate(filename);
+                continue;
+            }
+        }
+#endif
+
         // we have something that looks like a lua file, attempt to load it
         script_info * script = load_script(L, filename);
         if (script == nullptr) {
@@ -331,7 +490,11 @@ void lua_scripts::run_next_script(lua_State *L) {
     uint64_t start_time_ms = AP_HAL::millis64();
     // strip the selected script out of the list
     script_info *script = scripts;
-    scripts = script->next;
+    {
+        WITH_SEMAPHORE(stats_sem);
+        scripts = script->next;
+        running_script = script;
+    }
 
     // reset the hook to clear the counter
     reset_loop_overtime(L);
@@ -342,7 +505,7 @@ void lua_scripts::run_next_script(lua_State *L) {
     // pop the function to the top of the stack
     lua_rawgeti(L, LUA_REGISTRYINDEX, script->run_ref);
     // set current environment for other users
-    AP::scripting()->set_current_env_ref(script->env_ref);
+    current_env_ref = script->env_ref;
 
     if(lua_pcall(L, 0, LUA_MULTRET, 0)) {
         if (overtime) {
@@ -403,18 +566,27 @@ void lua_scripts::remove_script(lua_State *L, script_info *script) {
         return;
     }
 
-    // ensure that the script isn't in the loaded list for any reason
-    if (scripts == nullptr) {
-        // nothing to do, already not in the list
-    } else if (scripts == script) {
-        scripts = script->next;
-    } else {
-        for(script_info * current = scripts; current->next != nullptr; current = current->next) {
-            if (current->next == script) {
-                current->next = script->next;
-                break;
+    {
+        WITH_SEMAPHORE(stats_sem);
+
+        // ensure that the script isn't in the loaded list for any reason
+        if (scripts == nullptr) {
+            // nothing to do, already not in the list
+        } else if (scripts == script) {
+            scripts = script->next;
+        } else {
+            for(script_info * current = scripts; current->next != nullptr; current = current->next) {
+                if (current->next == script) {
+                    current->next = script->next;
+                    break;
+                }
             }
         }
+
+        // statistics of a removed script are discarded
+        if (running_script == script) {
+            running_script = nullptr;
+        }
     }
 
     {
@@ -440,6 +612,8 @@ void lua_scripts::reschedule_script(script_info *script) {
        return;
     }
 
+    WITH_SEMAPHORE(stats_sem);
+
     script->next = nullptr;
     if (scripts == nullptr) {
         scripts = script;
@@ -467,11 +641,14 @@ void lua_scripts::reschedule_script(script_info *script) {
     previous->next = script;
 }
 
-MultiHeap lua_scripts::_heap;
-
 void *lua_scripts::alloc(void *ud, void *ptr, size_t osize, size_t nsize) {
-    (void)ud; /* not used */
-    return _heap.change_size(ptr, osize, nsize);
+    lua_scripts *lua = (lua_scripts *)ud;
+    // when ptr is null osize holds the type of the object being allocated rather than a size
+    const size_t old_size = (ptr == nullptr) ? 0 : osize;
+    if (nsize > old_size) {
+        lua->alloc_bytes_total += nsize - old_size;
+    }
+    return lua->_heap.change_size(ptr, osize, nsize);
 }
 
 void lua_scripts::run(void) {
@@ -495,10 +672,11 @@ void lua_scripts::run(void) {
             remove_script(nullptr, script);
         }
         scripts = nullptr;
+        running_script = nullptr;
         overtime = false;
     }
 
-    lua_state = lua_newstate(alloc, NULL);
+    lua_state = lua_newstate(alloc, this);
     lua_State *L = lua_state;
     if (L == nullptr) {
         GCS_SEND_TEXT(MAV_SEVERITY_CRITICAL, "Lua: Couldn't allocate a lua state");
@@ -532,11 +710,18 @@ void lua_scripts::run(void) {
     uint16_t dir_disable = AP_Scripting::get_singleton()->get_disabled_dir();
     bool loaded = false;
     if ((dir_disable & uint16_t(AP_Scripting::SCR_DIR::SCRIPTS)) == 0) {
-        load_all_scripts_in_dir(L, SCRIPTING_DIRECTORY);
+        if (_vm == 0) {
+            load_all_scripts_in_dir(L, SCRIPTING_DIRECTORY);
+        } else {
+            // additional VMs each run a subdirectory of the scripts directory
+            char dirname[sizeof(SCRIPTING_DIRECTORY "/vm") + 3];
+            hal.util->snprintf(dirname, sizeof(dirname), SCRIPTING_DIRECTORY "/vm%u", unsigned(_vm));
+            load_all_scripts_in_dir(L, dirname);
+        }
         loaded = true;
     }
 #ifdef HAL_HAVE_AP_ROMFS_EMBEDDED_LUA
-    if ((dir_disable & uint16_t(AP_Scripting::SCR_DIR::ROMFS)) == 0) {
+    if ((_vm == 0) && (dir_disable & uint16_t(AP_Scripting::SCR_DIR::ROMFS)) == 0) {
         load_all_scripts_in_dir(L, "@ROMFS/scripts");
         loaded = true;
     }
@@ -590,6 +775,7 @@ void lua_scripts::run(void) {
 #endif
 
             const int startMem = lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
+            const uint32_t startAlloc = alloc_bytes_total;
             const uint32_t loadEnd = AP_HAL::micros();
 
             // NOTE!  the base pointer of our scripts linked list,
@@ -599,17 +785,20 @@ void lua_scripts::run(void) {
             run_next_script(L);
 
             const uint32_t runEnd = AP_HAL::micros();
+            const uint32_t instructions = get_instructions_run(L);
+            const uint32_t runAlloc = alloc_bytes_total - startAlloc;
             const int endMem = lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
 
 #if DISABLE_INTERRUPTS_FOR_SCRIPT_RUN
             hal.scheduler->restore_interrupts(istate);
 #endif
 
-            update_stats(script_name, runEnd - loadEnd, endMem, endMem - startMem);
-
-
             // garbage collect after each script, this shouldn't matter, but seems to resolve a memory leak
             lua_gc(L, LUA_GCCOLLECT, 0);
+            const uint32_t gcEnd = AP_HAL::micros();
+
+            accumulate_stats(runEnd - loadEnd, instructions, runAlloc, gcEnd - runEnd);
+            update_stats(script_name, runEnd - loadEnd, endMem, endMem - startMem, instructions, runAlloc, gcEnd - runEnd);
 
         } else {
             if (option_is_set(AP_Scripting::DebugOption::NO_SCRIPTS_TO_RUN)) {
@@ -630,12 +819,7 @@ void lua_scripts::run(void) {
         }
 
         // re-print the latest error message every 10 seconds 10 times
-        const uint8_t error_prints = 10;
-        if ((print_error_count < error_prints) && (AP_HAL::millis() - last_print_ms > 10000)) {
-            // note that we do not clear the buffer after we have finished printing, this allows it to be used for a pre-arm check
-            print_error(MAV_SEVERITY_DEBUG);
-            print_error_count++;
-        }
+        reprint_error(10);
     }
 
     // make sure all scripts have been removed
@@ -647,13 +831,93 @@ void lua_scripts::run(void) {
         lua_close(lua_state); // shutdown the old state
         lua_state = nullptr;
     }
+}
 
-    error_msg_buf_sem.take_blocking();
-    if (error_msg_buf != nullptr) {
-        _heap.deallocate(error_msg_buf);
-        error_msg_buf = nullptr;
+// number of VM instructions executed by the last call to run_next_script
+uint32_t lua_scripts::get_instructions_run(lua_State *L) const
+{
+    const int32_t vm_steps = MAX(_vm_steps, 1000);
+    if (overtime) {
+        // the hook has been replaced to trap every instruction, the whole budget was used
+        return vm_steps;
+    }
+    // the count hook decrements hookcount for every instruction run on the main thread
+    return MAX(L->basehookcount - L->hookcount, 0);
+}
+
+// accumulate the statistics of the last run into the running script
+void lua_scripts::accumulate_stats(uint32_t run_time_us, uint32_t instructions, uint32_t alloc_bytes, uint32_t gc_time_us)
+{
+    WITH_SEMAPHORE(stats_sem);
+    if (running_script == nullptr) {
+        // script was removed during the run
+        return;
+    }
+    script_stats &stats = running_script->stats;
+    stats.run_count++;
+    stats.run_time_us += run_time_us;
+    stats.max_run_time_us = MAX(stats.max_run_time_us, run_time_us);
+    stats.instructions += instructions;
+    stats.alloc_bytes += alloc_bytes;
+    stats.gc_time_us += gc_time_us;
+
+    uint8_t bin = 0;
+    while (bin < ARRAY_SIZE(run_time_bins_us) && run_time_us > run_time_bins_us[bin]) {
+        bin++;
+    }
+    stats.run_time_hist[bin]++;
+
+    running_script = nullptr;
+}
+
+// fill in the header for @SYS/scripts.txt
+void lua_scripts::stats_header(ExpandingString &str)
+{
+    static_assert(ARRAY_SIZE(run_time_bins_us) + 1 == num_run_time_bins, "run time bins must match histogram size");
+
+    // a header to allow for machine parsers to determine format
+    str.printf("ScriptsV1\n");
+    str.printf("HIST(us)");
+    for (uint8_t i = 0; i < ARRAY_SIZE(run_time_bins_us); i++) {
+        str.printf(" <=%u", unsigned(run_time_bins_us[i]));
+    }
+    str.printf(" >%u\n", unsigned(run_time_bins_us[ARRAY_SIZE(run_time_bins_us)-1]));
+}
+
+// fill in per-script runtime statistics for @SYS/scripts.txt
+void lua_scripts::stats_info(ExpandingString &str)
+{
+    auto print_stats = [&str, this](const script_info &script) {
+        const script_stats &stats = script.stats;
+        const char *name = strrchr(script.name, '/');
+        name = (name != nullptr) ? name + 1 : script.name;
+        const uint32_t count = MAX(stats.run_count, 1U);
+        str.printf("%-24.24s VM=%u RUN=%6u AVG=%6u MAX=%6u INSN=%7u ALLOC=%7u GC=%5u HIST=",
+                   name,
+                   unsigned(_vm),
+                   unsigned(stats.run_count),
+                   unsigned(stats.run_time_us / count),
+                   unsigned(stats.max_run_time_us),
+                   unsigned(stats.instructions / count),
+                   unsigned(stats.alloc_bytes / count),
+                   unsigned(stats.gc_time_us / count));
+        for (uint8_t i = 0; i < num_run_time_bins; i++) {
+            str.printf(i == 0 ? "%u" : ",%u", unsigned(stats.run_time_hist[i]));
+        }
+        str.printf("\n");
+    };
+
+    WITH_SEMAPHORE(stats_sem);
+
+    // the running script is stripped from the list while it runs, so print it first
+    if (running_script != nullptr) {
+        print_stats(*running_script);
+    }
+    for (script_info *script = scripts; script != nullptr; script = script->next) {
+        if (script != running_script) {
+            print_stats(*script);
+        }
     }
-    error_msg_buf_sem.give();
 }
 
 // Return the file checksums of running and loaded scripts
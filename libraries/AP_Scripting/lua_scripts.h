@@ -31,10 +31,12 @@
 
 #include "lua/src/lua.hpp"
 
+class ExpandingString;
+
 class lua_scripts
 {
 public:
-    lua_scripts(const AP_Int32 &vm_steps, const AP_Int32 &heap_size, AP_Int8 &debug_options);
+    lua_scripts(uint8_t vm, const AP_Int32 &vm_steps, const AP_Int32 &heap_size, AP_Int8 &debug_options);
 
     ~lua_scripts();
 
@@ -46,23 +48,59 @@ public:
     // run scripts, does not return unless an error occured
     void run(void);
 
-    static bool overtime; // script exceeded it's execution slot, and we are bailing out
+    bool overtime; // script exceeded it's execution slot, and we are bailing out
+
+    // fill in the header and per-script runtime statistics for @SYS/scripts.txt
+    static void stats_header(ExpandingString &str);
+    void stats_info(ExpandingString &str);
+
+    // reference to the environment of the script currently being run by the VM owning L
+    static int get_current_env_ref(lua_State *L);
+
+    // index of the VM owning L
+    static uint8_t get_vm(lua_State *L);
+
+    // running total of bytes allocated by the VM owning L, wraps
+    static uint32_t get_alloc_bytes(lua_State *L);
 
 private:
 
+    // the lua_scripts instance owning a state, passed to lua_newstate as the allocator userdata
+    static lua_scripts *from_state(lua_State *L);
+
     void create_sandbox(lua_State *L);
 
+    // number of bins in the run time histogram, see run_time_bins_us
+    static const uint8_t num_run_time_bins = 8;
+
+    // accumulated runtime statistics for a single script
+    typedef struct script_stats {
+       uint32_t run_count;       // number of times the script has been run
+       uint64_t run_time_us;     // total time spent running the script
+       uint32_t max_run_time_us; // longest single run
+       uint64_t instructions;    // VM instructions executed (excluding coroutines)
+       uint64_t alloc_bytes;     // bytes allocated from the scripting heap
+       uint64_t gc_time_us;      // time spent in the garbage collection following each run
+       uint32_t run_time_hist[num_run_time_bins]; // histogram of run times
+    } script_stats;
+
     typedef struct script_info {
        int env_ref;          // reference to the script's environment table
        int run_ref;          // reference to the function to run
        uint64_t next_run_ms; // time (in milliseconds) the script should next be run at
        uint32_t crc;         // crc32 checksum
        char *name;           // filename for the script // FIXME: This information should be available from Lua
+       script_stats stats;   // runtime statistics, protected by stats_sem
        script_info *next;
     } script_info;
 
     script_info *load_script(lua_State *L, char *filename);
 
+#if AP_SCRIPTING_BYTECODE_ENABLED
+    // load a precompiled script after checking its header and checksum, returns a lua load status
+    int load_bytecode(lua_State *L, const char *filename);
+#endif
+
     void reset_loop_overtime(lua_State *L);
 
     void load_all_scripts_in_dir(lua_State *L, const char *dirname);
@@ -76,16 +114,34 @@ private:
 
     script_info *scripts; // linked list of scripts to be run, sorted by next run time (soonest first)
 
+    // script currently being run, it is not in the scripts list while running
+    script_info *running_script;
+
+    // protects the scripts list and script statistics against access from @SYS
+    HAL_Semaphore stats_sem;
+
+    // number of VM instructions executed by the last call to run_next_script
+    uint32_t get_instructions_run(lua_State *L) const;
+
+    // accumulate the statistics of the last run into the running script
+    void accumulate_stats(uint32_t run_time_us, uint32_t instructions, uint32_t alloc_bytes, uint32_t gc_time_us);
+
     // hook will be run when CPU time for a script is exceeded
     // it must be static to be passed to the C API
     static void hook(lua_State *L, lua_Debug *ar);
 
     // lua panic handler, will jump back to the start of run
     static int atpanic(lua_State *L);
-    static jmp_buf panic_jmp;
+    jmp_buf panic_jmp;
 
     lua_State *lua_state;
 
+    // index of this VM, VM 0 runs the scripts directory and ROMFS, the others run SCRIPTING_DIRECTORY/vmN
+    const uint8_t _vm;
+
+    // environment of the script currently being run, used by require
+    int current_env_ref;
+
     const AP_Int32 & _vm_steps;
     AP_Int8 & _debug_options;
 
@@ -95,15 +151,21 @@ private:
 
     static void *alloc(void *ud, void *ptr, size_t osize, size_t nsize);
 
-    static MultiHeap _heap;
+    MultiHeap _heap;
+
+    // running total of bytes allocated through alloc, wraps
+    uint32_t alloc_bytes_total;
 
     // helper for print and log of runtime stats
-    void update_stats(const char *name, uint32_t run_time, int total_mem, int run_mem);
+    void update_stats(const char *name, uint32_t run_time, int total_mem, int run_mem, uint32_t instructions, uint32_t alloc_bytes, uint32_t gc_time);
 
     // must be static for use in atpanic
     static void print_error(MAV_SEVERITY severity);
+    // re-print the latest error message at most max_prints times
+    static void reprint_error(uint8_t max_prints);
     static char *error_msg_buf;
     static HAL_Semaphore error_msg_buf_sem;
+    // shared by all VMs, protected by error_msg_buf_sem
     static uint8_t print_error_count;
     static uint32_t last_print_ms;
 
@@ -122,6 +184,9 @@ public:
     // get semaphore for above error buffer
     static AP_HAL::Semaphore* get_last_error_semaphore() { return &error_msg_buf_sem; }
 
+    // clear the last error message, called once all VMs have stopped
+    static void clear_last_error_message();
+
     // Return the file checksums of running and loaded scripts
     static uint32_t get_loaded_checksum();
     static uint32_t get_running_checksum();
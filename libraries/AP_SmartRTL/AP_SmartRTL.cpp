@@ -30,8 +30,8 @@ const AP_Param::GroupInfo AP_SmartRTL::var_info[] = {
 
     // @Param: POINTS
     // @DisplayName: SmartRTL maximum number of points on path
-    // @Description: SmartRTL maximum number of points on path. Set to 0 to disable SmartRTL.  100 points consumes about 3k of memory.
-    // @Range: 0 500
+    // @Description: SmartRTL maximum number of points on path. Set to 0 to disable SmartRTL.  100 points consumes about 4k of memory.  Boards with less than 500k of RAM are limited to 500 points.
+    // @Range: 0 5000
     // @User: Advanced
     // @RebootRequired: True
     AP_GROUPINFO("POINTS", 1, AP_SmartRTL, _points_max, SMARTRTL_POINTS_DEFAULT),
@@ -62,7 +62,8 @@ const AP_Param::GroupInfo AP_SmartRTL::var_info[] = {
 *    points when their line segments get close. This algorithm will never
 *    compare two consecutive line segments. Obviously the segments (p1,p2) and
 *    (p2,p3) will get very close (they touch), but there would be nothing to
-*    trim between them.
+*    trim between them.  The segments are kept in a horizontal spatial hash so
+*    each segment is only compared with the segments in nearby cells.
 *
 *    2. Simplification uses the Ramer-Douglas-Peucker algorithm. See Wikipedia
 *    for a more complete description.
@@ -115,15 +116,30 @@ void AP_SmartRTL::init()
     _simplify.stack_max = _points_max * SMARTRTL_SIMPLIFY_STACK_LEN_MULT;
     _simplify.stack = (simplify_start_finish_t*)calloc(_simplify.stack_max, sizeof(simplify_start_finish_t));
 
+    // one bucket for every two points keeps the lists short without using much memory
+    _prune.hash_buckets_num = 1;
+    while (_prune.hash_buckets_num < _points_max / 2) {
+        _prune.hash_buckets_num *= 2;
+    }
+    _prune.hash_buckets = (uint16_t*)calloc(_prune.hash_buckets_num, sizeof(uint16_t));
+    _prune.hash_entries_max = MIN(_points_max * SMARTRTL_PRUNING_HASH_ENTRY_LEN_MULT, SMARTRTL_PRUNING_HASH_NONE - 1);
+    _prune.hash_entries = (prune_hash_entry_t*)calloc(_prune.hash_entries_max, sizeof(prune_hash_entry_t));
+
     // check if memory allocation failed
-    if (_path == nullptr || _prune.loops == nullptr || _simplify.stack == nullptr) {
+    if (_path == nullptr || _prune.loops == nullptr || _simplify.stack == nullptr ||
+        _prune.hash_buckets == nullptr || _prune.hash_entries == nullptr) {
         log_action(Action::DEACTIVATED_INIT_FAILED);
         GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "SmartRTL deactivated: init failed");
         free(_path);
         free(_prune.loops);
         free(_simplify.stack);
+        free(_prune.hash_buckets);
+        free(_prune.hash_entries);
+        _path = nullptr;
         return;
     }
+    _prune.hash_cell_size = _accuracy * SMARTRTL_PRUNING_HASH_CELL_MULT;
+    reset_prune_hash();
 
     _path_points_max = _points_max;
 
@@ -522,23 +538,31 @@ void AP_SmartRTL::detect_simplifications()
         const uint16_t start_index = tmp.start;
         const uint16_t end_index = tmp.finish;
 
-        // find the point between start and end points that is farthest from the start-end line segment
-        float max_dist = 0.0f;
+        // find the point between start and end points that is farthest from the start-end line.
+        // the distance squared is |(point - start) x line|^2 / |line|^2 so only the cross product
+        // is needed for each point and the division is done once at the end
+        const Vector3f &start_point = _path[start_index];
+        const Vector3f line = _path[end_index] - start_point;
+        const float line_length_sq = line.length_squared();
+        float max_cross_sq = 0.0f;
         uint16_t farthest_point_index = start_index;
-        for (uint16_t i = start_index + 1; i < end_index; i++) {
-            // only check points that have not already been flagged for simplification
-            if (_simplify.bitmask.get(i)) {
-                const float dist = _path[i].distance_to_segment(_path[start_index], _path[end_index]);
-                if (dist > max_dist) {
-                    farthest_point_index = i;
-                    max_dist = dist;
+        if (!is_zero(line_length_sq)) {
+            for (uint16_t i = start_index + 1; i < end_index; i++) {
+                // only check points that have not already been flagged for simplification
+                if (_simplify.bitmask.get(i)) {
+                    const float cross_sq = ((_path[i] - start_point) % line).length_squared();
+                    if (cross_sq > max_cross_sq) {
+                        farthest_point_index = i;
+                        max_cross_sq = cross_sq;
+                    }
                 }
             }
         }
+        const float max_dist_sq = is_zero(line_length_sq) ? 0.0f : max_cross_sq / line_length_sq;
 
         // if the farthest point is more than ACCURACY * 0.5 add two new elements to the _simplification_stack
         // so that on the next iteration we will check between start-to-farthestpoint and farthestpoint-to-end
-        if (max_dist > SMARTRTL_SIMPLIFY_EPSILON) {
+        if (max_dist_sq > sq(SMARTRTL_SIMPLIFY_EPSILON)) {
             // if the to-do list is full, give up on simplifying. This should never happen.
             if (_simplify.stack_count >= _simplify.stack_max) {
                 _simplify.complete = true;
@@ -563,6 +587,9 @@ void AP_SmartRTL::detect_simplifications()
 *   this function does not alter the path in memory. It works by comparing the line segment between any two sequential points
 *   to the line segment between any other two sequential points. If they get close enough, anything between them could be pruned.
 *
+*   The segments are first added to the spatial hash, then each new segment is checked against the segments in the hash cells
+*   it passes through.
+*
 *   reset_pruning should have been called at least once before this function is called to setup the indexes (_prune.i, etc)
 */
 void AP_SmartRTL::detect_loops()
@@ -570,42 +597,195 @@ void AP_SmartRTL::detect_loops()
     // if there are less than 4 points (3 segments), mark complete
     if (_prune.path_points_count < 4) {
         _prune.complete = true;
+        _prune.path_points_completed = _prune.path_points_count;
         return;
     }
 
     // capture start time
     const uint32_t start_time_us = AP_HAL::micros();
 
+    // add any new segments to the hash.  if it fills up the remaining segments are checked directly
+    while (!_prune.hash_full && _prune.hash_segments < _prune.path_points_count - 1) {
+        if (AP_HAL::micros() - start_time_us >= SMARTRTL_PRUNING_LOOP_TIME_US) {
+            return;
+        }
+        if (add_segment_to_prune_hash(_prune.hash_segments + 1)) {
+            _prune.hash_segments++;
+        } else {
+            _prune.hash_full = true;
+        }
+    }
+
     // run for defined amount of time
     while (AP_HAL::micros() - start_time_us < SMARTRTL_PRUNING_LOOP_TIME_US) {
 
-        // advance inner loop
-        _prune.j++;
-        if (_prune.j > _prune.i - 2) {
-            // set inner loop back to first point
-            _prune.j = 1;
-            // reduce outer loop
-            _prune.i--;
-            // complete when outer loop has run out of new points to check
-            if (_prune.i < 4 || _prune.i < _prune.path_points_completed) {
+        // look for an earlier segment that gets close to the segment ending at point i
+        uint16_t loop_start;
+        dist_point dp;
+        if (find_loop_start(_prune.i, loop_start, dp)) {
+            // if there is a loop here, add to loop array
+            if (!add_loop(loop_start, _prune.i-1, dp.midpoint)) {
+                // if the buffer is full, stop trying to prune
                 _prune.complete = true;
                 _prune.path_points_completed = _prune.path_points_count;
                 return;
             }
         }
 
-        // find the closest distance between two line segments and the mid-point
-        dist_point dp = segment_segment_dist(_path[_prune.i], _path[_prune.i-1], _path[_prune.j-1], _path[_prune.j]);
-        if (dp.distance < SMARTRTL_PRUNING_DELTA) {
-            // if there is a loop here, add to loop array
-            if (!add_loop(_prune.j, _prune.i-1, dp.midpoint)) {
-                // if the buffer is full, stop trying to prune
-                _prune.complete = true;
+        // move to the previous segment, complete when we have run out of new points to check
+        _prune.i--;
+        if (_prune.i < 4 || _prune.i < _prune.path_points_completed) {
+            _prune.complete = true;
+            _prune.path_points_completed = _prune.path_points_count;
+            return;
+        }
+    }
+}
+
+// find the earliest segment that gets closer than SMARTRTL_PRUNING_DELTA to the segment ending at point i
+// returns false if there is no such segment
+bool AP_SmartRTL::find_loop_start(uint16_t i, uint16_t &loop_start, dist_point &loop_dp)
+{
+    const Vector3f &p1 = _path[i];
+    const Vector3f &p2 = _path[i-1];
+    const float delta = SMARTRTL_PRUNING_DELTA;
+
+    // segments up to last_segment are compared, the segment touching this one is skipped
+    const uint16_t last_segment = i - 2;
+    const uint16_t last_hashed = MIN(_prune.hash_segments, last_segment);
+
+    // the earliest segment found so far, last_segment + 1 if none
+    uint16_t best = last_segment + 1;
+
+    int32_t x_min, y_min, x_max, y_max;
+    if (get_prune_hash_cells(p1, p2, delta, x_min, y_min, x_max, y_max)) {
+        // check the segments in the cells this segment passes through
+        // a segment covering several cells appears in each so later copies are skipped by the best check
+        for (int32_t x = x_min; x <= x_max; x++) {
+            for (int32_t y = y_min; y <= y_max; y++) {
+                for (uint16_t e = _prune.hash_buckets[prune_hash_bucket(x, y)]; e != SMARTRTL_PRUNING_HASH_NONE; e = _prune.hash_entries[e].next) {
+                    const uint16_t j = _prune.hash_entries[e].segment;
+                    if (j >= best || j > last_hashed) {
+                        continue;
+                    }
+                    const dist_point dp = segment_segment_dist(p1, p2, _path[j-1], _path[j]);
+                    if (dp.distance < delta) {
+                        best = j;
+                        loop_dp = dp;
+                    }
+                }
+            }
+        }
+        for (uint16_t e = _prune.hash_long_segments; e != SMARTRTL_PRUNING_HASH_NONE; e = _prune.hash_entries[e].next) {
+            const uint16_t j = _prune.hash_entries[e].segment;
+            if (j >= best || j > last_hashed) {
+                continue;
+            }
+            const dist_point dp = segment_segment_dist(p1, p2, _path[j-1], _path[j]);
+            if (dp.distance < delta) {
+                best = j;
+                loop_dp = dp;
             }
-            // set inner loop forward to trigger outer loop move to next segment
-            _prune.j = _prune.i;
         }
+    } else {
+        // this segment covers too many cells, it is quicker to check every hashed segment in order
+        for (uint16_t j = 1; j <= last_hashed; j++) {
+            const dist_point dp = segment_segment_dist(p1, p2, _path[j-1], _path[j]);
+            if (dp.distance < delta) {
+                best = j;
+                loop_dp = dp;
+                break;
+            }
+        }
+    }
+
+    // segments which are not in the hash come after all hashed segments so only need checking if nothing was found
+    if (best > last_segment) {
+        for (uint16_t j = last_hashed + 1; j <= last_segment; j++) {
+            const dist_point dp = segment_segment_dist(p1, p2, _path[j-1], _path[j]);
+            if (dp.distance < delta) {
+                best = j;
+                loop_dp = dp;
+                break;
+            }
+        }
+    }
+
+    if (best > last_segment) {
+        return false;
+    }
+    loop_start = best;
+    return true;
+}
+
+// empty the spatial hash so that it is rebuilt from the current path
+void AP_SmartRTL::reset_prune_hash()
+{
+    for (uint16_t b = 0; b < _prune.hash_buckets_num; b++) {
+        _prune.hash_buckets[b] = SMARTRTL_PRUNING_HASH_NONE;
+    }
+    _prune.hash_long_segments = SMARTRTL_PRUNING_HASH_NONE;
+    _prune.hash_entries_count = 0;
+    _prune.hash_segments = 0;
+    _prune.hash_full = false;
+}
+
+// add the segment joining points segment-1 and segment to the hash
+// returns false if there are not enough free hash entries
+bool AP_SmartRTL::add_segment_to_prune_hash(uint16_t segment)
+{
+    int32_t x_min, y_min, x_max, y_max;
+    const bool in_cells = get_prune_hash_cells(_path[segment-1], _path[segment], 0.0f, x_min, y_min, x_max, y_max);
+    const uint16_t entries_required = in_cells ? (x_max - x_min + 1) * (y_max - y_min + 1) : 1;
+    if (_prune.hash_entries_count + entries_required > _prune.hash_entries_max) {
+        return false;
+    }
+
+    if (!in_cells) {
+        prune_hash_entry_t &entry = _prune.hash_entries[_prune.hash_entries_count];
+        entry.segment = segment;
+        entry.next = _prune.hash_long_segments;
+        _prune.hash_long_segments = _prune.hash_entries_count++;
+        return true;
+    }
+
+    for (int32_t x = x_min; x <= x_max; x++) {
+        for (int32_t y = y_min; y <= y_max; y++) {
+            uint16_t &bucket = _prune.hash_buckets[prune_hash_bucket(x, y)];
+            prune_hash_entry_t &entry = _prune.hash_entries[_prune.hash_entries_count];
+            entry.segment = segment;
+            entry.next = bucket;
+            bucket = _prune.hash_entries_count++;
+        }
+    }
+    return true;
+}
+
+// get the range of horizontal hash cells covered by the segment from p1 to p2 expanded by margin
+// returns false if this is more than SMARTRTL_PRUNING_HASH_CELLS_MAX cells
+bool AP_SmartRTL::get_prune_hash_cells(const Vector3f& p1, const Vector3f& p2, float margin, int32_t &x_min, int32_t &y_min, int32_t &x_max, int32_t &y_max) const
+{
+    const float cell_size = _prune.hash_cell_size;
+    const float x_lo = (MIN(p1.x, p2.x) - margin) / cell_size;
+    const float x_hi = (MAX(p1.x, p2.x) + margin) / cell_size;
+    const float y_lo = (MIN(p1.y, p2.y) - margin) / cell_size;
+    const float y_hi = (MAX(p1.y, p2.y) + margin) / cell_size;
+    if ((x_hi - x_lo + 1) * (y_hi - y_lo + 1) > SMARTRTL_PRUNING_HASH_CELLS_MAX * 2) {
+        // too large, this also protects the integer conversion below
+        return false;
     }
+    x_min = floorf(x_lo);
+    x_max = floorf(x_hi);
+    y_min = floorf(y_lo);
+    y_max = floorf(y_hi);
+    return (x_max - x_min + 1) * (y_max - y_min + 1) <= SMARTRTL_PRUNING_HASH_CELLS_MAX;
+}
+
+// returns the bucket holding the hash cell x,y
+uint16_t AP_SmartRTL::prune_hash_bucket(int32_t x, int32_t y) const
+{
+    const uint32_t h = (uint32_t(x) * 73856093U) ^ (uint32_t(y) * 19349663U);
+    return h & (_prune.hash_buckets_num - 1);
 }
 
 // restart simplify if new points have been added to path
@@ -649,8 +829,12 @@ void AP_SmartRTL::restart_pruning(uint16_t path_points_count)
 {
     _prune.complete = false;
     _prune.i = (path_points_count > 0) ? path_points_count - 1 : 0;
-    _prune.j = 0;
     _prune.path_points_count = path_points_count;
+
+    // the hash may hold segments that have since been popped off the path
+    if (path_points_count < _prune.hash_segments + 1) {
+        reset_prune_hash();
+    }
 }
 
 // reset pruning algorithm so that it will re-check all points in the path
@@ -659,6 +843,7 @@ void AP_SmartRTL::reset_pruning()
     restart_pruning(0);
     _prune.loops_count = 0; // clear the loops that we've recorded
     _prune.path_points_completed = 0;
+    reset_prune_hash();
 }
 
 // remove all simplify-able points from the path
@@ -695,6 +880,11 @@ void AP_SmartRTL::remove_points_by_simplify_bitmask()
     // flag point removal is complete
     _simplify.bitmask.setall();
     _simplify.removal_required = false;
+
+    // points have moved so the hash must be rebuilt
+    if (removed > 0) {
+        reset_prune_hash();
+    }
 }
 
 // remove loops until at least num_point_to_delete have been removed from path
@@ -755,6 +945,11 @@ bool AP_SmartRTL::remove_points_by_loops(uint16_t num_points_to_remove)
     }
 
     _path_sem.give();
+
+    // points have moved so the hash must be rebuilt
+    if (removed_points > 0) {
+        reset_prune_hash();
+    }
     return true;
 }
 
@@ -7,8 +7,14 @@
 
 // definitions and macros
 #define SMARTRTL_ACCURACY_DEFAULT        2.0f   // default _ACCURACY parameter value.  Points will be no closer than this distance (in meters) together.
-#define SMARTRTL_POINTS_DEFAULT          300    // default _POINTS parameter value.  High numbers improve path pruning but use more memory and CPU for cleanup. Memory used will be 20bytes * this number.
-#define SMARTRTL_POINTS_MAX              500    // the absolute maximum number of points this library can support.
+#define SMARTRTL_POINTS_DEFAULT          300    // default _POINTS parameter value.  High numbers improve path pruning but use more memory and CPU for cleanup. Memory used will be 35bytes * this number.
+#ifndef SMARTRTL_POINTS_MAX
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_500
+#define SMARTRTL_POINTS_MAX              5000   // the absolute maximum number of points this library can support.
+#else
+#define SMARTRTL_POINTS_MAX              500
+#endif
+#endif
 #define SMARTRTL_TIMEOUT                 15000  // the time in milliseconds with no points saved to the path (for whatever reason), before SmartRTL is disabled for the flight
 #define SMARTRTL_CLEANUP_POINT_TRIGGER   50     // simplification will trigger when this many points are added to the path
 #define SMARTRTL_CLEANUP_START_MARGIN    10     // routine cleanup algorithms begin when the path array has only this many empty slots remaining
@@ -21,6 +27,10 @@
 #define SMARTRTL_PRUNING_DELTA (_accuracy * 0.99)   // How many meters apart must two points be, such that we can assume that there is no obstacle between them.  must be smaller than _ACCURACY parameter
 #define SMARTRTL_PRUNING_LOOP_BUFFER_LEN_MULT 0.25f // pruning loop buffer size as compared to maximum number of points
 #define SMARTRTL_PRUNING_LOOP_TIME_US    200    // maximum time (in microseconds) that the loop finding algorithm will run before returning
+#define SMARTRTL_PRUNING_HASH_CELL_MULT  4      // size of the pruning spatial hash cells as a multiple of the _ACCURACY parameter
+#define SMARTRTL_PRUNING_HASH_CELLS_MAX  16     // segments covering more cells than this are kept on a single list that is checked for every segment
+#define SMARTRTL_PRUNING_HASH_ENTRY_LEN_MULT 3  // pruning spatial hash entries as compared to maximum number of points
+#define SMARTRTL_PRUNING_HASH_NONE       UINT16_MAX // marks the end of a spatial hash list
 
 class AP_SmartRTL {
 
@@ -167,6 +177,18 @@ private:
         Vector3f midpoint;
     } dist_point;
 
+    // spatial hash used by detect_loops to find segments near a segment
+    // reset_prune_hash empties the hash so it is rebuilt from the current path, it must be called whenever points are removed
+    // add_segment_to_prune_hash returns false if there are not enough free hash entries
+    void reset_prune_hash();
+    bool add_segment_to_prune_hash(uint16_t segment);
+    bool get_prune_hash_cells(const Vector3f& p1, const Vector3f& p2, float margin, int32_t &x_min, int32_t &y_min, int32_t &x_max, int32_t &y_max) const;
+    uint16_t prune_hash_bucket(int32_t x, int32_t y) const;
+
+    // find the earliest segment that gets closer than SMARTRTL_PRUNING_DELTA to the segment ending at point i
+    // returns false if there is no such segment
+    bool find_loop_start(uint16_t i, uint16_t &loop_start, dist_point &loop_dp);
+
     // get the closest distance between 2 line segments and the point midway between the closest points
     static dist_point segment_segment_dist(const Vector3f& p1, const Vector3f& p2, const Vector3f& p3, const Vector3f& p4);
 
@@ -227,15 +249,28 @@ private:
         Vector3f midpoint;      // midpoint which should replace the first point when the loop is removed
         float length_squared;   // length squared (in meters) of the loop (used so we can remove the longest loops)
     } prune_loop_t;
+    // spatial hash entry.  Segment n joins points n-1 and n
+    typedef struct {
+        uint16_t segment;   // index of the segment
+        uint16_t next;      // index of the next entry in the same bucket or SMARTRTL_PRUNING_HASH_NONE
+    } prune_hash_entry_t;
     struct {
         bool complete;
         uint16_t path_points_count;  // copy of _path_points_count taken when the prune algorithm started
         uint16_t path_points_completed; // number of points in that path that have already been checked for loops and should be ignored
-        uint16_t i;     // loop search's outer loop index
-        uint16_t j;     // loop search's inner loop index
+        uint16_t i;     // loop search's index of the segment being checked
         prune_loop_t* loops;// the result of the pruning algorithm
         uint16_t loops_max; // maximum number of elements in the _prunable_loops array
         uint16_t loops_count;   // number of elements in the _prunable_loops array
+        uint16_t* hash_buckets; // first entry of each spatial hash bucket
+        uint16_t hash_buckets_num;  // number of buckets, always a power of two
+        prune_hash_entry_t* hash_entries;
+        uint16_t hash_entries_max;  // maximum number of elements in the hash_entries array
+        uint16_t hash_entries_count;// number of elements in the hash_entries array
+        uint16_t hash_long_segments;// first entry of the list of segments covering too many cells to be added to buckets
+        uint16_t hash_segments; // segments 1 to hash_segments have been added to the hash, later segments are checked directly
+        bool hash_full;         // true if a segment could not be added because hash_entries is full
+        float hash_cell_size;   // size of the hash cells in meters
     } _prune;
 
     // returns true if the two loops overlap (used within add_loop to determine which loops to keep or throw away)
@@ -0,0 +1,244 @@
+#include <AP_gtest.h>
+
+/*
+  tests for AP_SmartRTL path simplification and loop pruning
+ */
+
+#include <AP_SmartRTL/AP_SmartRTL.h>
+
+#include <AP_HAL/AP_HAL.h>
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+
+/*
+  a path that orbits a slowly moving centre four times and then weaves
+  back across the orbits, so there are many loops to prune. Points are
+  NED in meters from home
+ */
+static const uint16_t loop_path_len = 280;
+static Vector3f loop_path_point(uint16_t i)
+{
+    if (i < 150) {
+        const float a = i * 0.18f;
+        return Vector3f(25 * cosf(a) + i * 0.35f, 25 * sinf(a), -10 + 2 * sinf(i * 0.05f));
+    }
+    const uint16_t k = i - 150;
+    return Vector3f(52.5f - k * 0.8f, 6 * sinf(k * 0.4f) + ((k / 20) % 2) * 3, -12 + 0.5f * cosf(k * 0.3f));
+}
+
+/*
+  expected results for the loop path above, recorded from the
+  implementation that compared every pair of segments when looking for
+  loops and called distance_to_segment() when simplifying
+ */
+static const Vector3f loop_path_simplified[] {
+    { 0.0000f, 0.0000f, 0.0000f },
+    { 25.0000f, 0.0000f, -10.0000f },
+    { 22.4927f, 12.8534f, -9.7011f },
+    { 17.2902f, 19.5832f, -9.5052f },
+    { 10.0954f, 23.8023f, -9.3142f },
+    { 1.9204f, 24.9697f, -9.1301f },
+    { -6.0970f, 22.9359f, -8.9546f },
+    { -15.4238f, 14.5583f, -8.7116f },
+    { -18.9668f, 2.0375f, -8.4974f },
+    { -15.4190f, -11.0630f, -8.3171f },
+    { -5.4910f, -21.0152f, -8.1745f },
+    { 8.2904f, -24.9869f, -8.0729f },
+    { 17.8446f, -23.6703f, -8.0291f },
+    { 29.9197f, -16.1663f, -8.0004f },
+    { 35.0922f, -8.4122f, -8.0063f },
+    { 37.1174f, 4.8887f, -8.0523f },
+    { 32.1653f, 16.7983f, -8.1421f },
+    { 21.9441f, 23.9274f, -8.2736f },
+    { 9.6614f, 24.2472f, -8.4439f },
+    { -0.8886f, 17.6667f, -8.6491f },
+    { -6.4048f, 6.0585f, -8.8846f },
+    { -5.0184f, -7.2738f, -9.1452f },
+    { 3.1747f, -18.5361f, -9.4250f },
+    { 16.1418f, -24.5234f, -9.7178f },
+    { 25.7922f, -24.6628f, -9.9168f },
+    { 38.9399f, -19.0496f, -10.2164f },
+    { 47.4803f, -8.0152f, -10.5111f },
+    { 49.2817f, 5.3002f, -10.7943f },
+    { 44.1302f, 17.1073f, -11.0597f },
+    { 33.7908f, 24.0459f, -11.3013f },
+    { 21.5046f, 24.1414f, -11.5136f },
+    { 11.0668f, 17.3668f, -11.6920f },
+    { 5.7468f, 5.6498f, -11.8323f },
+    { 6.0176f, -3.2913f, -11.9032f },
+    { 12.2861f, -15.5645f, -11.9737f },
+    { 24.1222f, -23.4083f, -11.9998f },
+    { 33.6310f, -25.0000f, -11.9923f },
+    { 47.5300f, -21.4267f, -11.9438f },
+    { 57.7635f, -11.7558f, -11.8516f },
+    { 61.7182f, 1.2606f, -11.7179f },
+    { 58.5673f, 13.9183f, -11.5455f },
+    { 53.0330f, 20.3419f, -11.4111f },
+    { 45.6355f, 24.1575f, -11.2625f },
+    { 33.3496f, 24.0288f, -11.0166f },
+    { 23.0273f, 17.0619f, -10.7478f },
+    { 17.9052f, 5.2396f, -10.4622f },
+    { 18.3265f, -3.7076f, -10.2656f },
+    { 24.8006f, -15.8913f, -9.9664f },
+    { 32.3358f, -21.6713f, -9.7669f },
+    { 46.3014f, -24.9959f, -9.4727f },
+    { 55.7779f, -23.2346f, -9.2827f },
+    { 67.4606f, -15.1841f, -9.0118f },
+    { 72.2364f, -7.2144f, -8.8431f },
+    { 73.9435f, 1.6802f, -8.6860f },
+    { 70.5804f, 14.2655f, -8.4755f },
+    { 64.9390f, 20.5833f, -8.3538f },
+    { 57.4784f, 24.2623f, -8.2487f },
+    { 49.2450f, 24.8306f, -8.1610f },
+    { 52.5000f, 0.0000f, -11.5000f },
+    { 49.3000f, 5.9974f, -11.8188f },
+    { 42.9000f, -5.9770f, -12.4484f },
+    { 36.5000f, 8.9361f, -11.5199f },
+    { 30.9000f, -2.8856f, -12.1218f },
+    { 24.5000f, 8.9436f, -12.2378f },
+    { 22.9000f, 7.7295f, -11.9479f },
+    { 18.1000f, -5.9814f, -11.5276f },
+    { 11.7000f, 5.9988f, -12.4590f },
+    { 5.3000f, -5.9957f, -11.7956f },
+    { -1.1000f, 8.9721f, -11.8425f },
+    { -6.7000f, -2.8206f, -12.4891f },
+    { -13.1000f, 5.8957f, -11.5693f },
+    { -19.5000f, -5.9507f, -12.1461f },
+    { -24.3000f, 3.8694f, -12.4325f },
+    { -27.5000f, 7.4707f, -11.9229f },
+    { -32.3000f, -2.9996f, -11.5364f },
+    { -38.7000f, 8.9934f, -12.4684f },
+    { -45.1000f, -5.9668f, -11.7728f },
+    { -50.7000f, 5.8333f, -11.7302f },
+};
+
+static const Vector3f loop_path_cleaned[] {
+    { 0.0000f, 0.0000f, 0.0000f },
+    { 25.0000f, 0.0000f, -10.0000f },
+    { 22.4927f, 12.8534f, -9.7011f },
+    { 21.6717f, 13.8844f, -10.1710f },
+    { 17.9052f, 5.2396f, -10.4622f },
+    { 18.3265f, -3.7076f, -10.2656f },
+    { 24.8006f, -15.8913f, -9.9664f },
+    { 32.3358f, -21.6713f, -9.7669f },
+    { 46.3014f, -24.9959f, -9.4727f },
+    { 55.7779f, -23.2346f, -9.2827f },
+    { 67.4606f, -15.1841f, -9.0118f },
+    { 72.2364f, -7.2144f, -8.8431f },
+    { 73.9435f, 1.6802f, -8.6860f },
+    { 70.5804f, 14.2655f, -8.4755f },
+    { 64.9390f, 20.5833f, -8.3538f },
+    { 57.4784f, 24.2623f, -8.2487f },
+    { 49.2450f, 24.8306f, -8.1610f },
+    { 52.5000f, 0.0000f, -11.5000f },
+    { 49.3000f, 5.9974f, -11.8188f },
+    { 42.9000f, -5.9770f, -12.4484f },
+    { 36.5000f, 8.9361f, -11.5199f },
+    { 30.9000f, -2.8856f, -12.1218f },
+    { 24.5000f, 8.9436f, -12.2378f },
+    { 22.9000f, 7.7295f, -11.9479f },
+    { 18.1000f, -5.9814f, -11.5276f },
+    { 11.7000f, 5.9988f, -12.4590f },
+    { 5.3000f, -5.9957f, -11.7956f },
+    { -1.1000f, 8.9721f, -11.8425f },
+    { -6.7000f, -2.8206f, -12.4891f },
+    { -13.1000f, 5.8957f, -11.5693f },
+    { -19.5000f, -5.9507f, -12.1461f },
+    { -24.3000f, 3.8694f, -12.4325f },
+    { -27.5000f, 7.4707f, -11.9229f },
+    { -32.3000f, -2.9996f, -11.5364f },
+    { -38.7000f, 8.9934f, -12.4684f },
+    { -45.1000f, -5.9668f, -11.7728f },
+    { -50.7000f, 5.8333f, -11.7302f },
+};
+
+/*
+  the segment ending at point 3 crosses the segment leaving home, the
+  segment ending at point 4 does not. The loop search stops before it
+  gets to point 3 of a path this long, so the loop is left in the path
+ */
+static const Vector3f short_path[] {
+    { 10, 0, 0 },
+    { 10, 10, 0 },
+    { 4, -3, 0 },
+    { -20, -3, 0 },
+};
+
+// the object relies on zeroed memory like the vehicles which own it
+static AP_SmartRTL *new_smartrtl()
+{
+    AP_SmartRTL *srtl = NEW_NOTHROW AP_SmartRTL(true);
+    if (srtl != nullptr) {
+        srtl->init();
+        srtl->set_home(true, Vector3f());
+    }
+    return srtl;
+}
+
+// in example mode the cleanup only runs when we call it
+static void thorough_cleanup(AP_SmartRTL &srtl, AP_SmartRTL::ThoroughCleanupType clean_type)
+{
+    while (!srtl.request_thorough_cleanup(clean_type)) {
+        srtl.run_background_cleanup();
+    }
+}
+
+static void check_path(const AP_SmartRTL &srtl, const Vector3f *expected, uint16_t expected_len)
+{
+    ASSERT_EQ(srtl.get_num_points(), expected_len);
+    for (uint16_t i = 0; i < expected_len; i++) {
+        const Vector3f &p = srtl.get_point(i);
+        EXPECT_NEAR(p.x, expected[i].x, 1e-3) << "point " << i;
+        EXPECT_NEAR(p.y, expected[i].y, 1e-3) << "point " << i;
+        EXPECT_NEAR(p.z, expected[i].z, 1e-3) << "point " << i;
+    }
+}
+
+TEST(AP_SmartRTL, simplify)
+{
+    AP_SmartRTL *srtl = new_smartrtl();
+    ASSERT_NE(srtl, nullptr);
+    for (uint16_t i = 0; i < loop_path_len; i++) {
+        srtl->update(true, loop_path_point(i));
+    }
+    thorough_cleanup(*srtl, AP_SmartRTL::THOROUGH_CLEAN_SIMPLIFY_ONLY);
+    EXPECT_TRUE(srtl->is_active());
+    check_path(*srtl, loop_path_simplified, ARRAY_SIZE(loop_path_simplified));
+    delete srtl;
+}
+
+TEST(AP_SmartRTL, simplify_and_prune)
+{
+    AP_SmartRTL *srtl = new_smartrtl();
+    ASSERT_NE(srtl, nullptr);
+    for (uint16_t i = 0; i < loop_path_len; i++) {
+        srtl->update(true, loop_path_point(i));
+    }
+    thorough_cleanup(*srtl, AP_SmartRTL::THOROUGH_CLEAN_ALL);
+    EXPECT_TRUE(srtl->is_active());
+    check_path(*srtl, loop_path_cleaned, ARRAY_SIZE(loop_path_cleaned));
+    delete srtl;
+}
+
+TEST(AP_SmartRTL, prune_first_segments)
+{
+    AP_SmartRTL *srtl = new_smartrtl();
+    ASSERT_NE(srtl, nullptr);
+    for (const auto &p : short_path) {
+        srtl->update(true, p);
+    }
+    thorough_cleanup(*srtl, AP_SmartRTL::THOROUGH_CLEAN_ALL);
+
+    // home followed by every point of the path
+    ASSERT_EQ(srtl->get_num_points(), ARRAY_SIZE(short_path) + 1);
+    EXPECT_TRUE(srtl->get_point(0).is_zero());
+    for (uint8_t i = 0; i < ARRAY_SIZE(short_path); i++) {
+        EXPECT_TRUE(srtl->get_point(i+1) == short_path[i]) << "point " << unsigned(i+1);
+    }
+    delete srtl;
+}
+
+AP_GTEST_MAIN()
+
+#endif // HAL_SITL or HAL_LINUX
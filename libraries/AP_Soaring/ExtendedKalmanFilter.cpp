@@ -31,7 +31,6 @@ void ExtendedKalmanFilter::reset(const VectorN<float,N> &x, const MatrixN<float,
 
 void ExtendedKalmanFilter::update(float z, float Px, float Py, float driftX, float driftY)
 {
-    MatrixN<float,N> tempM;
     VectorN<float,N> H;
     VectorN<float,N> P12;
     VectorN<float,N> K;
@@ -75,8 +74,7 @@ void ExtendedKalmanFilter::update(float z, float Px, float Py, float driftX, flo
     // LINE 46
     // NB should be altered to reflect Stengel
     // P = P_predict - K * P12';
-    tempM.mult(K, P12);
-    P -= tempM;
+    P.sub_outer(K, P12);
     
     P.force_symmetry();
 }
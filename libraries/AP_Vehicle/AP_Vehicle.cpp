@@ -1078,6 +1078,7 @@ void AP_Vehicle::one_Hz_update(void)
 
 #if HAL_LOGGING_ENABLED
     hal.util->uart_log();
+    hal.util->bus_log();
 #endif
 
 }
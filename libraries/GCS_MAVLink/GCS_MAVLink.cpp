@@ -76,6 +76,14 @@ bool gcs_alternative_active[MAVLINK_COMM_NUM_BUFFERS];
 static HAL_Semaphore chan_locks[MAVLINK_COMM_NUM_BUFFERS];
 static bool chan_discard[MAVLINK_COMM_NUM_BUFFERS];
 
+// transmit buffer space reserved in comm_send_lock() for the message
+// being sent, which the mavlink library writes directly into
+static struct {
+    ByteBuffer::IoVec vec[2];
+    uint8_t nvec;
+    uint16_t ofs;
+} chan_reserved[MAVLINK_COMM_NUM_BUFFERS];
+
 mavlink_system_t mavlink_system = {7,1};
 
 // routing table
@@ -146,7 +154,26 @@ void comm_send_buffer(mavlink_channel_t chan, const uint8_t *buf, uint8_t len)
         // an alternative protocol is active
         return;
     }
-    const size_t written = mavlink_comm_port[chan]->write(buf, len);
+    size_t written;
+    auto &r = chan_reserved[chan];
+    if (r.nvec > 0) {
+        // copy into the space reserved in the transmit buffer
+        uint32_t ofs = r.ofs;
+        written = 0;
+        for (uint8_t i = 0; i < r.nvec && written < len; i++) {
+            if (ofs >= r.vec[i].len) {
+                ofs -= r.vec[i].len;
+                continue;
+            }
+            const uint32_t n = MIN(uint32_t(len - written), r.vec[i].len - ofs);
+            memcpy(&r.vec[i].data[ofs], &buf[written], n);
+            written += n;
+            ofs = 0;
+        }
+        r.ofs += written;
+    } else {
+        written = mavlink_comm_port[chan]->write(buf, len);
+    }
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
     if (written < len && !mavlink_comm_port[chan]->is_write_locked()) {
         AP_HAL::panic("Short write on UART: %lu < %u", (unsigned long)written, len);
@@ -169,7 +196,13 @@ void comm_send_lock(mavlink_channel_t chan_m, uint16_t size)
     if (mavlink_comm_port[chan]->txspace() < size) {
         chan_discard[chan] = true;
         gcs_out_of_space_to_send(chan_m);
+        return;
     }
+    // reserve the whole message in the transmit buffer, falling back
+    // to write() if the UART doesn't support it
+    auto &r = chan_reserved[chan];
+    r.nvec = mavlink_comm_port[chan]->write_reserve(r.vec, size);
+    r.ofs = 0;
 }
 
 /*
@@ -178,6 +211,11 @@ void comm_send_lock(mavlink_channel_t chan_m, uint16_t size)
 void comm_send_unlock(mavlink_channel_t chan_m)
 {
     const uint8_t chan = uint8_t(chan_m);
+    auto &r = chan_reserved[chan];
+    if (r.nvec > 0) {
+        mavlink_comm_port[chan]->write_commit(r.ofs);
+        r.nvec = 0;
+    }
     chan_discard[chan] = false;
     chan_locks[chan].give();
 }
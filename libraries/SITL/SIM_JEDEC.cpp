@@ -61,6 +61,19 @@ void JEDEC::page_erase (uint32_t addr)
     }
 }
 
+/*
+  erases take typical datasheet times so that the logger has to cope
+  with the chip being busy. Chip erase is left instant to keep SITL
+  log erases quick
+ */
+#define JEDEC_SECTOR4_ERASE_US  45000U
+#define JEDEC_BLOCK64_ERASE_US 150000U
+
+bool JEDEC::busy() const
+{
+    return AP_HAL::micros64() < busy_until_us;
+}
+
 void JEDEC::bulk_erase()
 {
     for (uint16_t i=0; i<get_num_blocks(); i++) {
@@ -110,6 +123,9 @@ int JEDEC::rdwr(uint8_t count, SPI::spi_ioc_transfer *&tfrs)
         case State::WAITING: {
             // find a command
             uint8_t command = tx_buf[0];
+            if (busy() && command != JEDEC_RDSR) {
+                AP_HAL::panic("command 0x%02x while busy", command);
+            }
             switch (command) {
             case JEDEC_RDID:
                 state = State::READING_RDID;
@@ -133,6 +149,7 @@ int JEDEC::rdwr(uint8_t count, SPI::spi_ioc_transfer *&tfrs)
                 assert_writes_enabled();
                 sector4k_erase(xfr_addr);
                 write_enabled = false;
+                busy_until_us = AP_HAL::micros64() + JEDEC_SECTOR4_ERASE_US;
                 break;
             }
             case JEDEC_BULK_ERASE:  {
@@ -146,6 +163,7 @@ int JEDEC::rdwr(uint8_t count, SPI::spi_ioc_transfer *&tfrs)
                 assert_writes_enabled();
                 block64k_erase(xfr_addr);
                 write_enabled = false;
+                busy_until_us = AP_HAL::micros64() + JEDEC_BLOCK64_ERASE_US;
                 break;
             }
             default:
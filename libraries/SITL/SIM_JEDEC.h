@@ -30,6 +30,9 @@ protected:
     uint32_t get_storage_size() const { return get_num_pages()*get_page_size(); } // in bytes
     uint32_t get_num_pages() const { return get_num_blocks()*get_page_per_block(); }
 
+    // true while an erase is in progress
+    bool busy() const;
+
 private:
 
     enum class State {
@@ -43,6 +46,9 @@ private:
     bool write_enabled;
     uint32_t xfr_addr;
 
+    // time an erase in progress completes
+    uint64_t busy_until_us;
+
     void sector4k_erase(uint32_t addr);
     void block64k_erase(uint32_t addr);
     void page_erase(uint32_t addr);
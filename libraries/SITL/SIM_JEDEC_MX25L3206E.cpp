@@ -13,9 +13,9 @@ void JEDEC_MX25L3206E::fill_rdid(uint8_t *buffer, uint8_t len)
 
 void JEDEC_MX25L3206E::fill_rdsr(uint8_t *buffer, uint8_t len)
 {
-    // we never allow multiple operations at a time
-    // hence we can never be busy while reading the status register
-    buffer[0] = 0x00;
+    // only erases take time, reads and page programs complete
+    // immediately
+    buffer[0] = busy() ? 0x01 : 0x00;
 }
 
 #endif  // AP_SIM_JEDEC_MX25L3206E_ENABLED